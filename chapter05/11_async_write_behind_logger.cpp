@@ -0,0 +1,373 @@
+/*
+파일명: 11_async_write_behind_logger.cpp
+
+비동기 쓰기 지연 로거 (Async Write-Behind Logger)
+    06_raii_pattern.cpp 의 FileManager 를 로그 백엔드로 키운 것
+    write() 는 메모리 버퍼에 붙이기만 하고, 실제 파일 쓰기는 백그라운드 스레드가 모아서 처리
+
+    - FileManager::write 의 문제: file << content << endl → endl 이 매번 flush → 호출마다 write 시스템 콜
+    - 이중 버퍼: 호출자는 front 에 추가, 플러셔는 swap 으로 받은 back 을 잠금 없이 파일에 씀
+    - 플러시 조건: 크기(front 가 flushBytes 이상) 또는 시간(flushInterval 경과)
+    - 역압(backpressure): front 가 maxBufferedBytes 를 넘으면 호출자가 잠시 대기 → 메모리 상한
+    - fsync 정책: None(OS 에 맡김) / EveryFlush(쓸 때마다) / Periodic(일정 시간마다)
+    - flush(): 정책과 무관하게 그때까지의 내용을 write 하고 fsync 까지 마친 뒤 반환
+    - 쓰기 오류: 다음 write()/flush() 에서 예외, 플러셔는 주기 대기로 돌아감
+    - RAII 유지: 소멸자가 남은 내용을 모두 쓰고 fsync 한 뒤 파일을 닫음 (fsync 정책이 None 이어도)
+
+컴파일: g++ -std=c++17 -O2 -pthread -o async_logger 11_async_write_behind_logger.cpp
+실행: ./async_logger [메시지 수] [출력 디렉터리]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+// 비교 대상: 06_raii_pattern.cpp 의 FileManager (경로만 인자로 받도록 변경)
+class FileManager {
+private :
+    ofstream file;
+    string filename;
+
+public :
+    FileManager(const string& fname) : filename(fname) {
+        file.open(filename);
+        if (!file.is_open()) throw runtime_error("파일 열기 실패: " + filename);
+    }
+
+    ~FileManager() {
+        if (file.is_open()) {
+            file.close();
+        }
+    }
+
+    void write(const string& content) {
+        if (file.is_open()) {
+            file << content << endl;
+        }
+    }
+};
+
+enum class FsyncPolicy { None, EveryFlush, Periodic };
+
+struct LoggerConfig {
+    size_t flushBytes = 64 * 1024;                       // 이만큼 쌓이면 즉시 플러시
+    chrono::milliseconds flushInterval{50};              // 덜 쌓여도 이 시간이 지나면 플러시
+    size_t maxBufferedBytes = 4 * 1024 * 1024;           // 넘으면 호출자가 대기
+    FsyncPolicy fsyncPolicy = FsyncPolicy::Periodic;
+    chrono::milliseconds fsyncInterval{1000};
+};
+
+class AsyncFileLogger {
+private :
+    int fd = -1;
+    string filename;
+    LoggerConfig config;
+
+    mutex mtx;
+    condition_variable flusherCv;      // 플러셔 깨우기
+    condition_variable callerCv;       // 버퍼 공간 / flush() 완료 대기
+    string front;                      // 호출자가 채우는 버퍼
+    string back;                       // 플러셔가 파일에 쓰는 버퍼
+    uint64_t appendedBytes = 0;        // front 에 들어간 누적 바이트
+    uint64_t writtenBytes = 0;         // 파일에 쓴 누적 바이트
+    uint64_t syncedBytes = 0;          // fsync 까지 끝난 누적 바이트
+    uint64_t flushRequestedUpTo = 0;   // flush() 가 기다리는 지점
+    bool stopping = false;
+    string error;
+
+    atomic<size_t> flushCount{0};      // 플러셔만 증가, 호출자가 읽음
+    atomic<size_t> fsyncCount{0};
+    thread flusher;
+
+public :
+    AsyncFileLogger(const string& fname, const LoggerConfig& cfg = LoggerConfig())
+        : filename(fname), config(cfg) {
+        fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw runtime_error("파일 열기 실패: " + filename + " (" + strerror(errno) + ")");
+        front.reserve(config.flushBytes * 2);
+        back.reserve(config.flushBytes * 2);
+        flusher = thread(&AsyncFileLogger::flushLoop, this);
+    }
+
+    // 소멸자: 플러셔에게 종료를 알리고, 플러셔가 남은 버퍼를 모두 쓰고 fsync 한 뒤 닫음
+    ~AsyncFileLogger() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        flusherCv.notify_one();
+        flusher.join();
+        ::close(fd);
+        if (!error.empty()) cerr << "로그 쓰기 오류: " << error << endl;
+    }
+
+    AsyncFileLogger(const AsyncFileLogger&) = delete;
+    AsyncFileLogger& operator=(const AsyncFileLogger&) = delete;
+
+    // FileManager::write 와 같은 의미 (한 줄 추가), 단 파일에는 나중에 기록
+    void write(const string& content) {
+        unique_lock<mutex> lock(mtx);
+        if (!error.empty()) throw runtime_error("로그 쓰기 오류: " + error);
+        if (front.size() >= config.maxBufferedBytes) {
+            flusherCv.notify_one();
+            callerCv.wait(lock, [&] { return front.size() < config.maxBufferedBytes || !error.empty(); });
+            if (!error.empty()) throw runtime_error("로그 쓰기 오류: " + error);   // 대기 중에 플러셔가 실패
+        }
+        front.append(content);
+        front.push_back('\n');
+        appendedBytes += content.size() + 1;
+        if (front.size() >= config.flushBytes) {
+            lock.unlock();
+            flusherCv.notify_one();
+        }
+    }
+
+    // 지금까지 write 한 내용이 파일에 쓰이고 fsync 될 때까지 대기 (정책이 None 이어도 fsync)
+    void flush() {
+        unique_lock<mutex> lock(mtx);
+        if (!error.empty()) throw runtime_error("로그 쓰기 오류: " + error);
+        uint64_t target = appendedBytes;
+        flushRequestedUpTo = max(flushRequestedUpTo, target);
+        flusherCv.notify_one();
+        callerCv.wait(lock, [&] { return syncedBytes >= target || !error.empty(); });
+        if (!error.empty()) throw runtime_error("로그 쓰기 오류: " + error);
+    }
+
+    size_t getFlushCount() const { return flushCount; }
+    size_t getFsyncCount() const { return fsyncCount; }
+
+private :
+    void flushLoop() {
+        auto lastFsync = chrono::steady_clock::now();
+        bool dirty = false;             // fsync 되지 않은 쓰기가 있는가
+        unique_lock<mutex> lock(mtx);
+        while (true) {
+            // 오류 뒤에는 조건이 계속 참이 되지 않도록 크기/flush() 조건을 끔 (바쁜 대기 방지)
+            flusherCv.wait_for(lock, config.flushInterval, [&] {
+                return stopping || (error.empty() && (front.size() >= config.flushBytes || flushRequestedUpTo > syncedBytes));
+            });
+            bool exiting = stopping;
+
+            if (!front.empty()) {
+                front.swap(back);       // 호출자는 곧바로 빈 front 에 계속 쓸 수 있음
+                callerCv.notify_all();
+                lock.unlock();
+
+                bool ok = writeAll(back);
+                back.clear();           // 용량은 유지 → 다음 swap 때 재할당 없음
+                ++flushCount;
+                dirty = true;
+
+                lock.lock();
+                if (ok) writtenBytes = appendedBytes - front.size();
+            }
+
+            auto now = chrono::steady_clock::now();
+            bool explicitFlush = error.empty() && flushRequestedUpTo > syncedBytes && writtenBytes >= flushRequestedUpTo;
+            bool wantFsync = dirty && (explicitFlush || exiting || config.fsyncPolicy == FsyncPolicy::EveryFlush ||
+                                       (config.fsyncPolicy == FsyncPolicy::Periodic && now - lastFsync >= config.fsyncInterval));
+            // None 정책이어도 flush() 와 종료 때는 fsync (소멸 뒤 내용이 디스크에 있음을 보장)
+            if (wantFsync && (explicitFlush || exiting || config.fsyncPolicy != FsyncPolicy::None)) {
+                uint64_t covered = writtenBytes;
+                lock.unlock();
+                bool ok = ::fsync(fd) == 0;
+                if (!ok) setError(string("fsync: ") + strerror(errno));
+                ++fsyncCount;
+                lastFsync = now;
+                dirty = false;
+                lock.lock();
+                if (ok) syncedBytes = covered;
+            }
+            callerCv.notify_all();
+
+            if (exiting && front.empty()) return;
+        }
+    }
+
+    bool writeAll(const string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                setError(string("write: ") + strerror(errno));
+                return false;
+            }
+            done += size_t(n);
+        }
+        return true;
+    }
+
+    void setError(const string& what) {
+        lock_guard<mutex> lock(mtx);
+        if (error.empty()) error = what;
+        callerCv.notify_all();
+    }
+};
+
+// 벤치마크
+struct BenchResult {
+    double seconds;
+    double p50, p99, maxNs;
+};
+
+template <typename Logger>
+BenchResult runBench(Logger& logger, const vector<string>& messages, vector<uint32_t>& latency) {
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto s = chrono::steady_clock::now();
+        logger.write(messages[i]);
+        latency[i] = uint32_t(min<int64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - s).count(), UINT32_MAX));
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    sort(latency.begin(), latency.end());
+    return {seconds, double(latency[latency.size() / 2]), double(latency[latency.size() * 99 / 100]), double(latency.back())};
+}
+
+void report(const string& label, const BenchResult& r, double totalSeconds, size_t count) {
+    printf("%8.0f | %7.0f | %7.0f | %8.0f | %12.1f | %s\n", count / r.seconds / 1000.0,
+           r.p50, r.p99, r.maxNs / 1000.0, totalSeconds * 1000.0, label.c_str());
+}
+
+// 파일을 다시 읽어 모든 줄이 순서대로 들어갔는지 확인
+bool verifyFile(const string& path, const vector<string>& messages) {
+    ifstream in(path);
+    string line;
+    size_t i = 0;
+    while (getline(in, line)) {
+        if (i >= messages.size() || line != messages[i]) return false;
+        ++i;
+    }
+    return i == messages.size();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t count = argc > 1 ? stoul(argv[1]) : 300000;
+        string dir = argc > 2 ? argv[2] : ".";
+        if (count == 0) throw invalid_argument("메시지 수는 1 이상");
+
+        vector<string> messages;
+        messages.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            messages.push_back("[턴 " + to_string(i) + "] 용사" + to_string(i % 97) + "이(가) 슬라임에게 "
+                               + to_string(15 + i % 11) + " 피해를 입혔습니다.");
+        }
+        vector<uint32_t> latency(count);
+
+        cout << "=== 로그 " << count << "줄 쓰기 ===" << endl;
+        cout << "  K줄/초 |  p50 ns |  p99 ns |  최대 us | 소멸 포함 ms | 방식" << endl;
+
+        bool allOk = true;
+        {
+            string path = dir + "/log_filemanager.txt";
+            auto t0 = chrono::steady_clock::now();
+            BenchResult r;
+            {
+                FileManager fm(path);
+                r = runBench(fm, messages, latency);
+            }
+            report("FileManager (endl 매번)", r, chrono::duration<double>(chrono::steady_clock::now() - t0).count(), count);
+            allOk &= verifyFile(path, messages);
+            remove(path.c_str());
+        }
+
+        struct Variant { const char* label; FsyncPolicy policy; };
+        const Variant variants[] = {
+            {"Async, fsync 없음", FsyncPolicy::None},
+            {"Async, fsync 1초마다", FsyncPolicy::Periodic},
+            {"Async, fsync 플러시마다", FsyncPolicy::EveryFlush},
+        };
+        for (const auto& v : variants) {
+            string path = dir + "/log_async.txt";
+            LoggerConfig cfg;
+            cfg.fsyncPolicy = v.policy;
+            auto t0 = chrono::steady_clock::now();
+            BenchResult r;
+            size_t flushes = 0, fsyncs = 0;
+            {
+                AsyncFileLogger logger(path, cfg);
+                r = runBench(logger, messages, latency);
+                flushes = logger.getFlushCount();
+                fsyncs = logger.getFsyncCount();
+            }   // 소멸자가 남은 버퍼를 모두 씀
+            report(v.label, r, chrono::duration<double>(chrono::steady_clock::now() - t0).count(), count);
+            cout << "    (write 반환 시점까지 플러시 " << flushes << "회, fsync " << fsyncs << "회)" << endl;
+            allOk &= verifyFile(path, messages);
+            remove(path.c_str());
+        }
+
+        // 시간 조건: 몇 줄만 쓰고 기다리면 flushInterval 뒤에 파일에 나타남
+        {
+            string path = dir + "/log_interval.txt";
+            LoggerConfig cfg;
+            cfg.flushInterval = chrono::milliseconds(20);
+            AsyncFileLogger logger(path, cfg);
+            logger.write("던전에 입장했습니다.");
+            logger.write("슬라임을 처치했습니다!");
+            ifstream before(path, ios::ate);
+            auto sizeBefore = before.tellg();
+            this_thread::sleep_for(chrono::milliseconds(100));
+            ifstream after(path, ios::ate);
+            cout << "\n시간 조건 플러시: 직후 " << sizeBefore << "바이트 → 100ms 뒤 " << after.tellg() << "바이트" << endl;
+            logger.write("보물상자를 열었습니다.");
+            logger.flush();             // 명시적 플러시: 반환 시점에는 파일에 들어가 있음
+            ifstream flushed(path, ios::ate);
+            cout << "flush() 직후: " << flushed.tellg() << "바이트" << endl;
+            remove(path.c_str());
+        }
+
+        // 쓰기 오류: /dev/full 은 write 가 항상 ENOSPC → flush() 가 예외, 이후 플러셔는 쉬어야 함
+        if (::access("/dev/full", W_OK) == 0) {
+            AsyncFileLogger logger("/dev/full");
+            logger.write("기록될 수 없는 줄");
+            bool threw = false;
+            try {
+                logger.flush();
+            } catch (const runtime_error& e) {
+                threw = true;
+                cout << "/dev/full flush() → " << e.what() << endl;
+            }
+            clock_t c0 = clock();
+            this_thread::sleep_for(chrono::milliseconds(300));
+            double cpuMs = double(clock() - c0) * 1000.0 / CLOCKS_PER_SEC;
+            cout << "오류 뒤 300ms 동안 CPU 사용: " << cpuMs << " ms" << endl;
+            allOk &= threw && cpuMs < 50.0;
+
+            // 역압으로 대기하던 호출자도 플러셔의 오류를 받아야 함 (버퍼에 계속 붙이지 않음)
+            LoggerConfig tiny;
+            tiny.flushBytes = 64;
+            tiny.maxBufferedBytes = 128;
+            AsyncFileLogger blocked("/dev/full", tiny);
+            size_t accepted = 0;
+            try {
+                for (; accepted < 100000; ++accepted) blocked.write(messages[accepted % count]);
+            } catch (const runtime_error&) {}
+            cout << "역압 중 오류: " << accepted << "줄 받은 뒤 write() 예외" << endl;
+            allOk &= accepted < 100000;
+        }
+
+        cout << "파일 내용 검증(모든 줄, 순서 그대로): " << (allOk ? "통과" : "실패") << endl;
+        return allOk ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,471 @@
+/*
+ * 파일명: 01_spsc_event_pipeline.cpp
+ *
+ * 주제: 락 프리 SPSC 이벤트 파이프라인 (Lock-free SPSC Event Pipeline)
+ * 정의: 시뮬레이션 스레드는 고정 크기 이벤트만 링 버퍼에 넣고,
+ *       렌더 스레드가 이벤트를 모아서 포맷팅과 출력을 한 번에 처리
+ *
+ * 핵심 개념:
+ * - SPSC(Single Producer Single Consumer): 생산자 1개, 소비자 1개 → 원자 변수 2개만으로 동기화
+ * - 링 버퍼: 크기가 고정된 배열을 순환 사용 → 메모리 사용량이 항상 일정
+ * - acquire/release: 데이터를 쓴 뒤 인덱스를 공개(release), 인덱스를 읽은 뒤 데이터를 읽음(acquire)
+ * - 배치 출력: 여러 이벤트를 하나의 버퍼에 포맷팅한 뒤 write 한 번으로 출력
+ * - 백프레셔(backpressure): 버퍼가 가득 찼을 때의 정책 (대기 / 버림 / 병합)
+ *   병합: (대상, 종류)별 작은 표에 피해/회복을 제자리에서 누적, 합칠 수 없는 이벤트는 버림
+ *   → 대기(Block)와 달리 출력이 멈춰도 시뮬레이션은 멈추지 않음
+ *
+ * chapter08/game.cpp 와의 차이:
+ * - takeDamage/heal/levelUp 안에서 cout 을 호출하지 않고 GameEvent 를 발행
+ * - 터미널이 느려도 시뮬레이션 속도는 링 버퍼가 찰 때까지 영향을 받지 않음
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o spsc_pipeline 01_spsc_event_pipeline.cpp
+ * 실행: ./spsc_pipeline [block|drop|coalesce] [전투 횟수] > /dev/null
+ */
+
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <unistd.h>       // write()
+using namespace std;
+
+// [1] 고정 크기 이벤트 레코드
+// 문자열 대신 고정 길이 배열을 사용 → 발행 시 힙 할당이 없음
+enum class EventType : uint8_t {
+    Damage,
+    Heal,
+    Down,
+    LevelUp
+};
+
+struct GameEvent {
+    EventType type;
+    int32_t amount;
+    int32_t health;
+    int32_t maxHealth;
+    char name[32];      // UTF-8 이름 (한글 1글자 = 3바이트)
+};
+
+// 이름을 고정 버퍼에 복사 (UTF-8 글자 중간에서 자르지 않도록 처리)
+void copyName(char (&dst)[32], const string& src) {
+    size_t len = min(src.size(), sizeof(dst) - 1);
+    while (len > 0 && len < src.size() &&
+           (static_cast<unsigned char>(src[len]) & 0xC0) == 0x80) {
+        --len;   // 다음 바이트가 연속 바이트면 글자 경계까지 후퇴
+    }
+    memcpy(dst, src.data(), len);
+    dst[len] = '\0';
+}
+
+// [2] 락 프리 SPSC 링 버퍼
+// Capacity 는 2의 거듭제곱 → 나머지 연산 대신 비트 마스크 사용
+template<typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity는 2의 거듭제곱이어야 합니다");
+
+private:
+    // 생산자와 소비자가 쓰는 인덱스를 서로 다른 캐시 라인에 배치 (false sharing 방지)
+    alignas(64) atomic<size_t> head{0};   // 다음에 쓸 위치 (생산자 소유)
+    size_t cachedTail = 0;                // 생산자가 마지막으로 본 tail
+    alignas(64) atomic<size_t> tail{0};   // 다음에 읽을 위치 (소비자 소유)
+    size_t cachedHead = 0;                // 소비자가 마지막으로 본 head
+    alignas(64) T slots[Capacity];
+
+public:
+    // 생산자 전용: 공간이 없으면 false
+    bool tryPush(const T& item) {
+        size_t h = head.load(memory_order_relaxed);
+        if (h - cachedTail == Capacity) {
+            cachedTail = tail.load(memory_order_acquire);
+            if (h - cachedTail == Capacity) return false;
+        }
+        slots[h & (Capacity - 1)] = item;
+        head.store(h + 1, memory_order_release);
+        return true;
+    }
+
+    // 소비자 전용: 최대 maxCount 개를 한 번에 꺼냄
+    size_t popBatch(T* out, size_t maxCount) {
+        size_t t = tail.load(memory_order_relaxed);
+        if (cachedHead == t) {
+            cachedHead = head.load(memory_order_acquire);
+            if (cachedHead == t) return 0;
+        }
+        size_t count = min(maxCount, cachedHead - t);
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = slots[(t + i) & (Capacity - 1)];
+        }
+        tail.store(t + count, memory_order_release);
+        return count;
+    }
+
+    bool empty() const {
+        return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+    }
+};
+
+// [3] 백프레셔 정책
+enum class Backpressure {
+    Block,      // 공간이 생길 때까지 대기 (이벤트 손실 없음)
+    Drop,       // 새 이벤트를 버리고 개수만 기록
+    Coalesce    // 링이 차 있는 동안 같은 대상의 피해/회복을 하나로 합침 (합칠 수 없으면 버림)
+};
+
+Backpressure parsePolicy(const string& s) {
+    if (s == "block") return Backpressure::Block;
+    if (s == "drop") return Backpressure::Drop;
+    if (s == "coalesce") return Backpressure::Coalesce;
+    throw invalid_argument("알 수 없는 정책: " + s);
+}
+
+// [4] 이벤트 파이프라인: 링 버퍼 + 렌더 스레드
+// RAII: 생성자에서 렌더 스레드 시작, 소멸자에서 남은 이벤트를 모두 출력한 뒤 종료
+class EventPipeline {
+private:
+    static constexpr size_t kCapacity = 4096;
+    static constexpr size_t kBatch = 256;
+    static constexpr size_t kCoalesceSlots = 16;
+
+    SpscRing<GameEvent, kCapacity> ring;
+    Backpressure policy;
+    atomic<bool> stopping{false};
+    atomic<uint64_t> dropped{0};
+    uint64_t coalesced = 0;
+
+    // 병합 정책용: 링에 넣지 못한 피해/회복 이벤트를 (대상, 종류)별로 하나씩 보관
+    // 생산자 스레드만 접근, 들어온 순서대로 링에 다시 넣음
+    GameEvent pending[kCoalesceSlots];
+    size_t pendingCount = 0;
+
+    int fd;
+    thread renderer;
+
+public:
+    EventPipeline(Backpressure p, int outFd = STDOUT_FILENO)
+        : policy(p), fd(outFd), renderer(&EventPipeline::renderLoop, this) {}
+
+    ~EventPipeline() {
+        flushPending(true);
+        stopping.store(true, memory_order_release);
+        renderer.join();
+    }
+
+    EventPipeline(const EventPipeline&) = delete;
+    EventPipeline& operator=(const EventPipeline&) = delete;
+
+    // 시뮬레이션 스레드에서 호출
+    void publish(const GameEvent& ev) {
+        switch (policy) {
+            case Backpressure::Block:
+                while (!ring.tryPush(ev)) {
+                    this_thread::yield();
+                }
+                break;
+            case Backpressure::Drop:
+                if (!ring.tryPush(ev)) {
+                    dropped.fetch_add(1, memory_order_relaxed);
+                }
+                break;
+            case Backpressure::Coalesce:
+                publishCoalesced(ev);
+                break;
+        }
+    }
+
+    uint64_t droppedCount() const { return dropped.load(memory_order_relaxed); }
+    uint64_t coalescedCount() const { return coalesced; }
+
+private:
+    static bool mergeable(const GameEvent& a, const GameEvent& b) {
+        return a.type == b.type &&
+               (a.type == EventType::Damage || a.type == EventType::Heal) &&
+               strcmp(a.name, b.name) == 0;
+    }
+
+    // 절대 대기하지 않음: 링에 자리가 없으면 표에 병합, 표에도 못 넣으면 버리고 개수만 기록
+    void publishCoalesced(const GameEvent& ev) {
+        flushPending(false);
+        if (pendingCount == 0 && ring.tryPush(ev)) return;
+
+        if (ev.type == EventType::Damage || ev.type == EventType::Heal) {
+            for (size_t i = 0; i < pendingCount; ++i) {
+                if (mergeable(pending[i], ev)) {
+                    pending[i].amount += ev.amount;     // 누적 수치
+                    pending[i].health = ev.health;      // 최신 체력
+                    pending[i].maxHealth = ev.maxHealth;
+                    ++coalesced;
+                    return;
+                }
+            }
+            if (pendingCount < kCoalesceSlots) {
+                pending[pendingCount++] = ev;
+                return;
+            }
+        }
+        dropped.fetch_add(1, memory_order_relaxed);     // 쓰러짐/레벨업, 또는 표가 가득 참
+    }
+
+    // 표의 이벤트를 오래된 것부터 링에 넣음 (mustSucceed 는 소멸자에서만 사용)
+    void flushPending(bool mustSucceed) {
+        size_t sent = 0;
+        while (sent < pendingCount) {
+            if (ring.tryPush(pending[sent])) {
+                ++sent;
+            } else if (mustSucceed) {
+                this_thread::yield();
+            } else {
+                break;
+            }
+        }
+        if (sent == 0) return;
+        move(pending + sent, pending + pendingCount, pending);
+        pendingCount -= sent;
+    }
+
+    static void format(string& out, const GameEvent& ev) {
+        char line[160];
+        int n = 0;
+        switch (ev.type) {
+            case EventType::Damage:
+                n = snprintf(line, sizeof(line), "%s이(가) %d 피해를 받았습니다. (체력: %d/%d)\n",
+                             ev.name, ev.amount, ev.health, ev.maxHealth);
+                break;
+            case EventType::Heal:
+                n = snprintf(line, sizeof(line), "%s이(가) %d 체력을 회복했습니다. (체력: %d/%d)\n",
+                             ev.name, ev.amount, ev.health, ev.maxHealth);
+                break;
+            case EventType::Down:
+                n = snprintf(line, sizeof(line), "%s이(가) 쓰러졌습니다!\n", ev.name);
+                break;
+            case EventType::LevelUp:
+                n = snprintf(line, sizeof(line), "*** 레벨 업! *** %s 레벨 %d\n",
+                             ev.name, ev.amount);
+                break;
+        }
+        out.append(line, static_cast<size_t>(max(0, n)));
+    }
+
+    void writeAll(const string& text) {
+        const char* p = text.data();
+        size_t left = text.size();
+        while (left > 0) {
+            ssize_t n = ::write(fd, p, left);
+            if (n <= 0) return;
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+    }
+
+    // 렌더 스레드: 이벤트를 배치 단위로 꺼내 포맷팅 후 write 한 번으로 출력
+    void renderLoop() {
+        GameEvent batch[kBatch];
+        string text;
+        text.reserve(kBatch * 96);
+
+        while (true) {
+            size_t n = ring.popBatch(batch, kBatch);
+            if (n == 0) {
+                if (stopping.load(memory_order_acquire) && ring.empty()) break;
+                this_thread::sleep_for(chrono::microseconds(200));
+                continue;
+            }
+            text.clear();
+            for (size_t i = 0; i < n; ++i) {
+                format(text, batch[i]);
+            }
+            writeAll(text);
+        }
+    }
+};
+
+// [5] 이벤트를 발행하는 게임 캐릭터 (chapter08/game.cpp 의 Character 를 단순화)
+class Character {
+protected:
+    string name;
+    int health;
+    int maxHealth;
+    int attack;
+    int defense;
+    EventPipeline& events;
+
+    GameEvent makeEvent(EventType type, int amount) const {
+        GameEvent ev;
+        ev.type = type;
+        ev.amount = amount;
+        ev.health = health;
+        ev.maxHealth = maxHealth;
+        copyName(ev.name, name);
+        return ev;
+    }
+
+public:
+    Character(const string& n, int hp, int att, int def, EventPipeline& ev)
+        : name(n), health(hp), maxHealth(hp), attack(att), defense(def), events(ev) {}
+
+    virtual ~Character() = default;
+
+    void takeDamage(int damage) {
+        int actualDamage = max(1, damage - defense);
+        health -= actualDamage;
+        if (health <= 0) health = 0;
+        events.publish(makeEvent(EventType::Damage, actualDamage));
+        if (health == 0) {
+            events.publish(makeEvent(EventType::Down, 0));
+        }
+    }
+
+    void heal(int amount) {
+        health = min(maxHealth, health + amount);
+        events.publish(makeEvent(EventType::Heal, amount));
+    }
+
+    bool isAlive() const { return health > 0; }
+    int getAttack() const { return attack; }
+};
+
+class Player : public Character {
+private:
+    int level = 1;
+    int experience = 0;
+
+public:
+    Player(const string& n, EventPipeline& ev) : Character(n, 100, 20, 5, ev) {}
+
+    void gainExperience(int exp) {
+        experience += exp;
+        if (experience >= level * 100) {
+            levelUp();
+        }
+    }
+
+    void restoreFull() { health = maxHealth; }
+
+private:
+    void levelUp() {
+        level++;
+        maxHealth += 20;
+        health = maxHealth;
+        attack += 5;
+        defense += 2;
+        events.publish(makeEvent(EventType::LevelUp, level));
+    }
+};
+
+class Monster : public Character {
+public:
+    Monster(const string& n, int hp, int att, int def, EventPipeline& ev)
+        : Character(n, hp, att, def, ev) {}
+};
+
+// 전투 반복: 플레이어가 쓰러지면 회복 후 계속 (이벤트를 최대한 많이 발행)
+uint64_t runBattles(EventPipeline& pipeline, int battles, mt19937& gen) {
+    uint64_t turns = 0;
+    Player player("용사", pipeline);
+    for (int b = 0; b < battles; ++b) {
+        Monster monster("오크", 300, 18, 5, pipeline);
+        while (player.isAlive() && monster.isAlive()) {
+            uniform_int_distribution<> pd(player.getAttack() - 5, player.getAttack() + 5);
+            monster.takeDamage(max(1, pd(gen)));
+            ++turns;
+            if (!monster.isAlive()) break;
+
+            uniform_int_distribution<> md(monster.getAttack() - 3, monster.getAttack() + 3);
+            player.takeDamage(max(1, md(gen)));
+            if (turns % 7 == 0) player.heal(10);
+        }
+        if (!player.isAlive()) player.restoreFull();
+        player.gainExperience(10);
+    }
+    return turns;
+}
+
+// 멈춘 독자: 렌더 스레드가 아무도 읽지 않는 파이프에 쓰게 해서 stallMs 동안 write 가 막히게 함
+struct StallResult {
+    double simMs;
+    uint64_t dropped, coalesced;
+};
+
+StallResult runWithStalledReader(Backpressure policy, int battles, int stallMs) {
+    int fds[2];
+    if (::pipe(fds) != 0) throw runtime_error("pipe 생성 실패");
+    thread drainer([&] {
+        this_thread::sleep_for(chrono::milliseconds(stallMs));
+        char buf[65536];
+        while (::read(fds[0], buf, sizeof(buf)) > 0) {}
+    });
+
+    StallResult r{};
+    {
+        EventPipeline pipeline(policy, fds[1]);
+        mt19937 gen(42);
+        auto t0 = chrono::steady_clock::now();
+        runBattles(pipeline, battles, gen);
+        r.simMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        r.dropped = pipeline.droppedCount();
+        r.coalesced = pipeline.coalescedCount();
+    }   // 독자가 다시 읽기 시작하면 남은 이벤트를 모두 출력하고 종료
+    ::close(fds[1]);
+    drainer.join();
+    ::close(fds[0]);
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Backpressure policy = parsePolicy(argc > 1 ? argv[1] : "block");
+        int battles = argc > 2 ? stoi(argv[2]) : 2000;
+
+        mt19937 gen(42);
+        uint64_t turns = 0;
+        uint64_t dropped = 0, coalesced = 0;
+        chrono::steady_clock::time_point start, simEnd;
+
+        {
+            EventPipeline pipeline(policy);
+            start = chrono::steady_clock::now();
+            turns = runBattles(pipeline, battles, gen);
+            simEnd = chrono::steady_clock::now();
+
+            dropped = pipeline.droppedCount();
+            coalesced = pipeline.coalescedCount();
+        }   // 여기서 렌더 스레드가 남은 이벤트를 모두 출력하고 종료
+        auto end = chrono::steady_clock::now();
+
+        double simMs = chrono::duration<double, milli>(simEnd - start).count();
+        double totalMs = chrono::duration<double, milli>(end - start).count();
+
+        // 요약은 stderr 로 출력 → stdout 을 /dev/null 로 보내도 결과 확인 가능
+        cerr << "=== SPSC 이벤트 파이프라인 ===" << endl;
+        cerr << "전투: " << battles << " | 턴: " << turns << endl;
+        cerr << "시뮬레이션 시간: " << simMs << " ms"
+             << " (" << (turns / max(simMs, 1e-3)) * 1000.0 << " 턴/초)" << endl;
+        cerr << "출력 완료까지: " << totalMs << " ms" << endl;
+        cerr << "버린 이벤트: " << dropped << " | 병합된 이벤트: " << coalesced << endl;
+
+        // 독자가 멈춘 동안의 시뮬레이션 시간: Drop/Coalesce 는 멈춤 시간과 무관해야 함
+        const int stallMs = 300;
+        cerr << "\n=== 독자가 " << stallMs << " ms 동안 멈춘 경우 ===" << endl;
+        bool coalesceNonBlocking = false;
+        const pair<const char*, Backpressure> policies[] = {
+            {"block", Backpressure::Block}, {"drop", Backpressure::Drop}, {"coalesce", Backpressure::Coalesce}};
+        for (const auto& [label, p] : policies) {
+            StallResult r = runWithStalledReader(p, battles, stallMs);
+            cerr << label << ": 시뮬레이션 " << r.simMs << " ms | 버림 " << r.dropped << " | 병합 " << r.coalesced << endl;
+            if (p == Backpressure::Coalesce) coalesceNonBlocking = r.simMs < stallMs / 2.0;
+        }
+        cerr << "coalesce 가 독자를 기다리지 않음: " << (coalesceNonBlocking ? "예" : "아니오!") << endl;
+        if (!coalesceNonBlocking) return 1;
+    }
+    catch (const exception& e) {
+        cerr << "오류: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,367 @@
+/*
+ * 파일명: 02_zero_alloc_turn_loop.cpp
+ *
+ * 주제: 힙 할당 없는 전투 턴 루프 (Zero-allocation Turn Loop)
+ * 정의: 미리 할당한 버퍼와 재사용 저장소만으로 전투 턴을 진행하여
+ *       안정 상태(steady state)에서 operator new 호출이 0회가 되도록 만드는 기법
+ *
+ * chapter08/game.cpp 의 한 턴에서 발생하는 할당:
+ * - InvalidActionException("잘못된 행동: " + action) → 문자열 연결
+ * - MonsterFactory 의 make_unique<Monster>          → 몬스터마다 new
+ * - inventory.erase(...) 와 unique_ptr<Item>         → 아이템 생성/삭제
+ * - iostream 포맷팅                                   → 내부 버퍼
+ *
+ * 핵심 개념:
+ * - 전역 operator new 교체: 할당 횟수를 세어 테스트에서 검증
+ * - 오류 코드 반환: 예외 객체(__cxa_allocate_exception)와 메시지 문자열을 만들지 않음
+ * - 객체 풀(Object Pool): 고정 크기 배열의 몬스터 슬롯을 재사용
+ * - 고정 용량 인벤토리: 아이템 ID 배열 + 개수, 삭제는 요소 이동만 수행
+ * - 고정 출력 버퍼: snprintf 로 char 배열에 기록 후 가득 차면 fwrite
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o zero_alloc 02_zero_alloc_turn_loop.cpp
+ * 실행: ./zero_alloc [턴 수] > /dev/null
+ *       할당이 발생하면 종료 코드 1 → 빌드 스크립트에서 "g++ ... && ./zero_alloc" 로 검증
+ */
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdarg>
+#include <new>
+using namespace std;
+
+// [1] 할당 카운터: 전역 operator new/delete 교체
+// 교체한 new 가 malloc 을 쓰므로 GCC 의 new/free 불일치 경고는 오탐 → 끔
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static atomic<size_t> g_allocCount{0};
+
+void* operator new(size_t size) {
+    g_allocCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size == 0 ? 1 : size)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// 구간 안의 할당 횟수를 측정하는 RAII 도우미
+class AllocationScope {
+private:
+    size_t start;
+
+public:
+    AllocationScope() : start(g_allocCount.load(memory_order_relaxed)) {}
+    size_t count() const { return g_allocCount.load(memory_order_relaxed) - start; }
+};
+
+// [2] 할당하지 않는 오류 경로
+// 예외 대신 결과 코드를 반환하고, 메시지는 정적 문자열 테이블에서 가져옴
+enum class ActionResult {
+    Ok,
+    InvalidChoice,
+    InvalidItem,
+    NoItems,
+    Fled
+};
+
+const char* describe(ActionResult r) {
+    switch (r) {
+        case ActionResult::Ok:            return "성공";
+        case ActionResult::InvalidChoice: return "잘못된 행동: 잘못된 선택";
+        case ActionResult::InvalidItem:   return "잘못된 행동: 잘못된 아이템 번호";
+        case ActionResult::NoItems:       return "사용할 아이템이 없습니다!";
+        case ActionResult::Fled:          return "전투에서 도망쳤습니다!";
+    }
+    return "알 수 없는 결과";
+}
+
+// [3] 고정 크기 출력 버퍼
+// cout 대신 미리 잡아 둔 char 배열에 기록하고, 가득 차면 한 번에 fwrite
+class TurnLog {
+private:
+    char buffer[16 * 1024];
+    size_t used = 0;
+
+public:
+    ~TurnLog() { flush(); }
+
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (sizeof(buffer) - used < 256) flush();
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buffer + used, sizeof(buffer) - used, fmt, args);
+        va_end(args);
+        if (n > 0) used += min(static_cast<size_t>(n), sizeof(buffer) - used - 1);
+    }
+
+    void flush() {
+        if (used == 0) return;
+        fwrite(buffer, 1, used, stdout);
+        fflush(stdout);
+        used = 0;
+    }
+};
+
+// [4] 정적 아이템/몬스터 정의 테이블 (이름은 문자열 리터럴 → 복사 없음)
+struct ItemDef {
+    const char* name;
+    int healAmount;
+    int attackBonus;
+};
+
+const ItemDef kItems[] = {
+    {"체력 포션", 30, 0},
+    {"힘의 물약", 0, 10},
+};
+
+struct MonsterDef {
+    const char* name;
+    int baseHp, hpPerLevel;
+    int baseAtt, attPerLevel;
+    int baseDef, defPerLevel;
+    int baseExp, expPerLevel;
+    int baseGold, goldPerLevel;
+};
+
+const MonsterDef kMonsters[] = {
+    {"슬라임",  30, 10,  8, 2, 1, 1,  20,  5, 10,  3},
+    {"고블린",  50, 15, 12, 3, 3, 1,  35,  8, 20,  5},
+    {"오크",    80, 20, 18, 4, 5, 2,  50, 10, 35,  7},
+    {"드래곤", 150, 30, 25, 5, 8, 3, 100, 15, 75, 10},
+};
+
+// [5] 고정 용량 인벤토리: unique_ptr<Item> 벡터 대신 아이템 ID 배열
+class Inventory {
+public:
+    static constexpr int kCapacity = 16;
+
+private:
+    uint8_t items[kCapacity];
+    int count = 0;
+
+public:
+    bool add(uint8_t itemId) {
+        if (count == kCapacity) return false;
+        items[count++] = itemId;
+        return true;
+    }
+
+    // 1부터 시작하는 번호 (game.cpp 의 useItem 과 동일)
+    bool take(int index, uint8_t& out) {
+        if (index < 1 || index > count) return false;
+        out = items[index - 1];
+        for (int i = index; i < count; ++i) items[i - 1] = items[i];   // 순서 유지
+        --count;
+        return true;
+    }
+
+    int size() const { return count; }
+};
+
+// [6] 캐릭터 (이름은 const char* → 문자열 복사 없음)
+struct Combatant {
+    const char* name = "";
+    int health = 0;
+    int maxHealth = 0;
+    int attack = 0;
+    int defense = 0;
+
+    void takeDamage(int damage, TurnLog& log) {
+        int actualDamage = max(1, damage - defense);
+        health = max(0, health - actualDamage);
+        log.printf("%s이(가) %d 피해를 받았습니다. (체력: %d/%d)\n",
+                   name, actualDamage, health, maxHealth);
+        if (health == 0) log.printf("%s이(가) 쓰러졌습니다!\n", name);
+    }
+
+    void heal(int amount, TurnLog& log) {
+        health = min(maxHealth, health + amount);
+        log.printf("%s이(가) %d 체력을 회복했습니다. (체력: %d/%d)\n",
+                   name, amount, health, maxHealth);
+    }
+
+    bool isAlive() const { return health > 0; }
+};
+
+struct MonsterState : Combatant {
+    int expReward = 0;
+    int goldReward = 0;
+};
+
+struct PlayerState : Combatant {
+    int level = 1;
+    int experience = 0;
+    int gold = 50;
+    Inventory inventory;
+};
+
+// [7] 몬스터 풀: 고정 배열의 슬롯을 재사용 (make_unique 대체)
+class MonsterPool {
+public:
+    static constexpr int kSlots = 8;
+
+private:
+    MonsterState slots[kSlots];
+    bool used[kSlots] = {};
+
+public:
+    MonsterState* acquire(const MonsterDef& def, int playerLevel) {
+        for (int i = 0; i < kSlots; ++i) {
+            if (used[i]) continue;
+            used[i] = true;
+            int lv = max(1, playerLevel);
+            MonsterState& m = slots[i];
+            m.name = def.name;
+            m.maxHealth = m.health = def.baseHp + lv * def.hpPerLevel;
+            m.attack = def.baseAtt + lv * def.attPerLevel;
+            m.defense = def.baseDef + lv * def.defPerLevel;
+            m.expReward = def.baseExp + lv * def.expPerLevel;
+            m.goldReward = def.baseGold + lv * def.goldPerLevel;
+            return &m;
+        }
+        return nullptr;   // 풀 고갈 → 할당 대신 실패를 반환
+    }
+
+    void release(MonsterState* m) {
+        used[m - slots] = false;
+    }
+};
+
+// [8] 할당 없는 전투 시스템
+class BattleSystem {
+private:
+    mt19937 gen;      // 생성기는 한 번만 만들고 재사용 (random_device 호출 없음)
+    TurnLog& log;
+
+public:
+    BattleSystem(uint32_t seed, TurnLog& l) : gen(seed), log(l) {}
+
+    MonsterState* spawn(MonsterPool& pool, int level) {
+        uniform_int_distribution<> dis(0, 3);
+        return pool.acquire(kMonsters[dis(gen)], level);
+    }
+
+    // 한 턴 진행: choice 1=공격, 2=아이템, 3=도망
+    ActionResult playTurn(PlayerState& player, MonsterState& monster, int choice, int itemIndex) {
+        switch (choice) {
+            case 1: {
+                uniform_int_distribution<> dis(player.attack - 5, player.attack + 5);
+                log.printf("%s의 공격!\n", player.name);
+                monster.takeDamage(max(1, dis(gen)), log);
+                break;
+            }
+            case 2: {
+                if (player.inventory.size() == 0) return ActionResult::NoItems;
+                uint8_t id;
+                if (!player.inventory.take(itemIndex, id)) return ActionResult::InvalidItem;
+                const ItemDef& item = kItems[id];
+                log.printf("%s을(를) 사용했습니다!\n", item.name);
+                if (item.healAmount > 0) player.heal(item.healAmount, log);
+                if (item.attackBonus > 0) player.attack += item.attackBonus;
+                break;
+            }
+            case 3:
+                return ActionResult::Fled;
+            default:
+                return ActionResult::InvalidChoice;
+        }
+
+        if (monster.isAlive()) {
+            uniform_int_distribution<> dis(monster.attack - 3, monster.attack + 3);
+            log.printf("%s의 공격!\n", monster.name);
+            player.takeDamage(max(1, dis(gen)), log);
+        }
+        return ActionResult::Ok;
+    }
+};
+
+// [9] 비교용: game.cpp 방식의 한 턴 (string 연결, make_unique, vector erase)
+size_t legacyTurnAllocations() {
+    AllocationScope scope;
+    {
+        vector<unique_ptr<string>> inventory;
+        inventory.push_back(make_unique<string>("체력 포션"));
+        auto monster = make_unique<MonsterState>();
+        string message = string("잘못된 행동: ") + "잘못된 선택";
+        inventory.erase(inventory.begin());
+        (void)monster;
+        (void)message;
+    }
+    return scope.count();
+}
+
+int main(int argc, char* argv[]) {
+    long turns = argc > 1 ? atol(argv[1]) : 200000;
+
+    TurnLog log;
+    MonsterPool pool;
+    BattleSystem battle(42, log);
+
+    PlayerState player;
+    player.name = "용사";
+    player.maxHealth = player.health = 100;
+    player.attack = 20;
+    player.defense = 5;
+    player.inventory.add(0);   // 체력 포션
+    player.inventory.add(1);   // 힘의 물약
+
+    // 워밍업: stdout 버퍼 등 최초 1회 초기화가 여기서 끝나도록 함
+    log.printf("=== 워밍업 ===\n");
+    log.flush();
+
+    AllocationScope steady;
+    long played = 0;
+    int rejected = 0;
+
+    while (played < turns) {
+        MonsterState* monster = battle.spawn(pool, player.level);
+        if (!monster) break;
+
+        while (player.isAlive() && monster->isAlive() && played < turns) {
+            // 스크립트 입력: 가끔 아이템 사용, 가끔 잘못된 입력
+            int choice = (played % 17 == 0) ? 2 : (played % 29 == 0) ? 9 : 1;
+            ActionResult r = battle.playTurn(player, *monster, choice, 1);
+            if (r != ActionResult::Ok) {
+                log.printf("%s\n", describe(r));
+                ++rejected;
+            }
+            ++played;
+        }
+
+        if (player.isAlive()) {
+            player.experience += monster->expReward;
+            player.gold += monster->goldReward;
+            if (player.experience >= player.level * 100) {
+                player.level++;
+                player.maxHealth += 20;
+                player.attack += 5;
+                player.defense += 2;
+            }
+        }
+        // 다음 전투 준비 (게임 오버 대신 회복 후 계속)
+        player.health = player.maxHealth;
+        if (player.inventory.size() < 2) player.inventory.add(0);
+        pool.release(monster);
+    }
+    log.flush();
+    size_t steadyAllocs = steady.count();
+
+    fprintf(stderr, "=== 힙 할당 없는 턴 루프 ===\n");
+    fprintf(stderr, "진행한 턴: %ld (거부된 입력: %d)\n", played, rejected);
+    fprintf(stderr, "game.cpp 방식 1턴의 할당: %zu 회\n", legacyTurnAllocations());
+    fprintf(stderr, "안정 상태 턴 루프의 할당: %zu 회\n", steadyAllocs);
+
+    if (steadyAllocs != 0) {
+        fprintf(stderr, "실패: 턴 루프에서 힙 할당이 발생했습니다.\n");
+        return 1;
+    }
+    fprintf(stderr, "통과: 턴 루프에서 힙 할당이 발생하지 않았습니다.\n");
+    return 0;
+}
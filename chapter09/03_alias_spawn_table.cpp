@@ -0,0 +1,345 @@
+/*
+ * 파일명: 03_alias_spawn_table.cpp
+ *
+ * 주제: 워커 별칭 방법으로 만든 레벨별 몬스터 출현 테이블 (Walker's Alias Method)
+ * 정의: 가중치가 있는 이산 분포를 O(n) 으로 전처리해 두고 O(1) 로 표본을 뽑는 기법
+ *
+ * chapter08/game.cpp 의 문제점:
+ * - MonsterFactory::createRandomMonster 는 uniform_int_distribution<>(1, 4) 로 균등하게 선택
+ *   → 던전 1층에서도 드래곤이 슬라임만큼 자주 등장
+ *
+ * 핵심 개념:
+ * - 별칭 테이블: 칸 i 마다 (자기 확률 prob[i], 별칭 alias[i]) 한 쌍을 저장
+ * - 표본 추출: 칸 하나를 균등하게 고르고, 난수가 prob[i] 미만이면 i, 아니면 alias[i]
+ * - Vose 의 구성법: 평균보다 작은 칸(small)과 큰 칸(large)을 짝지어 O(n) 에 구성
+ * - 데이터 기반 설계: 몬스터 종류와 레벨별 가중치를 코드가 아닌 데이터 파일로 정의
+ * - 재구성 비용 절감: 작업용 버퍼를 멤버로 보관하여 재구성 시 재할당을 피함
+ *
+ * 데이터 파일 형식 (한 줄에 몬스터 하나, #은 주석):
+ *   이름 체력 레벨당체력 공격 레벨당공격 방어 레벨당방어 경험치 레벨당경험치 골드 레벨당골드 최소레벨 최적레벨 가중치
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o alias_spawn 03_alias_spawn_table.cpp
+ * 실행: ./alias_spawn [monsters.txt]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+using namespace std;
+
+// [1] 몬스터 원형 (archetype): game.cpp 의 switch 문 안 상수들을 데이터로 옮김
+struct MonsterArchetype {
+    string name;
+    int hp, hpPerLevel;
+    int attack, attackPerLevel;
+    int defense, defensePerLevel;
+    int exp, expPerLevel;
+    int gold, goldPerLevel;
+    int minLevel;       // 이 레벨부터 등장
+    int peakLevel;      // 가장 자주 등장하는 레벨
+    double weight;      // 기본 가중치
+};
+
+// 레벨별 가중치 곡선: 최소 레벨 미만이면 0, 최적 레벨에서 최대, 멀어질수록 감소
+double weightAt(const MonsterArchetype& a, int level) {
+    if (level < a.minLevel) return 0.0;
+    double distance = (level - a.peakLevel) / 10.0;
+    return a.weight * exp(-distance * distance);
+}
+
+class Monster {
+private:
+    string name;
+    int health, attack, defense, expReward, goldReward;
+
+public:
+    Monster(const string& n, int hp, int att, int def, int exp, int gold)
+        : name(n), health(hp), attack(att), defense(def), expReward(exp), goldReward(gold) {}
+
+    const string& getName() const { return name; }
+    int getHealth() const { return health; }
+    int getAttack() const { return attack; }
+};
+
+// [2] 워커 별칭 테이블
+class AliasTable {
+private:
+    vector<uint32_t> threshold;   // prob[i] * 2^32 (정수 비교로 부동소수점 연산 제거)
+    vector<uint32_t> alias;
+
+    // 재구성용 작업 버퍼 (용량이 유지되므로 같은 크기로 재구성하면 할당 없음)
+    vector<double> scaled;
+    vector<uint32_t> small, large;
+
+public:
+    // 가중치로부터 테이블 구성: O(n)
+    void build(const vector<double>& weights) {
+        const size_t n = weights.size();
+        if (n == 0) throw invalid_argument("가중치가 비어 있습니다");
+
+        double total = 0.0;
+        for (double w : weights) {
+            if (w < 0.0) throw invalid_argument("가중치는 음수일 수 없습니다");
+            total += w;
+        }
+        if (total <= 0.0) throw invalid_argument("가중치 합이 0입니다");
+
+        threshold.assign(n, 0);
+        alias.assign(n, 0);
+        scaled.resize(n);
+        small.clear();
+        large.clear();
+
+        // 평균이 1이 되도록 스케일 조정
+        for (size_t i = 0; i < n; ++i) {
+            scaled[i] = weights[i] * n / total;
+            (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+        }
+
+        // 작은 칸의 빈 공간을 큰 칸의 확률로 채움
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(); small.pop_back();
+            uint32_t l = large.back();
+
+            threshold[s] = toThreshold(scaled[s]);
+            alias[s] = l;
+
+            scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+            if (scaled[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // 남은 칸은 (부동소수점 오차를 제외하면) 확률 1
+        for (uint32_t i : large) { threshold[i] = UINT32_MAX; alias[i] = i; }
+        for (uint32_t i : small) { threshold[i] = UINT32_MAX; alias[i] = i; }
+    }
+
+    // 64비트 난수 하나로 표본 추출: 상위 32비트 → 칸, 하위 32비트 → 확률 비교
+    size_t sample(uint64_t r) const {
+        uint32_t column = static_cast<uint32_t>(((r >> 32) * threshold.size()) >> 32);
+        uint32_t coin = static_cast<uint32_t>(r);
+        return coin < threshold[column] ? column : alias[column];
+    }
+
+    size_t size() const { return threshold.size(); }
+
+private:
+    static uint32_t toThreshold(double p) {
+        if (p >= 1.0) return UINT32_MAX;
+        return static_cast<uint32_t>(p * 4294967296.0);
+    }
+};
+
+// [3] 레벨별 출현 테이블 묶음: 로드 시점에 모든 레벨을 미리 계산
+class SpawnTables {
+private:
+    vector<MonsterArchetype> archetypes;
+    vector<AliasTable> tables;     // tables[level - 1]
+    vector<double> weightScratch;
+
+public:
+    SpawnTables(vector<MonsterArchetype> defs, int maxLevel)
+        : archetypes(move(defs)), tables(maxLevel) {
+        for (int level = 1; level <= maxLevel; ++level) {
+            rebuildLevel(level);
+        }
+    }
+
+    // 특정 레벨의 가중치가 바뀌었을 때 그 레벨만 재구성
+    void rebuildLevel(int level) {
+        weightScratch.resize(archetypes.size());
+        bool any = false;
+        for (size_t i = 0; i < archetypes.size(); ++i) {
+            weightScratch[i] = weightAt(archetypes[i], level);
+            any = any || weightScratch[i] > 0.0;
+        }
+        if (!any) {
+            throw runtime_error("레벨 " + to_string(level) + "에 등장 가능한 몬스터가 없습니다");
+        }
+        tables[level - 1].build(weightScratch);
+    }
+
+    // 몬스터 가중치를 바꾸고 모든 레벨을 재구성
+    void setWeight(size_t index, double weight) {
+        archetypes.at(index).weight = weight;
+        for (int level = 1; level <= maxLevel(); ++level) {
+            rebuildLevel(level);
+        }
+    }
+
+    const MonsterArchetype& sample(int level, uint64_t r) const {
+        int clamped = min(max(level, 1), maxLevel());
+        return archetypes[tables[clamped - 1].sample(r)];
+    }
+
+    int maxLevel() const { return static_cast<int>(tables.size()); }
+    const vector<MonsterArchetype>& all() const { return archetypes; }
+};
+
+// [4] 데이터 파일 로드
+vector<MonsterArchetype> loadArchetypes(istream& in) {
+    vector<MonsterArchetype> result;
+    string line;
+    int lineNo = 0;
+    while (getline(in, line)) {
+        ++lineNo;
+        if (line.empty() || line[0] == '#') continue;
+        istringstream ss(line);
+        MonsterArchetype a;
+        if (!(ss >> a.name >> a.hp >> a.hpPerLevel >> a.attack >> a.attackPerLevel
+                 >> a.defense >> a.defensePerLevel >> a.exp >> a.expPerLevel
+                 >> a.gold >> a.goldPerLevel >> a.minLevel >> a.peakLevel >> a.weight)) {
+            throw runtime_error("데이터 파일 " + to_string(lineNo) + "번째 줄 형식 오류");
+        }
+        result.push_back(a);
+    }
+    return result;
+}
+
+// 데이터 파일이 없을 때: game.cpp 의 4종 + 변종을 생성하여 수백 종을 만듦
+vector<MonsterArchetype> defaultArchetypes(int variantsPerFamily) {
+    const MonsterArchetype families[] = {
+        {"슬라임",  30, 10,  8, 2, 1, 1,  20,  5, 10,  3,  1,  3, 10.0},
+        {"고블린",  50, 15, 12, 3, 3, 1,  35,  8, 20,  5,  3, 12,  8.0},
+        {"오크",    80, 20, 18, 4, 5, 2,  50, 10, 35,  7, 10, 25,  6.0},
+        {"드래곤", 150, 30, 25, 5, 8, 3, 100, 15, 75, 10, 30, 60,  2.0},
+    };
+
+    vector<MonsterArchetype> result;
+    for (const auto& f : families) {
+        result.push_back(f);
+        for (int v = 1; v < variantsPerFamily; ++v) {
+            MonsterArchetype a = f;
+            a.name = f.name + "#" + to_string(v);
+            a.hp += v;
+            a.attack += v / 8;
+            a.minLevel = f.minLevel + v / 4;
+            a.peakLevel = f.peakLevel + v / 2;
+            a.weight = f.weight / (1.0 + v * 0.05);
+            result.push_back(a);
+        }
+    }
+    return result;
+}
+
+// [5] 몬스터 팩토리: 레벨별 별칭 테이블에서 O(1) 로 몬스터 종류 선택
+class MonsterFactory {
+private:
+    const SpawnTables& tables;
+    mt19937_64 gen;
+
+public:
+    MonsterFactory(const SpawnTables& t, uint64_t seed) : tables(t), gen(seed) {}
+
+    const MonsterArchetype& pickArchetype(int dungeonLevel) {
+        return tables.sample(dungeonLevel, gen());
+    }
+
+    unique_ptr<Monster> createRandomMonster(int dungeonLevel) {
+        const MonsterArchetype& a = pickArchetype(dungeonLevel);
+        int lv = max(1, dungeonLevel);
+        return make_unique<Monster>(a.name,
+            a.hp + lv * a.hpPerLevel,
+            a.attack + lv * a.attackPerLevel,
+            a.defense + lv * a.defensePerLevel,
+            a.exp + lv * a.expPerLevel,
+            a.gold + lv * a.goldPerLevel);
+    }
+};
+
+// 특정 계열(이름 접두사)의 출현 비율 측정
+double familyShare(MonsterFactory& factory, int level, const string& family, int samples) {
+    int hits = 0;
+    for (int i = 0; i < samples; ++i) {
+        if (factory.pickArchetype(level).name.compare(0, family.size(), family) == 0) ++hits;
+    }
+    return 100.0 * hits / samples;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        vector<MonsterArchetype> defs;
+        if (argc > 1) {
+            ifstream file(argv[1]);
+            if (!file) throw runtime_error(string("파일을 열 수 없습니다: ") + argv[1]);
+            defs = loadArchetypes(file);
+        } else {
+            defs = defaultArchetypes(75);   // 4계열 × 75 = 300종
+        }
+
+        const int maxLevel = 100;
+        auto t0 = chrono::steady_clock::now();
+        SpawnTables tables(defs, maxLevel);
+        auto t1 = chrono::steady_clock::now();
+
+        cout << "=== 워커 별칭 출현 테이블 ===" << endl;
+        cout << "몬스터 종류: " << tables.all().size() << " | 레벨: " << maxLevel << endl;
+        cout << "전체 테이블 구성: "
+             << chrono::duration<double, milli>(t1 - t0).count() << " ms" << endl;
+
+        MonsterFactory factory(tables, 42);
+
+        cout << "\n=== 레벨별 계열 출현 비율 (%) ===" << endl;
+        for (int level : {1, 10, 25, 50}) {
+            cout << "레벨 " << level << ": ";
+            for (const char* family : {"슬라임", "고블린", "오크", "드래곤"}) {
+                cout << family << " " << familyShare(factory, level, family, 100000) << "  ";
+            }
+            cout << endl;
+        }
+
+        // 정확도 확인: 레벨 20 에서 기대 확률과 실제 빈도의 최대 차이
+        const int checkLevel = 20;
+        const int samples = 2000000;
+        vector<int> counts(tables.all().size(), 0);
+        double total = 0.0;
+        for (const auto& a : tables.all()) total += weightAt(a, checkLevel);
+        for (int i = 0; i < samples; ++i) {
+            counts[&factory.pickArchetype(checkLevel) - tables.all().data()]++;
+        }
+        double maxError = 0.0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            double expected = weightAt(tables.all()[i], checkLevel) / total;
+            maxError = max(maxError, fabs(expected - double(counts[i]) / samples));
+        }
+        cout << "\n레벨 " << checkLevel << " 최대 확률 오차: " << maxError << endl;
+
+        // 표본 추출 속도
+        const int iterations = 20000000;
+        size_t checksum = 0;
+        auto s0 = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            checksum += factory.pickArchetype(1 + i % maxLevel).hp;
+        }
+        auto s1 = chrono::steady_clock::now();
+        cout << "표본 추출: "
+             << chrono::duration<double, nano>(s1 - s0).count() / iterations
+             << " ns/회 (checksum " << checksum << ")" << endl;
+
+        // 가중치 변경 후 재구성 비용
+        auto r0 = chrono::steady_clock::now();
+        tables.setWeight(tables.all().size() - 1, 50.0);
+        auto r1 = chrono::steady_clock::now();
+        cout << "가중치 변경 후 전체 재구성: "
+             << chrono::duration<double, milli>(r1 - r0).count() << " ms" << endl;
+
+        auto monster = factory.createRandomMonster(50);
+        cout << "\n레벨 50 몬스터 생성: " << monster->getName()
+             << " (체력 " << monster->getHealth() << ", 공격력 " << monster->getAttack() << ")" << endl;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,397 @@
+/*
+ * 파일명: 04_hot_reload_definitions.cpp
+ *
+ * 주제: 몬스터/아이템 정의의 실행 중 교체 (Hot Reload with RCU)
+ * 정의: 데이터 파일이 바뀌면 새 정의를 만들어 포인터 하나만 원자적으로 교체하고,
+ *       옛 정의는 그것을 읽던 스레드가 모두 끝난 뒤에 해제하는 기법
+ *
+ * chapter08/game.cpp 의 문제점:
+ * - 몬스터 능력치는 MonsterFactory, 초기 아이템은 Player 생성자에 하드코딩 → 수정마다 재컴파일
+ *
+ * 핵심 개념:
+ * - RCU(Read-Copy-Update): 읽기는 락 없이 포인터만 읽고, 쓰기는 복사본을 만든 뒤 포인터 교체
+ * - 에포크(epoch) 기반 회수: 읽는 쪽은 자기 슬롯에 시작 에포크를 기록, 쓰는 쪽은
+ *   모든 슬롯이 교체 이후 에포크이거나 비어 있을 때만 옛 정의를 delete
+ * - inotify: 리눅스 커널이 파일 변경을 알려 주는 기능 (폴링 불필요)
+ * - 진행 중인 전투는 시작할 때 고정한 정의를 끝까지 사용, 새 출현은 새 정의를 사용
+ *
+ * 데이터 파일 형식 (# 은 주석, 이름의 '_' 는 공백으로 바뀜):
+ *   monster 이름 체력 공격 방어 경험치 골드 가중치
+ *   item    이름 회복량 공격보너스
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o hot_reload 04_hot_reload_definitions.cpp
+ * 실행: ./hot_reload                  (임시 파일을 만들고 도중에 자동으로 수정)
+ *       ./hot_reload defs.txt 30      (defs.txt 를 30초 동안 감시, 직접 편집해 보기)
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+using namespace std;
+
+// [1] 정의 데이터 (한 번 만들어지면 수정하지 않음 → 여러 스레드가 락 없이 읽어도 안전)
+struct MonsterDef {
+    string name;
+    int hp, attack, defense, exp, gold;
+    double weight;
+};
+
+struct ItemDef {
+    string name;
+    int healAmount;
+    int attackBonus;
+};
+
+struct Definitions {
+    uint64_t version = 0;
+    vector<MonsterDef> monsters;
+    vector<ItemDef> items;
+    vector<double> cumulativeWeight;   // 누적 가중치 (출현 몬스터 선택용)
+
+    const MonsterDef& pickMonster(double r) const {
+        double target = r * cumulativeWeight.back();
+        size_t i = upper_bound(cumulativeWeight.begin(), cumulativeWeight.end(), target)
+                   - cumulativeWeight.begin();
+        return monsters[min(i, monsters.size() - 1)];
+    }
+};
+
+string underscoreToSpace(string s) {
+    replace(s.begin(), s.end(), '_', ' ');
+    return s;
+}
+
+// 파일 파싱: 실패하면 예외 → 호출한 쪽에서 옛 정의를 그대로 유지
+unique_ptr<Definitions> loadDefinitions(const string& path, uint64_t version) {
+    ifstream in(path);
+    if (!in) throw runtime_error("파일을 열 수 없습니다: " + path);
+
+    auto defs = make_unique<Definitions>();
+    defs->version = version;
+    string line;
+    int lineNo = 0;
+    while (getline(in, line)) {
+        ++lineNo;
+        istringstream ss(line);
+        string kind;
+        if (!(ss >> kind) || kind[0] == '#') continue;
+
+        if (kind == "monster") {
+            MonsterDef m;
+            if (!(ss >> m.name >> m.hp >> m.attack >> m.defense >> m.exp >> m.gold >> m.weight)
+                || m.weight < 0) {
+                throw runtime_error(to_string(lineNo) + "번째 줄: monster 형식 오류");
+            }
+            m.name = underscoreToSpace(m.name);
+            defs->monsters.push_back(m);
+        } else if (kind == "item") {
+            ItemDef it;
+            if (!(ss >> it.name >> it.healAmount >> it.attackBonus)) {
+                throw runtime_error(to_string(lineNo) + "번째 줄: item 형식 오류");
+            }
+            it.name = underscoreToSpace(it.name);
+            defs->items.push_back(it);
+        } else {
+            throw runtime_error(to_string(lineNo) + "번째 줄: 알 수 없는 항목 " + kind);
+        }
+    }
+
+    double sum = 0.0;
+    for (const auto& m : defs->monsters) {
+        sum += m.weight;
+        defs->cumulativeWeight.push_back(sum);
+    }
+    if (defs->monsters.empty() || sum <= 0.0) {
+        throw runtime_error("출현 가능한 몬스터가 없습니다");
+    }
+    return defs;
+}
+
+// [2] RCU 정의 저장소
+class DefinitionStore {
+public:
+    static constexpr int kMaxReaders = 64;
+
+private:
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{0};     // 0 = 읽는 중이 아님
+    };
+
+    atomic<const Definitions*> current{nullptr};
+    atomic<uint64_t> globalEpoch{1};
+    ReaderSlot slots[kMaxReaders];
+
+    // 교체된 옛 정의 (쓰는 스레드만 접근)
+    vector<pair<uint64_t, unique_ptr<const Definitions>>> retired;
+    uint64_t reclaimed = 0;
+
+public:
+    explicit DefinitionStore(unique_ptr<Definitions> initial)
+        : current(initial.release()) {}
+
+    ~DefinitionStore() {
+        delete current.load();
+    }
+
+    DefinitionStore(const DefinitionStore&) = delete;
+    DefinitionStore& operator=(const DefinitionStore&) = delete;
+
+    // 읽기 구간 (RAII): 살아 있는 동안 get() 이 돌려준 정의는 해제되지 않음
+    class ReadGuard {
+    private:
+        ReaderSlot& slot;
+        const Definitions* defs;
+
+    public:
+        ReadGuard(DefinitionStore& store, int readerId)
+            : slot(store.slots[readerId]) {
+            slot.epoch.store(store.globalEpoch.load());
+            defs = store.current.load();
+        }
+        ~ReadGuard() { slot.epoch.store(0, memory_order_release); }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const Definitions& get() const { return *defs; }
+        const Definitions* operator->() const { return defs; }
+    };
+
+    // 쓰는 스레드: 새 정의를 공개하고 옛 정의는 회수 대기 목록으로
+    void publish(unique_ptr<Definitions> next) {
+        const Definitions* old = current.exchange(next.release());
+        uint64_t retireEpoch = globalEpoch.fetch_add(1) + 1;
+        retired.emplace_back(retireEpoch, unique_ptr<const Definitions>(old));
+        reclaim();
+    }
+
+    // 모든 읽기 구간이 retireEpoch 이후에 시작했으면 옛 정의를 해제
+    void reclaim() {
+        uint64_t oldestActive = UINT64_MAX;
+        for (auto& s : slots) {
+            uint64_t e = s.epoch.load();
+            if (e != 0) oldestActive = min(oldestActive, e);
+        }
+        auto it = remove_if(retired.begin(), retired.end(),
+            [&](const auto& r) { return r.first <= oldestActive; });
+        reclaimed += static_cast<uint64_t>(retired.end() - it);
+        retired.erase(it, retired.end());
+    }
+
+    uint64_t version() const { return current.load()->version; }
+    size_t pendingCount() const { return retired.size(); }
+    uint64_t reclaimedCount() const { return reclaimed; }
+};
+
+// [3] inotify 감시 스레드
+// 편집기는 보통 새 파일을 쓰고 rename 하므로 파일이 아닌 디렉터리를 감시
+class DefinitionWatcher {
+private:
+    DefinitionStore& store;
+    string path;
+    string dir;
+    string base;
+    int fd = -1;
+    atomic<bool> running{true};
+    uint64_t nextVersion = 2;
+    thread worker;
+
+public:
+    DefinitionWatcher(DefinitionStore& s, const string& p) : store(s), path(p) {
+        size_t slash = path.find_last_of('/');
+        dir = slash == string::npos ? "." : path.substr(0, slash);
+        base = slash == string::npos ? path : path.substr(slash + 1);
+
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0 || inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            if (fd >= 0) close(fd);
+            throw runtime_error("inotify 감시를 시작할 수 없습니다: " + dir);
+        }
+        worker = thread(&DefinitionWatcher::loop, this);
+    }
+
+    ~DefinitionWatcher() {
+        running = false;
+        worker.join();
+        close(fd);
+    }
+
+private:
+    void loop() {
+        alignas(inotify_event) char buffer[4096];
+        while (running) {
+            pollfd pfd{fd, POLLIN, 0};
+            if (poll(&pfd, 1, 100) <= 0) {
+                store.reclaim();     // 변경이 없어도 주기적으로 옛 정의 회수
+                continue;
+            }
+            ssize_t len = read(fd, buffer, sizeof(buffer));
+            bool changed = false;
+            for (ssize_t off = 0; off < len; ) {
+                auto* ev = reinterpret_cast<inotify_event*>(buffer + off);
+                if (ev->len > 0 && base == ev->name) changed = true;
+                off += static_cast<ssize_t>(sizeof(inotify_event) + ev->len);
+            }
+            if (changed) reload();
+        }
+    }
+
+    void reload() {
+        try {
+            store.publish(loadDefinitions(path, nextVersion));
+            cout << "[감시] 정의 v" << nextVersion << " 적용" << endl;
+            ++nextVersion;
+        }
+        catch (const exception& e) {
+            cout << "[감시] 다시 읽기 실패, 기존 정의 유지: " << e.what() << endl;
+        }
+    }
+};
+
+// [4] 게임 쪽 코드: 출현과 전투
+class Monster {
+private:
+    string name;
+    int health, attack, defense;
+
+public:
+    // 정의에서 값을 복사 → 정의가 교체되어도 이미 만든 몬스터는 영향 없음
+    explicit Monster(const MonsterDef& d)
+        : name(d.name), health(d.hp), attack(d.attack), defense(d.defense) {}
+
+    const string& getName() const { return name; }
+    bool isAlive() const { return health > 0; }
+    int getAttack() const { return attack; }
+    void takeDamage(int damage) { health -= max(1, damage - defense); }
+};
+
+// 읽기 스레드 하나가 전투를 반복하며 어떤 버전의 정의를 썼는지 기록
+struct ReaderStats {
+    uint64_t battles = 0;
+    uint64_t lastVersion = 0;
+    uint64_t versionSwitches = 0;
+    bool inconsistent = false;
+};
+
+void battleLoop(DefinitionStore& store, int readerId, atomic<bool>& running, ReaderStats& stats) {
+    mt19937 gen(readerId);
+    uniform_real_distribution<> roll(0.0, 1.0);
+
+    while (running.load(memory_order_relaxed)) {
+        // 전투 하나 = 읽기 구간 하나: 전투 도중에는 정의가 바뀌지 않음
+        DefinitionStore::ReadGuard defs(store, readerId);
+        uint64_t version = defs->version;
+
+        Monster monster(defs->pickMonster(roll(gen)));
+        int playerAttack = 20;
+        int turns = 0;
+        while (monster.isAlive() && turns < 50) {
+            monster.takeDamage(playerAttack);
+            if (turns % 5 == 4 && !defs->items.empty()) {
+                playerAttack += defs->items.back().attackBonus;   // 전투 중 아이템 사용
+            }
+            ++turns;
+        }
+        if (defs->version != version) stats.inconsistent = true;
+
+        if (version != stats.lastVersion) {
+            if (stats.lastVersion != 0) ++stats.versionSwitches;
+            stats.lastVersion = version;
+        }
+        ++stats.battles;
+    }
+}
+
+void writeFile(const string& path, const string& content) {
+    // 임시 파일에 쓴 뒤 rename → 읽는 쪽이 반쯤 쓴 파일을 보지 않음
+    string tmp = path + ".tmp";
+    {
+        ofstream out(tmp);
+        out << content;
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        throw runtime_error("파일 교체 실패: " + path);
+    }
+}
+
+const char* kInitialDefs =
+    "# 초기 정의 (chapter08/game.cpp 의 레벨 1 기준 값)\n"
+    "monster 슬라임 40 10 2 25 13 10\n"
+    "monster 고블린 65 15 4 43 25 6\n"
+    "monster 오크 100 22 7 60 42 3\n"
+    "monster 드래곤 180 30 11 115 85 1\n"
+    "item 체력_포션 30 0\n"
+    "item 힘의_물약 0 10\n";
+
+const char* kTunedDefs =
+    "# 밸런스 조정: 드래곤 출현 증가, 힘의 물약 약화\n"
+    "monster 슬라임 40 10 2 25 13 2\n"
+    "monster 고블린 65 15 4 43 25 4\n"
+    "monster 오크 100 22 7 60 42 4\n"
+    "monster 드래곤 160 28 10 115 85 10\n"
+    "item 체력_포션 40 0\n"
+    "item 힘의_물약 0 5\n";
+
+int main(int argc, char* argv[]) {
+    try {
+        bool demo = argc < 2;
+        string path = demo ? "/tmp/rpg_definitions.txt" : argv[1];
+        int seconds = argc > 2 ? stoi(argv[2]) : 2;
+        if (demo) writeFile(path, kInitialDefs);
+
+        DefinitionStore store(loadDefinitions(path, 1));
+        auto watcher = make_unique<DefinitionWatcher>(store, path);
+        cout << "=== 정의 핫 리로드 ===" << endl;
+        cout << "감시 파일: " << path << " (v" << store.version() << ")" << endl;
+
+        const int readers = 4;
+        atomic<bool> running{true};
+        vector<ReaderStats> stats(readers);
+        vector<thread> threads;
+        for (int i = 0; i < readers; ++i) {
+            threads.emplace_back(battleLoop, ref(store), i, ref(running), ref(stats[i]));
+        }
+
+        if (demo) {
+            this_thread::sleep_for(chrono::milliseconds(500));
+            writeFile(path, "monster 고장난_줄\n");     // 잘못된 파일 → 기존 정의 유지
+            this_thread::sleep_for(chrono::milliseconds(300));
+            writeFile(path, kTunedDefs);
+        }
+        this_thread::sleep_for(chrono::seconds(seconds));
+
+        running = false;
+        for (auto& t : threads) t.join();
+        watcher.reset();     // 쓰는 스레드 종료 후에만 메인 스레드가 회수를 수행
+        store.reclaim();
+
+        cout << "\n=== 결과 ===" << endl;
+        cout << "현재 정의 버전: v" << store.version() << endl;
+        for (int i = 0; i < readers; ++i) {
+            cout << "전투 스레드 " << i << ": 전투 " << stats[i].battles
+                 << "회, 마지막 버전 v" << stats[i].lastVersion
+                 << ", 전투 중 정의 변경 " << (stats[i].inconsistent ? "발생" : "없음") << endl;
+        }
+        cout << "회수된 옛 정의: " << store.reclaimedCount()
+             << " | 회수 대기: " << store.pendingCount() << endl;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,650 @@
+/*
+ * 파일명: 05_item_effect_vm.cpp
+ *
+ * 주제: 아이템 효과용 바이트코드 가상 머신 (Register-based Bytecode VM)
+ * 정의: 아이템 효과를 작은 스크립트로 작성하고, 한 번 컴파일한 바이트코드를
+ *       레지스터 기반 인터프리터로 실행하는 구조
+ *
+ * chapter08/game.cpp 의 한계:
+ * - Item 은 healAmount, attackBonus 두 값만 가짐
+ * - Player::useItem 이 "회복"과 "공격력 증가" 두 가지 효과를 직접 코딩
+ *
+ * 핵심 개념:
+ * - 컴파일 1회: 스크립트 → 토큰 → 재귀 하강 파서 → 4바이트 명령어 배열
+ * - 레지스터 기반: 스택 push/pop 대신 "ADD r0, r1, r2" 처럼 레지스터를 직접 지정
+ *   → 명령어 수가 줄어듦
+ * - computed goto: GCC/Clang 의 &&label 확장으로 명령어마다 다음 핸들러로 바로 점프
+ *   → switch 의 범위 검사와 단일 분기 지점을 없앰 (다른 컴파일러는 switch 로 대체)
+ * - 비교 대상: 같은 효과를 가상 함수 객체(virtual apply)로 구현한 버전
+ *
+ * 스크립트 문법:
+ *   heal 식;  damage 식;  buff 식;  dot 식, 턴수;
+ *   if 식 비교연산자 식 { ... } else { ... }
+ *   all { ... }        모든 적을 차례로 대상으로 지정 (다중 대상)
+ *   변수: hp maxhp level attack target_hp target_maxhp enemies
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o item_vm 05_item_effect_vm.cpp
+ * 실행: ./item_vm
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include <exception>
+using namespace std;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define USE_COMPUTED_GOTO 1
+#else
+#define USE_COMPUTED_GOTO 0
+#endif
+
+// 게임 예외 클래스 (chapter08/game.cpp 와 같은 구조)
+class GameException : public exception {
+protected:
+    string message;
+public:
+    explicit GameException(const string& msg) : message(msg) {}
+    const char* what() const noexcept override { return message.c_str(); }
+};
+
+class ScriptCompileException : public GameException {
+private:
+    size_t position;
+public:
+    ScriptCompileException(const string& detail, size_t pos)
+        : GameException("스크립트 오류 (위치 " + to_string(pos) + "): " + detail), position(pos) {}
+    size_t getPosition() const { return position; }
+};
+
+// [1] 효과가 작용하는 전투원 상태
+struct Combatant {
+    int health;
+    int maxHealth;
+    int attack;
+    int defense;
+    int level;
+    int dotDamage;     // 지속 피해량
+    int dotTurns;      // 남은 지속 턴
+
+    void takeDamage(int damage) {
+        health = max(0, health - max(1, damage - defense));
+    }
+
+    void heal(int amount) {
+        health = min(maxHealth, health + amount);
+    }
+};
+
+struct EffectContext {
+    Combatant* user;
+    Combatant* enemies;
+    int enemyCount;
+};
+
+// [2] 명령어 집합: 4바이트 고정 길이 (op, a, b, c)
+enum Op : uint8_t {
+    OP_LOADK,     // r[a] = imm16(b,c)
+    OP_LOADV,     // r[a] = 변수 b
+    OP_ADD,       // r[a] = r[b] + r[c]  (산술 결과는 ±10억으로 포화)
+    OP_SUB,
+    OP_MUL,
+    OP_DIV,       // 0 으로 나누면 0
+    OP_LT,        // r[a] = r[b] < r[c]
+    OP_LE,
+    OP_EQ,
+    OP_NE,
+    OP_JZ,        // r[a] == 0 이면 ip += imm16(b,c)
+    OP_JMP,       // ip += imm16(b,c)
+    OP_HEAL,      // 사용자 회복 r[a]
+    OP_DAMAGE,    // 현재 대상에게 피해 r[a]
+    OP_BUFF,      // 사용자 공격력 += r[a]
+    OP_DOT,       // 현재 대상에게 지속 피해 r[a], r[b] 턴
+    OP_FOREACH,   // 대상 = 0, 적이 없으면 ip += imm16(b,c)
+    OP_NEXT,      // 대상++, 남았으면 ip += imm16(b,c)
+    OP_END,
+    OP_COUNT
+};
+
+enum Var : uint8_t {
+    VAR_HP, VAR_MAXHP, VAR_LEVEL, VAR_ATTACK, VAR_TARGET_HP, VAR_TARGET_MAXHP, VAR_ENEMIES
+};
+
+struct Instr {
+    uint8_t op, a, b, c;
+    int16_t imm() const { return static_cast<int16_t>((b << 8) | c); }
+};
+
+class Bytecode {
+public:
+    static constexpr int kRegisters = 16;
+    vector<Instr> code;
+};
+
+// [3] 컴파일러: 재귀 하강 파서가 바로 레지스터 명령어를 생성
+class EffectCompiler {
+private:
+    enum class Tok { Number, Ident, Symbol, End };
+    struct Token {
+        Tok kind;
+        string text;
+        int value;
+        size_t pos;
+    };
+
+    vector<Token> tokens;
+    size_t cur = 0;
+    Bytecode out;
+    int nextReg = 0;
+
+public:
+    static Bytecode compile(const string& source) {
+        EffectCompiler c;
+        c.tokenize(source);
+        while (c.peek().kind != Tok::End) c.statement();
+        c.emit(OP_END, 0, 0, 0);
+        return move(c.out);
+    }
+
+private:
+    void tokenize(const string& s) {
+        size_t i = 0;
+        while (i < s.size()) {
+            unsigned char ch = s[i];
+            if (isspace(ch)) { ++i; continue; }
+            if (isdigit(ch)) {
+                size_t start = i;
+                int value = 0;
+                while (i < s.size() && isdigit(static_cast<unsigned char>(s[i]))) {
+                    value = value * 10 + (s[i++] - '0');
+                    if (value > INT16_MAX) throw ScriptCompileException("상수가 너무 큽니다", start);
+                }
+                tokens.push_back({Tok::Number, s.substr(start, i - start), value, start});
+            } else if (isalpha(ch) || ch == '_') {
+                size_t start = i;
+                while (i < s.size() && (isalnum(static_cast<unsigned char>(s[i])) || s[i] == '_')) ++i;
+                tokens.push_back({Tok::Ident, s.substr(start, i - start), 0, start});
+            } else {
+                string two = s.substr(i, 2);
+                if (two == "<=" || two == ">=" || two == "==" || two == "!=") {
+                    tokens.push_back({Tok::Symbol, two, 0, i});
+                    i += 2;
+                } else if (string("+-*/(){};,<>").find(static_cast<char>(ch)) != string::npos) {
+                    tokens.push_back({Tok::Symbol, string(1, static_cast<char>(ch)), 0, i});
+                    ++i;
+                } else {
+                    throw ScriptCompileException(string("알 수 없는 문자 '") + static_cast<char>(ch) + "'", i);
+                }
+            }
+        }
+        tokens.push_back({Tok::End, "", 0, s.size()});
+    }
+
+    const Token& peek() const { return tokens[cur]; }
+    bool accept(const string& text) {
+        if (peek().kind != Tok::End && peek().text == text) { ++cur; return true; }
+        return false;
+    }
+    void expect(const string& text) {
+        if (!accept(text)) throw ScriptCompileException("'" + text + "' 이(가) 필요합니다", peek().pos);
+    }
+
+    size_t emit(uint8_t op, uint8_t a, uint8_t b, uint8_t c) {
+        out.code.push_back({op, a, b, c});
+        return out.code.size() - 1;
+    }
+    size_t emitImm(uint8_t op, uint8_t a, int value) {
+        if (value < INT16_MIN || value > INT16_MAX) {
+            throw ScriptCompileException("상수가 너무 큽니다", peek().pos);
+        }
+        uint16_t u = static_cast<uint16_t>(value);
+        return emit(op, a, static_cast<uint8_t>(u >> 8), static_cast<uint8_t>(u & 0xFF));
+    }
+    // 점프 명령어의 오프셋을 나중에 채움 (오프셋은 다음 명령어 기준)
+    void patchJump(size_t at, size_t target) {
+        long long offset = static_cast<long long>(target) - static_cast<long long>(at) - 1;
+        if (offset < INT16_MIN || offset > INT16_MAX) {
+            throw ScriptCompileException("블록이 너무 깁니다 (점프 거리 초과)", peek().pos);
+        }
+        uint16_t u = static_cast<uint16_t>(offset);
+        out.code[at].b = static_cast<uint8_t>(u >> 8);
+        out.code[at].c = static_cast<uint8_t>(u & 0xFF);
+    }
+
+    uint8_t allocReg() {
+        if (nextReg >= Bytecode::kRegisters) {
+            throw ScriptCompileException("식이 너무 복잡합니다", peek().pos);
+        }
+        return static_cast<uint8_t>(nextReg++);
+    }
+
+    void block() {
+        expect("{");
+        while (!accept("}")) {
+            if (peek().kind == Tok::End) throw ScriptCompileException("'}' 이(가) 필요합니다", peek().pos);
+            statement();
+        }
+    }
+
+    void statement() {
+        nextReg = 0;     // 문장마다 레지스터를 처음부터 다시 사용
+        const Token& t = peek();
+        if (t.kind != Tok::Ident) throw ScriptCompileException("문장이 필요합니다", t.pos);
+        ++cur;
+
+        if (t.text == "heal" || t.text == "damage" || t.text == "buff") {
+            uint8_t r = expr();
+            uint8_t op = t.text == "heal" ? OP_HEAL : t.text == "damage" ? OP_DAMAGE : OP_BUFF;
+            emit(op, r, 0, 0);
+            expect(";");
+        } else if (t.text == "dot") {
+            uint8_t amount = expr();
+            expect(",");
+            uint8_t turns = expr();
+            emit(OP_DOT, amount, turns, 0);
+            expect(";");
+        } else if (t.text == "if") {
+            uint8_t cond = condition();
+            size_t jz = emitImm(OP_JZ, cond, 0);
+            block();
+            if (accept("else")) {
+                size_t jmp = emitImm(OP_JMP, 0, 0);
+                patchJump(jz, out.code.size());
+                block();
+                patchJump(jmp, out.code.size());
+            } else {
+                patchJump(jz, out.code.size());
+            }
+        } else if (t.text == "all") {
+            size_t begin = emitImm(OP_FOREACH, 0, 0);
+            block();
+            size_t next = emitImm(OP_NEXT, 0, 0);
+            patchJump(next, begin + 1);
+            patchJump(begin, out.code.size());
+        } else {
+            throw ScriptCompileException("알 수 없는 문장 '" + t.text + "'", t.pos);
+        }
+    }
+
+    uint8_t condition() {
+        uint8_t lhs = expr();
+        const Token& t = peek();
+        static const char* const kOps[] = {"<", "<=", ">", ">=", "==", "!="};
+        if (t.kind != Tok::Symbol || find(begin(kOps), end(kOps), t.text) == end(kOps)) {
+            throw ScriptCompileException("비교 연산자가 필요합니다", t.pos);     // End 토큰을 넘어가지 않음
+        }
+        string op = t.text;
+        ++cur;
+        uint8_t rhs = expr();
+        uint8_t r = allocReg();
+        if (op == "<")       emit(OP_LT, r, lhs, rhs);
+        else if (op == "<=") emit(OP_LE, r, lhs, rhs);
+        else if (op == ">")  emit(OP_LT, r, rhs, lhs);
+        else if (op == ">=") emit(OP_LE, r, rhs, lhs);
+        else if (op == "==") emit(OP_EQ, r, lhs, rhs);
+        else                 emit(OP_NE, r, lhs, rhs);
+        return r;
+    }
+
+    uint8_t expr() {
+        uint8_t lhs = term();
+        while (peek().text == "+" || peek().text == "-") {
+            uint8_t op = peek().text == "+" ? OP_ADD : OP_SUB;
+            ++cur;
+            uint8_t rhs = term();
+            emit(op, lhs, lhs, rhs);     // 결과를 왼쪽 레지스터에 덮어씀
+        }
+        return lhs;
+    }
+
+    uint8_t term() {
+        uint8_t lhs = factor();
+        while (peek().text == "*" || peek().text == "/") {
+            uint8_t op = peek().text == "*" ? OP_MUL : OP_DIV;
+            ++cur;
+            uint8_t rhs = factor();
+            emit(op, lhs, lhs, rhs);
+        }
+        return lhs;
+    }
+
+    uint8_t factor() {
+        const Token& t = peek();
+        if (accept("(")) {
+            uint8_t r = expr();
+            expect(")");
+            return r;
+        }
+        if (t.kind != Tok::Number && t.kind != Tok::Ident) throw ScriptCompileException("값이 필요합니다", t.pos);
+        ++cur;
+        uint8_t r = allocReg();
+        if (t.kind == Tok::Number) emitImm(OP_LOADK, r, t.value);
+        else emit(OP_LOADV, r, variable(t), 0);
+        return r;
+    }
+
+    static uint8_t variable(const Token& t) {
+        if (t.text == "hp") return VAR_HP;
+        if (t.text == "maxhp") return VAR_MAXHP;
+        if (t.text == "level") return VAR_LEVEL;
+        if (t.text == "attack") return VAR_ATTACK;
+        if (t.text == "target_hp") return VAR_TARGET_HP;
+        if (t.text == "target_maxhp") return VAR_TARGET_MAXHP;
+        if (t.text == "enemies") return VAR_ENEMIES;
+        throw ScriptCompileException("알 수 없는 변수 '" + t.text + "'", t.pos);
+    }
+};
+
+// [4] 인터프리터
+// 산술 결과는 int64 로 계산해 ±10억으로 포화: int32 넘침(정의되지 않은 동작)과 INT_MIN / -1 (SIGFPE) 방지
+constexpr int64_t kValueLimit = 1000000000;
+
+inline int32_t saturate(int64_t v) {
+    return static_cast<int32_t>(max(-kValueLimit, min(kValueLimit, v)));
+}
+
+void runEffect(const Bytecode& bc, EffectContext& ctx) {
+    int32_t r[Bytecode::kRegisters];
+    const Instr* ip = bc.code.data();
+    int target = 0;
+    Combatant& user = *ctx.user;
+
+#if USE_COMPUTED_GOTO
+    // 명령어 번호 순서와 같은 순서의 레이블 주소 테이블
+    static const void* const table[OP_COUNT] = {
+        &&L_OP_LOADK, &&L_OP_LOADV, &&L_OP_ADD, &&L_OP_SUB, &&L_OP_MUL, &&L_OP_DIV,
+        &&L_OP_LT, &&L_OP_LE, &&L_OP_EQ, &&L_OP_NE, &&L_OP_JZ, &&L_OP_JMP,
+        &&L_OP_HEAL, &&L_OP_DAMAGE, &&L_OP_BUFF, &&L_OP_DOT,
+        &&L_OP_FOREACH, &&L_OP_NEXT, &&L_OP_END
+    };
+    #define CASE(name) L_##name:
+    #define DISPATCH() goto *table[ip->op]
+#else
+    #define CASE(name) case name:
+    #define DISPATCH() continue
+#endif
+    #define NEXT() do { ++ip; DISPATCH(); } while (0)
+
+#if USE_COMPUTED_GOTO
+    DISPATCH();
+#else
+    for (;;) switch (ip->op) {
+#endif
+    CASE(OP_LOADK)  r[ip->a] = ip->imm(); NEXT();
+    CASE(OP_LOADV)
+        switch (ip->b) {
+            case VAR_HP:           r[ip->a] = user.health; break;
+            case VAR_MAXHP:        r[ip->a] = user.maxHealth; break;
+            case VAR_LEVEL:        r[ip->a] = user.level; break;
+            case VAR_ATTACK:       r[ip->a] = user.attack; break;
+            case VAR_TARGET_HP:    r[ip->a] = ctx.enemyCount ? ctx.enemies[target].health : 0; break;
+            case VAR_TARGET_MAXHP: r[ip->a] = ctx.enemyCount ? ctx.enemies[target].maxHealth : 0; break;
+            default:               r[ip->a] = ctx.enemyCount; break;
+        }
+        NEXT();
+    CASE(OP_ADD)  r[ip->a] = saturate(int64_t(r[ip->b]) + r[ip->c]); NEXT();
+    CASE(OP_SUB)  r[ip->a] = saturate(int64_t(r[ip->b]) - r[ip->c]); NEXT();
+    CASE(OP_MUL)  r[ip->a] = saturate(int64_t(r[ip->b]) * r[ip->c]); NEXT();
+    CASE(OP_DIV)  r[ip->a] = r[ip->c] ? saturate(int64_t(r[ip->b]) / r[ip->c]) : 0; NEXT();
+    CASE(OP_LT)   r[ip->a] = r[ip->b] < r[ip->c]; NEXT();
+    CASE(OP_LE)   r[ip->a] = r[ip->b] <= r[ip->c]; NEXT();
+    CASE(OP_EQ)   r[ip->a] = r[ip->b] == r[ip->c]; NEXT();
+    CASE(OP_NE)   r[ip->a] = r[ip->b] != r[ip->c]; NEXT();
+    CASE(OP_JZ)   if (r[ip->a] == 0) ip += ip->imm(); NEXT();
+    CASE(OP_JMP)  ip += ip->imm(); NEXT();
+    CASE(OP_HEAL) user.heal(r[ip->a]); NEXT();
+    CASE(OP_DAMAGE)
+        if (ctx.enemyCount) ctx.enemies[target].takeDamage(r[ip->a]);
+        NEXT();
+    CASE(OP_BUFF) user.attack = saturate(int64_t(user.attack) + r[ip->a]); NEXT();
+    CASE(OP_DOT)
+        if (ctx.enemyCount) {
+            ctx.enemies[target].dotDamage = r[ip->a];
+            ctx.enemies[target].dotTurns = r[ip->b];
+        }
+        NEXT();
+    CASE(OP_FOREACH)
+        target = 0;
+        if (ctx.enemyCount == 0) ip += ip->imm();
+        NEXT();
+    CASE(OP_NEXT)
+        if (++target < ctx.enemyCount) ip += ip->imm();
+        else target = 0;
+        NEXT();
+    CASE(OP_END) return;
+#if !USE_COMPUTED_GOTO
+    }
+#endif
+    #undef CASE
+    #undef DISPATCH
+    #undef NEXT
+}
+
+// [5] 비교용: 가상 함수 효과 객체 (같은 동작을 C++ 코드로 직접 구현)
+class Effect {
+public:
+    virtual ~Effect() = default;
+    virtual void apply(EffectContext& ctx) const = 0;
+};
+
+class HealEffect : public Effect {
+    int amount;
+public:
+    explicit HealEffect(int a) : amount(a) {}
+    void apply(EffectContext& ctx) const override { ctx.user->heal(amount); }
+};
+
+class BuffEffect : public Effect {
+    int amount;
+public:
+    explicit BuffEffect(int a) : amount(a) {}
+    void apply(EffectContext& ctx) const override { ctx.user->attack += amount; }
+};
+
+class ConditionalHealEffect : public Effect {
+public:
+    void apply(EffectContext& ctx) const override {
+        Combatant& u = *ctx.user;
+        u.heal(u.health < u.maxHealth / 2 ? 50 : 20);
+    }
+};
+
+class PoisonEffect : public Effect {
+public:
+    void apply(EffectContext& ctx) const override {
+        if (ctx.enemyCount == 0) return;
+        ctx.enemies[0].dotDamage = 5 + ctx.user->level;
+        ctx.enemies[0].dotTurns = 3;
+    }
+};
+
+class AreaDamageEffect : public Effect {
+public:
+    void apply(EffectContext& ctx) const override {
+        for (int i = 0; i < ctx.enemyCount; ++i) {
+            ctx.enemies[i].takeDamage(ctx.user->attack + ctx.user->level * 3);
+        }
+    }
+};
+
+class DrainEffect : public Effect {
+public:
+    void apply(EffectContext& ctx) const override {
+        if (ctx.enemyCount == 0) return;
+        ctx.enemies[0].takeDamage(ctx.user->level * 4);
+        if (ctx.enemies[0].health <= ctx.enemies[0].maxHealth / 2) ctx.user->heal(10);
+    }
+};
+
+// [6] 스크립트 아이템
+struct ScriptedItem {
+    string name;
+    string source;
+    Bytecode code;
+    unique_ptr<Effect> native;    // 벤치마크 비교용
+};
+
+// 전투 상태 초기화 (매 반복마다 같은 상태에서 시작)
+void resetState(Combatant& user, Combatant* enemies, int count) {
+    user = {40, 100, 20, 5, 7, 0, 0};
+    for (int i = 0; i < count; ++i) enemies[i] = {80 + i * 10, 120, 15, 3, 5, 0, 0};
+}
+
+uint64_t checksum(const Combatant& user, const Combatant* enemies, int count) {
+    uint64_t h = static_cast<uint64_t>(user.health) * 31 + static_cast<uint64_t>(user.attack);
+    for (int i = 0; i < count; ++i) {
+        h = h * 131 + static_cast<uint64_t>(enemies[i].health) * 7
+                    + static_cast<uint64_t>(enemies[i].dotDamage * 3 + enemies[i].dotTurns);
+    }
+    return h;
+}
+
+// 벤치마크 결과가 최적화로 사라지지 않도록 저장
+volatile uint64_t g_sink = 0;
+
+int main() {
+    vector<ScriptedItem> items;
+    items.push_back({"체력 포션", "heal 30;", {}, make_unique<HealEffect>(30)});
+    items.push_back({"힘의 물약", "buff 10;", {}, make_unique<BuffEffect>(10)});
+    items.push_back({"재생의 물약", "if hp < maxhp / 2 { heal 50; } else { heal 20; }", {},
+                     make_unique<ConditionalHealEffect>()});
+    items.push_back({"독 단검", "dot 5 + level, 3;", {}, make_unique<PoisonEffect>()});
+    items.push_back({"화염 폭탄", "all { damage attack + level * 3; }", {},
+                     make_unique<AreaDamageEffect>()});
+    items.push_back({"흡혈 부적", "damage level * 4; if target_hp <= target_maxhp / 2 { heal 10; }", {},
+                     make_unique<DrainEffect>()});
+
+    cout << "=== 아이템 효과 컴파일 ===" << endl;
+    try {
+        for (auto& item : items) {
+            item.code = EffectCompiler::compile(item.source);
+            cout << item.name << ": \"" << item.source << "\" → "
+                 << item.code.code.size() << " 명령어 ("
+                 << item.code.code.size() * sizeof(Instr) << " 바이트)" << endl;
+        }
+        EffectCompiler::compile("heal 10 +;");
+    }
+    catch (const ScriptCompileException& e) {
+        cout << "잘못된 스크립트 예시 → " << e.what() << endl;
+    }
+
+    // 잘린/잘못된 스크립트: 모두 ScriptCompileException 이어야 하고, 위치는 소스 안(끝 포함)
+    const char* malformed[] = {
+        "if", "if hp", "if hp <", "if hp < 3", "if hp < 3 {", "if hp < 3 { heal 1;", "if hp 3 { heal 1; }",
+        "if hp = 3 { heal 1; }", "if hp < 3 { heal 1; } else", "heal", "heal 10", "heal 10 +", "heal (1 + 2",
+        "heal ;", "dot 5", "dot 5,", "dot 5, 3", "all", "all {", "all { damage 1;", "foo 1;", "heal mana;",
+        "heal 99999999999;", "heal 1 $", "}", "(", "heal 1; }",
+    };
+    int badHandled = 0, badTotal = 0;
+    for (const char* src : malformed) {
+        ++badTotal;
+        try {
+            EffectCompiler::compile(src);
+            cout << "컴파일되면 안 되는 스크립트: \"" << src << "\"" << endl;
+        }
+        catch (const ScriptCompileException& e) {
+            if (e.getPosition() <= string(src).size()) ++badHandled;
+            else cout << "잘못된 위치 " << e.getPosition() << ": \"" << src << "\"" << endl;
+        }
+    }
+    cout << "잘못된 스크립트 " << badTotal << "개 중 올바르게 거부: " << badHandled << "개" << endl;
+    bool rejectsMalformed = badHandled == badTotal;
+
+    // 넘침 스크립트: 컴파일은 되고, 실행해도 죽지 않고 포화된 값이 나와야 함
+    const char* overflowing[] = {
+        "heal (0 - 32767 - 1) * 256 * 256 / (0 - 1);",
+        "buff 32767 * 32767 * 32767;",
+        "damage (0 - 32767) * 32767 * 32767 - 32767;",
+        "all { buff 32767 * 32767 * 32767; }",
+    };
+    bool survivesOverflow = true;
+    for (const char* src : overflowing) {
+        Combatant u{100, 100, 20, 5, 1, 0, 0};
+        Combatant foes[4] = {u, u, u, u};
+        EffectContext c{&u, foes, 4};
+        runEffect(EffectCompiler::compile(src), c);
+        survivesOverflow = survivesOverflow && u.health >= 0 && u.health <= u.maxHealth &&
+                           u.attack <= kValueLimit && foes[0].health >= 0;
+    }
+    cout << "넘침 스크립트 실행: " << (survivesOverflow ? "포화 처리됨" : "실패") << endl;
+
+    // 점프 거리: int16 을 넘는 블록은 컴파일 오류, 그 안쪽은 정상 실행
+    auto longIf = [](int heals) {
+        string src = "if hp < 1000 { ";
+        for (int i = 0; i < heals; ++i) src += "heal 1; ";
+        return src + "}";
+    };
+    bool jumpChecked = false;
+    try {
+        EffectCompiler::compile(longIf(20000));      // 본문 40000 명령어
+    }
+    catch (const ScriptCompileException& e) {
+        jumpChecked = true;
+        cout << "긴 블록 → " << e.what() << endl;
+    }
+    {
+        Combatant u{50, 100, 20, 5, 1, 0, 0};
+        EffectContext c{&u, nullptr, 0};
+        runEffect(EffectCompiler::compile(longIf(16000)), c);
+        jumpChecked = jumpChecked && u.health == 100;
+    }
+
+    cout << "\n=== 바이트코드 VM vs 가상 함수 ("
+         << (USE_COMPUTED_GOTO ? "computed goto" : "switch") << " 디스패치) ===" << endl;
+
+    const int kEnemies = 4;
+    const int iterations = 2000000;
+    Combatant user;
+    Combatant enemies[kEnemies];
+    EffectContext ctx{&user, enemies, kEnemies};
+    bool allMatch = true;
+
+    for (const auto& item : items) {
+        // 결과가 같은지 먼저 확인
+        resetState(user, enemies, kEnemies);
+        runEffect(item.code, ctx);
+        uint64_t vmSum = checksum(user, enemies, kEnemies);
+        resetState(user, enemies, kEnemies);
+        item.native->apply(ctx);
+        uint64_t nativeSum = checksum(user, enemies, kEnemies);
+        allMatch = allMatch && vmSum == nativeSum;
+
+        uint64_t sink = 0;
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            resetState(user, enemies, kEnemies);
+            runEffect(item.code, ctx);
+            sink += static_cast<uint64_t>(user.health + enemies[0].health);
+        }
+        auto t1 = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            resetState(user, enemies, kEnemies);
+            item.native->apply(ctx);
+            sink += static_cast<uint64_t>(user.health + enemies[0].health);
+        }
+        auto t2 = chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            resetState(user, enemies, kEnemies);
+            sink += static_cast<uint64_t>(user.health + enemies[0].health);
+        }
+        auto t3 = chrono::steady_clock::now();
+
+        // 상태 초기화 비용을 빼고 효과 실행 시간만 계산
+        double baseNs = chrono::duration<double, nano>(t3 - t2).count() / iterations;
+        double vmNs = chrono::duration<double, nano>(t1 - t0).count() / iterations - baseNs;
+        double nativeNs = chrono::duration<double, nano>(t2 - t1).count() / iterations - baseNs;
+
+        cout << item.name << ": VM " << max(0.0, vmNs) << " ns, 가상 함수 "
+             << max(0.0, nativeNs) << " ns"
+             << (vmSum == nativeSum ? "" : "  (결과 불일치!)") << endl;
+        g_sink = sink;
+    }
+
+    cout << "\n두 구현의 결과 일치: " << (allMatch ? "예" : "아니오") << endl;
+    return allMatch && rejectsMalformed && survivesOverflow && jumpChecked ? 0 : 1;
+}
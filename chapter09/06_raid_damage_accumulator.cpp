@@ -0,0 +1,299 @@
+/*
+ * 파일명: 06_raid_damage_accumulator.cpp
+ *
+ * 주제: 틱 기반 대규모 레이드와 스레드별 피해 누산기 (Per-thread Damage Accumulator)
+ * 정의: 수천 명의 플레이어가 보스 하나를 공격할 때, 각 스레드가 자기 누산기에만
+ *       피해를 더하고 틱이 끝날 때 한 번만 합산하여 보스에게 적용하는 기법
+ *
+ * 단순한 방법의 문제점:
+ * - 모든 스레드가 boss.health 하나에 fetch_sub → 같은 캐시 라인을 두고 경합
+ * - 스레드 실행 순서에 따라 "누가 마지막 일격을 넣었는가"가 매번 달라짐
+ *
+ * 핵심 개념:
+ * - 스레드별 누산기: 캐시 라인 크기로 정렬하여 false sharing 방지
+ * - 결정론적 난수: (시드, 틱, 플레이어 번호)를 해시하여 난수 생성
+ *   → 어떤 스레드가 어떤 플레이어를 처리하든 결과가 같음
+ * - 정수 합산은 순서와 무관 → 스레드 수가 달라도 틱 결과가 비트 단위로 동일
+ * - 일괄 적용: 피해 계산(max(1, 피해 - 방어력))은 타격마다, 체력 감소는 틱마다 한 번
+ * - 배리어(barrier): 모든 스레드가 한 틱을 끝낼 때까지 기다렸다가 다음 틱 시작
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o raid 06_raid_damage_accumulator.cpp
+ * 실행: ./raid [플레이어 수] [스레드 수] [틱 수] [초당 틱(0=최대 속도)]
+ */
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+using namespace std;
+
+// [1] 결정론적 난수: splitmix64 해시
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t rollFor(uint64_t seed, uint64_t tick, uint64_t player, uint64_t stream) {
+    return mix64(seed ^ mix64(tick * 0x100000001B3ULL ^ mix64(player * 4 + stream)));
+}
+
+// [2] 레이드 참가자: 구조체 배열 대신 배열 구조체(SoA) → 스레드마다 연속 구간을 처리
+struct RaidParty {
+    vector<int> health;
+    vector<int> maxHealth;
+    vector<int> attack;
+    vector<int> defense;
+    vector<int> level;
+
+    explicit RaidParty(size_t count) {
+        health.resize(count);
+        maxHealth.resize(count);
+        attack.resize(count);
+        defense.resize(count);
+        level.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            level[i] = 1 + static_cast<int>(i % 30);
+            maxHealth[i] = health[i] = 100 + (level[i] - 1) * 20;   // Player::levelUp 과 같은 성장
+            attack[i] = 20 + (level[i] - 1) * 5;
+            defense[i] = 5 + (level[i] - 1) * 2;
+        }
+    }
+
+    size_t size() const { return health.size(); }
+};
+
+struct Boss {
+    string name;
+    int64_t health;
+    int64_t maxHealth;
+    int attack;
+    int defense;
+};
+
+// [3] 스레드별 누산기 (캐시 라인 하나를 통째로 차지)
+struct alignas(64) DamageAccumulator {
+    int64_t damage = 0;
+    int64_t hits = 0;
+    int64_t criticals = 0;
+    int64_t playerDeaths = 0;
+};
+
+// [4] 재사용 가능한 배리어 (C++17 에는 std::barrier 가 없음)
+class Barrier {
+private:
+    mutex mtx;
+    condition_variable cv;
+    size_t total;
+    size_t waiting = 0;
+    size_t generation = 0;
+
+public:
+    explicit Barrier(size_t n) : total(n) {}
+
+    void arriveAndWait() {
+        unique_lock<mutex> lock(mtx);
+        size_t gen = generation;
+        if (++waiting == total) {
+            waiting = 0;
+            ++generation;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return gen != generation; });
+        }
+    }
+};
+
+// [5] 레이드 시뮬레이션
+class RaidSimulation {
+private:
+    RaidParty& party;
+    Boss& boss;
+    uint64_t seed;
+    size_t threadCount;
+
+    vector<DamageAccumulator> accumulators;
+    vector<thread> workers;
+    Barrier startBarrier;
+    Barrier endBarrier;
+    uint64_t currentTick = 0;
+    bool bossAlive = true;      // 틱 시작 시점의 보스 생존 여부 (틱 동안 변하지 않음)
+    bool stopping = false;
+
+public:
+    RaidSimulation(RaidParty& p, Boss& b, uint64_t s, size_t threads)
+        : party(p), boss(b), seed(s), threadCount(max<size_t>(1, threads)),
+          accumulators(threadCount),
+          startBarrier(threadCount + 1), endBarrier(threadCount + 1) {
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back(&RaidSimulation::workerLoop, this, t);
+        }
+    }
+
+    ~RaidSimulation() {
+        stopping = true;
+        startBarrier.arriveAndWait();
+        for (auto& w : workers) w.join();
+    }
+
+    RaidSimulation(const RaidSimulation&) = delete;
+    RaidSimulation& operator=(const RaidSimulation&) = delete;
+
+    struct TickResult {
+        int64_t damage;
+        int64_t hits;
+        int64_t criticals;
+        int64_t playerDeaths;
+    };
+
+    // 틱 하나: 병렬 계산 → 배리어 → 합산 → 보스에게 일괄 적용
+    TickResult tick() {
+        bossAlive = boss.health > 0;
+        startBarrier.arriveAndWait();     // 작업 시작 신호
+        endBarrier.arriveAndWait();       // 모든 스레드 완료 대기
+
+        TickResult r{0, 0, 0, 0};
+        for (auto& acc : accumulators) {  // 고정된 순서로 합산 (정수라 순서와 무관하지만 명시)
+            r.damage += acc.damage;
+            r.hits += acc.hits;
+            r.criticals += acc.criticals;
+            r.playerDeaths += acc.playerDeaths;
+        }
+        // takeDamage 의 체력 감소와 0 고정을 틱마다 한 번만 적용
+        boss.health = max<int64_t>(0, boss.health - r.damage);
+        ++currentTick;
+        return r;
+    }
+
+private:
+    void workerLoop(size_t id) {
+        while (true) {
+            startBarrier.arriveAndWait();
+            if (stopping) return;
+            processRange(id);
+            endBarrier.arriveAndWait();
+        }
+    }
+
+    // 플레이어를 스레드 수로 나눈 연속 구간 하나를 처리
+    void processRange(size_t id) {
+        size_t n = party.size();
+        size_t begin = n * id / threadCount;
+        size_t end = n * (id + 1) / threadCount;
+        DamageAccumulator local;
+
+        bool reviveTick = currentTick % 100 == 99;   // 100 틱마다 쓰러진 플레이어 부활
+
+        for (size_t i = begin; i < end; ++i) {
+            if (party.health[i] <= 0) {
+                if (reviveTick) party.health[i] = party.maxHealth[i];
+                continue;
+            }
+
+            // 플레이어 → 보스 (Player::calculateDamage 와 같은 ±5 범위 + 5% 치명타)
+            if (bossAlive) {
+                uint64_t r = rollFor(seed, currentTick, i, 0);
+                int damage = party.attack[i] - 5 + static_cast<int>(r % 11);
+                if ((r >> 32) % 100 < 5) {
+                    damage *= 2;
+                    ++local.criticals;
+                }
+                local.damage += max(1, max(1, damage) - boss.defense);
+                ++local.hits;
+            }
+
+            // 보스 광역 공격: 매 틱 플레이어 1/8 이 맞음 (자기 체력만 수정 → 경합 없음)
+            uint64_t r2 = rollFor(seed, currentTick, i, 1);
+            if (bossAlive && r2 % 8 == 0) {
+                int damage = boss.attack - 3 + static_cast<int>((r2 >> 8) % 7);
+                party.health[i] -= max(1, damage - party.defense[i]);
+                if (party.health[i] <= 0) {
+                    party.health[i] = 0;
+                    ++local.playerDeaths;
+                }
+            }
+        }
+        accumulators[id].damage = local.damage;   // 공유 배열에는 끝날 때 한 번만 기록
+        accumulators[id].hits = local.hits;
+        accumulators[id].criticals = local.criticals;
+        accumulators[id].playerDeaths = local.playerDeaths;
+    }
+};
+
+// 틱마다 상태 해시를 이어 붙여 실행 전체의 지문을 만듦
+struct RaidOutcome {
+    uint64_t fingerprint = 0;
+    uint64_t ticks = 0;
+    int64_t bossHealth = 0;
+    int64_t survivors = 0;
+    double seconds = 0;
+};
+
+RaidOutcome runRaid(size_t players, size_t threads, uint64_t maxTicks, int tickRate, bool verbose) {
+    RaidParty party(players);
+    Boss boss{"고대 드래곤", 0, 0, 180, 40};
+    boss.maxHealth = boss.health = static_cast<int64_t>(players) * 100000;
+
+    RaidOutcome out;
+    auto start = chrono::steady_clock::now();
+    auto nextTick = start;
+    {
+        RaidSimulation sim(party, boss, 20261018, threads);
+        for (uint64_t t = 0; t < maxTicks && boss.health > 0; ++t) {
+            auto r = sim.tick();
+            out.fingerprint = mix64(out.fingerprint ^ static_cast<uint64_t>(boss.health)
+                                    ^ (static_cast<uint64_t>(r.playerDeaths) << 40));
+            ++out.ticks;
+
+            if (verbose && (t % 500 == 0 || boss.health == 0)) {
+                cout << "틱 " << t << ": 피해 " << r.damage << " (치명타 " << r.criticals
+                     << ") | 보스 체력 " << boss.health << "/" << boss.maxHealth
+                     << " | 쓰러진 플레이어 +" << r.playerDeaths << endl;
+            }
+            if (tickRate > 0) {      // 고정 틱 모드: 다음 틱 시각까지 대기
+                nextTick += chrono::microseconds(1000000 / tickRate);
+                this_thread::sleep_until(nextTick);
+            }
+        }
+    }
+    out.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    out.bossHealth = boss.health;
+    out.survivors = count_if(party.health.begin(), party.health.end(), [](int h) { return h > 0; });
+    if (verbose && boss.health == 0) {
+        cout << boss.name << "이(가) 쓰러졌습니다!" << endl;
+    }
+    return out;
+}
+
+int main(int argc, char* argv[]) {
+    size_t players = argc > 1 ? stoul(argv[1]) : 10000;
+    size_t threads = argc > 2 ? stoul(argv[2]) : max(1u, thread::hardware_concurrency());
+    uint64_t ticks = argc > 3 ? stoull(argv[3]) : 2000;
+    int tickRate = argc > 4 ? stoi(argv[4]) : 0;
+
+    cout << "=== 대규모 레이드 (플레이어 " << players << "명, 스레드 " << threads << "개) ===" << endl;
+    RaidOutcome main = runRaid(players, threads, ticks, tickRate, true);
+
+    cout << "\n진행한 틱: " << main.ticks << " | 보스 남은 체력: " << main.bossHealth
+         << " | 생존자: " << main.survivors << endl;
+    cout << "처리 속도: " << main.ticks / max(main.seconds, 1e-9) << " 틱/초 ("
+         << main.ticks * players / max(main.seconds, 1e-9) / 1e6 << " 백만 공격/초)" << endl;
+
+    // 결정론 확인: 스레드 수를 바꿔도 틱별 결과가 같아야 함
+    cout << "\n=== 결정론 확인 ===" << endl;
+    bool same = true;
+    for (size_t t : {size_t(1), size_t(3), threads * 2}) {
+        RaidOutcome other = runRaid(players, t, ticks, 0, false);
+        bool match = other.fingerprint == main.fingerprint && other.ticks == main.ticks;
+        same = same && match;
+        cout << "스레드 " << t << "개: 지문 " << hex << other.fingerprint << dec
+             << (match ? " (일치)" : " (불일치!)") << endl;
+    }
+    return same ? 0 : 1;
+}
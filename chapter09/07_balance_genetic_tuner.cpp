@@ -0,0 +1,373 @@
+/*
+ * 파일명: 07_balance_genetic_tuner.cpp
+ *
+ * 주제: 유전 알고리즘을 이용한 밸런스 상수 자동 조정 (Genetic Algorithm Auto-tuner)
+ * 정의: 몬스터 능력치 공식과 레벨업 증가량을 유전자로 보고, 헤드리스 전투 시뮬레이션
+ *       결과가 목표 곡선(레벨별 승률, 평균 전투 턴 수)에 가까워지도록 진화시키는 기법
+ *
+ * chapter08/game.cpp 의 손으로 정한 상수:
+ * - MonsterFactory::createRandomMonster: 슬라임 체력 30 + level*10 등 몬스터 4종 × 6개 값
+ * - Player::levelUp: 체력 +20, 공격력 +5, 방어력 +2
+ *
+ * 핵심 개념:
+ * - 유전자(genome): 조정할 상수들을 정수 배열로 표현, 각 값마다 허용 범위 지정
+ * - 적합도(fitness): 목표 곡선과의 오차 제곱합의 음수 (클수록 좋음)
+ * - 토너먼트 선택, 균등 교차, 범위 안 돌연변이, 엘리트 보존
+ * - 공통 난수(common random numbers): 후보마다 같은 시드로 전투 → 비교가 공정하고 결과 재현 가능
+ * - 적합도 캐시: 유전자 해시 → 적합도 (같은 후보는 다시 평가하지 않음)
+ * - 일괄 병렬 평가: 세대마다 캐시에 없는 후보만 모아 모든 코어에 나눠 평가
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o ga_tuner 07_balance_genetic_tuner.cpp
+ * 실행: ./ga_tuner [세대 수] [개체 수] [레벨당 전투 수]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+using namespace std;
+
+// [1] 유전자: game.cpp 의 밸런스 상수 27개
+const int kMonsterTypes = 4;
+const int kPerMonster = 6;     // 체력, 레벨당 체력, 공격, 레벨당 공격, 방어, 레벨당 방어
+const int kGenes = kMonsterTypes * kPerMonster + 3;
+
+using Genome = array<int, kGenes>;
+
+struct GeneRange {
+    int lo, hi;
+};
+
+const char* kMonsterNames[kMonsterTypes] = {"슬라임", "고블린", "오크", "드래곤"};
+
+// 현재 game.cpp 의 값 (출발점이자 비교 기준)
+Genome baselineGenome() {
+    return {
+         30, 10,  8, 2, 1, 1,     // 슬라임
+         50, 15, 12, 3, 3, 1,     // 고블린
+         80, 20, 18, 4, 5, 2,     // 오크
+        150, 30, 25, 5, 8, 3,     // 드래곤
+         20,  5,  2               // 레벨업: 체력, 공격력, 방어력
+    };
+}
+
+GeneRange rangeOf(int gene) {
+    if (gene >= kMonsterTypes * kPerMonster) {
+        static const GeneRange levelUp[3] = {{5, 60}, {1, 15}, {0, 8}};
+        return levelUp[gene - kMonsterTypes * kPerMonster];
+    }
+    static const GeneRange perStat[kPerMonster] = {
+        {10, 300}, {1, 60}, {3, 60}, {0, 12}, {0, 20}, {0, 6}
+    };
+    return perStat[gene % kPerMonster];
+}
+
+uint64_t hashGenome(const Genome& g) {
+    uint64_t h = 1469598103934665603ULL;      // FNV-1a
+    for (int v : g) {
+        h ^= static_cast<uint32_t>(v);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// [2] 헤드리스 전투: game.cpp 의 BattleSystem::battle 을 입력 없이 재현
+struct Fighter {
+    int health, maxHealth, attack, defense;
+};
+
+struct FightResult {
+    bool won;
+    int turns;
+};
+
+// 플레이어 AI: 체력이 30% 미만이고 포션이 남았으면 사용, 아니면 공격
+FightResult simulateFight(Fighter player, Fighter monster, int potions, mt19937& gen) {
+    int turns = 0;
+    while (player.health > 0 && monster.health > 0 && turns < 200) {
+        ++turns;
+        if (player.health * 10 < player.maxHealth * 3 && potions > 0) {
+            player.health = min(player.maxHealth, player.health + 30);
+            --potions;
+        } else {
+            uniform_int_distribution<> pd(player.attack - 5, player.attack + 5);
+            monster.health -= max(1, max(1, pd(gen)) - monster.defense);
+            if (monster.health <= 0) break;
+        }
+        uniform_int_distribution<> md(monster.attack - 3, monster.attack + 3);
+        player.health -= max(1, max(1, md(gen)) - player.defense);
+    }
+    return {player.health > 0 && monster.health <= 0, turns};
+}
+
+// [3] 목표 곡선
+const int kLevels = 20;
+
+double targetWinRate(int level) {
+    return 0.95 - 0.25 * (level - 1) / (kLevels - 1);     // 레벨 1: 95% → 레벨 20: 70%
+}
+
+double targetTurns(int level) {
+    return 4.0 + 4.0 * (level - 1) / (kLevels - 1);       // 레벨 1: 4턴 → 레벨 20: 8턴
+}
+
+struct Evaluation {
+    double fitness;
+    array<double, kLevels> winRate;
+    array<double, kLevels> avgTurns;
+};
+
+// 던전 레벨 L 에서 플레이어 레벨은 대략 1 + (L-1)/2 로 가정
+Evaluation evaluate(const Genome& g, int fightsPerLevel) {
+    Evaluation e{};
+    double error = 0.0;
+    const int* levelUp = &g[kMonsterTypes * kPerMonster];
+
+    for (int level = 1; level <= kLevels; ++level) {
+        mt19937 gen(static_cast<uint32_t>(level * 7919));      // 공통 난수
+        uniform_int_distribution<> pick(0, kMonsterTypes - 1);
+
+        int playerLevel = 1 + (level - 1) / 2;
+        Fighter player{100, 100, 20, 5};
+        player.maxHealth += (playerLevel - 1) * levelUp[0];
+        player.health = player.maxHealth;
+        player.attack += (playerLevel - 1) * levelUp[1];
+        player.defense += (playerLevel - 1) * levelUp[2];
+
+        int wins = 0;
+        long turns = 0;
+        for (int f = 0; f < fightsPerLevel; ++f) {
+            const int* m = &g[pick(gen) * kPerMonster];
+            Fighter monster{m[0] + level * m[1], 0, m[2] + level * m[3], m[4] + level * m[5]};
+            monster.maxHealth = monster.health;
+            FightResult r = simulateFight(player, monster, 1, gen);
+            wins += r.won;
+            turns += r.turns;
+        }
+        e.winRate[level - 1] = double(wins) / fightsPerLevel;
+        e.avgTurns[level - 1] = double(turns) / fightsPerLevel;
+
+        double winErr = e.winRate[level - 1] - targetWinRate(level);
+        double turnErr = (e.avgTurns[level - 1] - targetTurns(level)) / targetTurns(level);
+        error += winErr * winErr + 0.5 * turnErr * turnErr;
+    }
+    e.fitness = -error;
+    return e;
+}
+
+// [4] 캐시 + 일괄 병렬 평가기
+class ParallelEvaluator {
+private:
+    int fightsPerLevel;
+    size_t threadCount;
+    unordered_map<uint64_t, Evaluation> cache;   // 메인 스레드만 접근
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    double evalSeconds = 0.0;
+
+public:
+    ParallelEvaluator(int fights, size_t threads)
+        : fightsPerLevel(fights), threadCount(max<size_t>(1, threads)) {}
+
+    // 개체군 전체의 적합도를 반환: 캐시에 없는 유전자만 모아 병렬 평가
+    vector<double> evaluateAll(const vector<Genome>& population) {
+        vector<uint64_t> keys(population.size());
+        vector<size_t> pending;               // 평가가 필요한 개체 번호 (중복 제거)
+        unordered_map<uint64_t, size_t> seen;
+
+        for (size_t i = 0; i < population.size(); ++i) {
+            keys[i] = hashGenome(population[i]);
+            if (cache.count(keys[i])) { ++hits; continue; }
+            if (seen.emplace(keys[i], i).second) pending.push_back(i);
+            else ++hits;
+        }
+        misses += pending.size();
+
+        vector<Evaluation> results(pending.size());
+        atomic<size_t> next{0};
+        auto worker = [&] {
+            size_t k;
+            while ((k = next.fetch_add(1)) < pending.size()) {
+                results[k] = evaluate(population[pending[k]], fightsPerLevel);
+            }
+        };
+
+        auto t0 = chrono::steady_clock::now();
+        vector<thread> threads;
+        for (size_t t = 1; t < threadCount; ++t) threads.emplace_back(worker);
+        worker();                              // 메인 스레드도 일꾼으로 참여
+        for (auto& t : threads) t.join();
+        evalSeconds += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        for (size_t k = 0; k < pending.size(); ++k) cache[keys[pending[k]]] = results[k];
+
+        vector<double> fitness(population.size());
+        for (size_t i = 0; i < population.size(); ++i) fitness[i] = cache[keys[i]].fitness;
+        return fitness;
+    }
+
+    const Evaluation& details(const Genome& g) {
+        auto it = cache.find(hashGenome(g));
+        if (it == cache.end()) {
+            it = cache.emplace(hashGenome(g), evaluate(g, fightsPerLevel)).first;
+        }
+        return it->second;
+    }
+
+    uint64_t cacheHits() const { return hits; }
+    uint64_t evaluations() const { return misses; }
+    double secondsSpent() const { return evalSeconds; }
+};
+
+// [5] 유전 연산자
+class GeneticTuner {
+private:
+    mt19937 gen;
+    size_t populationSize;
+    double mutationRate = 0.15;
+    size_t eliteCount = 2;
+
+public:
+    GeneticTuner(uint32_t seed, size_t popSize) : gen(seed), populationSize(popSize) {}
+
+    vector<Genome> initialPopulation(const Genome& seedGenome) {
+        vector<Genome> pop{seedGenome};
+        while (pop.size() < populationSize) {
+            Genome g = seedGenome;
+            mutate(g, 0.5);
+            pop.push_back(g);
+        }
+        return pop;
+    }
+
+    vector<Genome> nextGeneration(const vector<Genome>& pop, const vector<double>& fitness) {
+        vector<size_t> order(pop.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fitness[a] > fitness[b]; });
+
+        vector<Genome> next;
+        for (size_t i = 0; i < eliteCount && i < order.size(); ++i) next.push_back(pop[order[i]]);
+
+        while (next.size() < populationSize) {
+            const Genome& a = pop[tournament(fitness)];
+            const Genome& b = pop[tournament(fitness)];
+            Genome child = crossover(a, b);
+            mutate(child, mutationRate);
+            next.push_back(child);
+        }
+        return next;
+    }
+
+private:
+    size_t tournament(const vector<double>& fitness) {
+        uniform_int_distribution<size_t> pick(0, fitness.size() - 1);
+        size_t best = pick(gen);
+        for (int k = 0; k < 2; ++k) {
+            size_t c = pick(gen);
+            if (fitness[c] > fitness[best]) best = c;
+        }
+        return best;
+    }
+
+    Genome crossover(const Genome& a, const Genome& b) {
+        Genome child;
+        bernoulli_distribution coin(0.5);
+        for (int i = 0; i < kGenes; ++i) child[i] = coin(gen) ? a[i] : b[i];
+        return child;
+    }
+
+    void mutate(Genome& g, double rate) {
+        bernoulli_distribution happen(rate);
+        for (int i = 0; i < kGenes; ++i) {
+            if (!happen(gen)) continue;
+            GeneRange r = rangeOf(i);
+            int span = max(1, (r.hi - r.lo) / 10);
+            uniform_int_distribution<> step(-span, span);
+            g[i] = min(r.hi, max(r.lo, g[i] + step(gen)));
+        }
+    }
+};
+
+void printGenome(const Genome& g) {
+    for (int m = 0; m < kMonsterTypes; ++m) {
+        const int* v = &g[m * kPerMonster];
+        cout << "  " << kMonsterNames[m] << ": 체력 " << v[0] << " + lv*" << v[1]
+             << ", 공격 " << v[2] << " + lv*" << v[3]
+             << ", 방어 " << v[4] << " + lv*" << v[5] << endl;
+    }
+    const int* lv = &g[kMonsterTypes * kPerMonster];
+    cout << "  레벨업: 체력 +" << lv[0] << ", 공격력 +" << lv[1] << ", 방어력 +" << lv[2] << endl;
+}
+
+void printCurve(const Evaluation& e) {
+    cout << "  레벨  승률(목표)        평균 턴(목표)" << endl;
+    for (int level = 1; level <= kLevels; level += 3) {
+        cout << "  " << setw(4) << level << "  "
+             << fixed << setprecision(2) << e.winRate[level - 1]
+             << " (" << targetWinRate(level) << ")      "
+             << setprecision(1) << e.avgTurns[level - 1]
+             << " (" << targetTurns(level) << ")" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+int main(int argc, char* argv[]) {
+    int generations = argc > 1 ? stoi(argv[1]) : 40;
+    size_t popSize = argc > 2 ? stoul(argv[2]) : 48;
+    int fightsPerLevel = argc > 3 ? stoi(argv[3]) : 300;
+    size_t threads = max(1u, thread::hardware_concurrency());
+
+    ParallelEvaluator evaluator(fightsPerLevel, threads);
+    GeneticTuner tuner(2026, popSize);
+
+    Genome baseline = baselineGenome();
+    cout << "=== 현재 game.cpp 상수 ===" << endl;
+    printGenome(baseline);
+    const Evaluation& base = evaluator.details(baseline);
+    cout << "적합도: " << base.fitness << endl;
+    printCurve(base);
+
+    auto start = chrono::steady_clock::now();
+    vector<Genome> population = tuner.initialPopulation(baseline);
+    Genome best = baseline;
+    double bestFitness = base.fitness;
+
+    cout << "\n=== 진화 (개체 " << popSize << ", 스레드 " << threads << ") ===" << endl;
+    for (int g = 0; g < generations; ++g) {
+        vector<double> fitness = evaluator.evaluateAll(population);
+        size_t top = max_element(fitness.begin(), fitness.end()) - fitness.begin();
+        if (fitness[top] > bestFitness) {
+            bestFitness = fitness[top];
+            best = population[top];
+        }
+        if (g % 5 == 0 || g == generations - 1) {
+            cout << "세대 " << setw(3) << g << ": 최고 적합도 " << bestFitness << endl;
+        }
+        population = tuner.nextGeneration(population, fitness);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "\n=== 최적 상수 ===" << endl;
+    printGenome(best);
+    cout << "적합도: " << bestFitness << endl;
+    printCurve(evaluator.details(best));
+
+    cout << "\n평가 횟수: " << evaluator.evaluations()
+         << " | 캐시 적중: " << evaluator.cacheHits()
+         << " | 평가 속도: " << evaluator.evaluations() / max(evaluator.secondsSpent(), 1e-9)
+         << " 후보/초 (" << evaluator.evaluations() * kLevels * fightsPerLevel
+                            / max(evaluator.secondsSpent(), 1e-9) / 1e6
+         << " 백만 전투/초)" << endl;
+    cout << "전체 시간: " << seconds << " 초" << endl;
+    return 0;
+}
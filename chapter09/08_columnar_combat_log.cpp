@@ -0,0 +1,427 @@
+/*
+ * 파일명: 08_columnar_combat_log.cpp
+ *
+ * 주제: 전투 로그용 컬럼 저장소와 벡터화 집계 (Columnar Store + Vectorized Kernels)
+ * 정의: 전투 이벤트를 행(row) 단위가 아니라 열(column) 단위 배열로 저장하고,
+ *       필요한 열만 읽어 필터/그룹/집계를 청크 단위로 병렬 처리하는 분석 엔진
+ *
+ * 던지고 싶은 질문:
+ * - "던전 레벨별, 몬스터 종류별로 플레이어가 받은 평균 피해"
+ * - "체력 구간(10% 단위)별 도망 비율"
+ *
+ * 핵심 개념:
+ * - 컬럼 청크: 6만 5천 행씩 묶어 열마다 타입이 정해진 배열로 저장 (uint8/uint16/int32)
+ * - 사전 인코딩(dictionary encoding): 몬스터 이름을 uint16 코드로 바꿔 저장
+ * - 존 맵(zone map): 청크마다 열의 최솟값/최댓값 → 조건에 맞을 수 없는 청크는 통째로 건너뜀
+ * - 선택 벡터(selection vector): 분기 없이 조건을 만족하는 행 번호만 모은 뒤 집계
+ * - 밀집 그룹 배열: 그룹 키(레벨 × 몬스터)가 작으므로 해시 대신 배열 인덱스로 집계
+ * - 청크 단위 병렬: 스레드마다 부분 집계를 만들고 마지막에 합침
+ *
+ * 컴파일: g++ -std=c++17 -O3 -march=native -pthread -o combat_log 08_columnar_combat_log.cpp
+ * 실행: ./combat_log [이벤트 수(백만)]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+using namespace std;
+
+// [1] 이벤트 종류
+enum EventKind : uint8_t {
+    EV_PLAYER_HIT,     // 플레이어가 몬스터를 공격
+    EV_MONSTER_HIT,    // 몬스터가 플레이어를 공격 (damage = 플레이어가 받은 피해)
+    EV_ITEM_USE,
+    EV_FLEE,
+    EV_VICTORY,
+    EV_DEFEAT
+};
+
+// [2] 사전: 문자열 ↔ 코드
+class Dictionary {
+private:
+    unordered_map<string, uint16_t> codes;
+    vector<string> names;
+
+public:
+    uint16_t encode(const string& name) {
+        auto it = codes.find(name);
+        if (it != codes.end()) return it->second;
+        if (names.size() == UINT16_MAX) throw overflow_error("사전이 가득 찼습니다");
+        uint16_t code = static_cast<uint16_t>(names.size());
+        codes.emplace(name, code);
+        names.push_back(name);
+        return code;
+    }
+
+    const string& decode(uint16_t code) const { return names.at(code); }
+    size_t size() const { return names.size(); }
+};
+
+// [3] 존 맵
+template<typename T>
+struct ZoneMap {
+    T min = numeric_limits<T>::max();
+    T max = numeric_limits<T>::lowest();
+
+    void update(T v) {
+        if (v < min) min = v;
+        if (v > max) max = v;
+    }
+    bool mayContain(T lo, T hi) const { return !(max < lo || min > hi); }
+};
+
+// [4] 컬럼 청크
+struct ColumnChunk {
+    static constexpr size_t kRows = 1 << 16;
+
+    vector<uint16_t> level;      // 던전 레벨
+    vector<uint16_t> monster;    // 사전 코드
+    vector<uint8_t> kind;        // EventKind
+    vector<uint8_t> hpPercent;   // 이벤트 시점 플레이어 체력 비율 (0~100)
+    vector<int32_t> damage;
+
+    ZoneMap<uint16_t> levelZone;
+    ZoneMap<int32_t> damageZone;
+
+    ColumnChunk() {
+        level.reserve(kRows);
+        monster.reserve(kRows);
+        kind.reserve(kRows);
+        hpPercent.reserve(kRows);
+        damage.reserve(kRows);
+    }
+
+    size_t size() const { return kind.size(); }
+    bool full() const { return size() == kRows; }
+};
+
+class CombatLogStore {
+private:
+    vector<ColumnChunk> chunks;
+    Dictionary monsters;
+    uint16_t maxLevel = 0;
+
+public:
+    void append(uint16_t lvl, const string& monsterName, EventKind k, uint8_t hp, int32_t dmg) {
+        appendCoded(lvl, monsters.encode(monsterName), k, hp, dmg);
+    }
+
+    // 이미 인코딩된 코드로 추가 (대량 적재용)
+    void appendCoded(uint16_t lvl, uint16_t code, EventKind k, uint8_t hp, int32_t dmg) {
+        if (chunks.empty() || chunks.back().full()) chunks.emplace_back();
+        ColumnChunk& c = chunks.back();
+        c.level.push_back(lvl);
+        c.monster.push_back(code);
+        c.kind.push_back(k);
+        c.hpPercent.push_back(hp);
+        c.damage.push_back(dmg);
+        c.levelZone.update(lvl);
+        c.damageZone.update(dmg);
+        maxLevel = max(maxLevel, lvl);
+    }
+
+    Dictionary& dictionary() { return monsters; }
+    const Dictionary& dictionary() const { return monsters; }
+    const vector<ColumnChunk>& allChunks() const { return chunks; }
+    uint16_t highestLevel() const { return maxLevel; }
+
+    size_t rows() const {
+        size_t n = 0;
+        for (const auto& c : chunks) n += c.size();
+        return n;
+    }
+
+    size_t bytes() const {
+        return rows() * (sizeof(uint16_t) * 2 + sizeof(uint8_t) * 2 + sizeof(int32_t));
+    }
+};
+
+// [5] 벡터화 커널: 분기 없이 선택 벡터를 만듦
+size_t selectEquals(const uint8_t* col, size_t n, uint8_t value, uint32_t* sel) {
+    size_t k = 0;
+    for (size_t i = 0; i < n; ++i) {
+        sel[k] = static_cast<uint32_t>(i);
+        k += (col[i] == value);
+    }
+    return k;
+}
+
+size_t refineRange(const uint16_t* col, uint16_t lo, uint16_t hi, uint32_t* sel, size_t k) {
+    size_t out = 0;
+    for (size_t j = 0; j < k; ++j) {
+        uint32_t i = sel[j];
+        sel[out] = i;
+        out += (col[i] >= lo) & (col[i] <= hi);
+    }
+    return out;
+}
+
+// [6] 병렬 청크 스캔: 스레드마다 부분 결과를 만들고 순서대로 합침
+template<typename Partial, typename ScanFn, typename MergeFn>
+Partial parallelScan(const CombatLogStore& store, size_t threads, Partial init,
+                     ScanFn scan, MergeFn merge) {
+    const auto& chunks = store.allChunks();
+    vector<Partial> partials(threads, init);
+    atomic<size_t> next{0};
+
+    auto worker = [&](size_t id) {
+        vector<uint32_t> sel(ColumnChunk::kRows);
+        size_t c;
+        while ((c = next.fetch_add(1, memory_order_relaxed)) < chunks.size()) {
+            scan(chunks[c], sel.data(), partials[id]);
+        }
+    };
+
+    vector<thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker, t);
+    worker(0);
+    for (auto& t : pool) t.join();
+
+    Partial result = init;
+    for (auto& p : partials) merge(result, p);
+    return result;
+}
+
+// 질의 1: 레벨 × 몬스터별 평균 받은 피해
+struct DamageByGroup {
+    vector<int64_t> sum;
+    vector<int64_t> count;
+};
+
+DamageByGroup averageDamageTaken(const CombatLogStore& store, size_t threads) {
+    size_t monsters = store.dictionary().size();
+    size_t groups = (store.highestLevel() + 1) * monsters;
+    DamageByGroup init{vector<int64_t>(groups, 0), vector<int64_t>(groups, 0)};
+
+    return parallelScan(store, threads, init,
+        [monsters](const ColumnChunk& c, uint32_t* sel, DamageByGroup& acc) {
+            size_t k = selectEquals(c.kind.data(), c.size(), EV_MONSTER_HIT, sel);
+            const uint16_t* lvl = c.level.data();
+            const uint16_t* mon = c.monster.data();
+            const int32_t* dmg = c.damage.data();
+            for (size_t j = 0; j < k; ++j) {
+                uint32_t i = sel[j];
+                size_t g = lvl[i] * monsters + mon[i];
+                acc.sum[g] += dmg[i];
+                acc.count[g] += 1;
+            }
+        },
+        [](DamageByGroup& into, const DamageByGroup& from) {
+            for (size_t g = 0; g < into.sum.size(); ++g) {
+                into.sum[g] += from.sum[g];
+                into.count[g] += from.count[g];
+            }
+        });
+}
+
+// 질의 2: 체력 구간별 도망 비율 (플레이어 행동 중 도망의 비율)
+struct FleeByBucket {
+    array<int64_t, 11> actions{};
+    array<int64_t, 11> flees{};
+};
+
+FleeByBucket fleeRateByHp(const CombatLogStore& store, size_t threads) {
+    return parallelScan(store, threads, FleeByBucket{},
+        [](const ColumnChunk& c, uint32_t*, FleeByBucket& acc) {
+            const uint8_t* kind = c.kind.data();
+            const uint8_t* hp = c.hpPercent.data();
+            // 열 두 개만 순차적으로 읽음: 분기 없는 누적
+            int64_t actions[11] = {}, flees[11] = {};
+            for (size_t i = 0; i < c.size(); ++i) {
+                unsigned b = hp[i] / 10u;
+                uint8_t k = kind[i];
+                actions[b] += (k == EV_PLAYER_HIT) | (k == EV_ITEM_USE) | (k == EV_FLEE);
+                flees[b] += (k == EV_FLEE);
+            }
+            for (int b = 0; b < 11; ++b) {
+                acc.actions[b] += actions[b];
+                acc.flees[b] += flees[b];
+            }
+        },
+        [](FleeByBucket& into, const FleeByBucket& from) {
+            for (int b = 0; b < 11; ++b) {
+                into.actions[b] += from.actions[b];
+                into.flees[b] += from.flees[b];
+            }
+        });
+}
+
+// 질의 3: 존 맵 활용 — 레벨 lo~hi 에서 100 이상의 큰 피해 횟수
+struct BigHits {
+    int64_t count = 0;
+    int64_t chunksSkipped = 0;
+};
+
+BigHits countBigHits(const CombatLogStore& store, size_t threads, uint16_t lo, uint16_t hi) {
+    return parallelScan(store, threads, BigHits{},
+        [lo, hi](const ColumnChunk& c, uint32_t* sel, BigHits& acc) {
+            if (!c.levelZone.mayContain(lo, hi) || c.damageZone.max < 100) {
+                ++acc.chunksSkipped;      // 청크 전체를 읽지 않고 건너뜀
+                return;
+            }
+            size_t k = selectEquals(c.kind.data(), c.size(), EV_MONSTER_HIT, sel);
+            k = refineRange(c.level.data(), lo, hi, sel, k);
+            for (size_t j = 0; j < k; ++j) acc.count += (c.damage[sel[j]] >= 100);
+        },
+        [](BigHits& into, const BigHits& from) {
+            into.count += from.count;
+            into.chunksSkipped += from.chunksSkipped;
+        });
+}
+
+// [7] 비교용 행 저장소 (vector<struct>)
+struct RowEvent {
+    uint16_t level;
+    string monster;
+    EventKind kind;
+    uint8_t hpPercent;
+    int32_t damage;
+};
+
+// [8] 합성 전투 로그 생성: 던전을 내려가며 전투를 반복 (레벨 순서대로 기록 → 존 맵이 효과적)
+void generateLog(CombatLogStore& store, vector<RowEvent>* rows, size_t target) {
+    const char* names[] = {"슬라임", "고블린", "오크", "드래곤"};
+    uint16_t codes[4];
+    for (int m = 0; m < 4; ++m) codes[m] = store.dictionary().encode(names[m]);
+
+    mt19937 gen(7);
+    size_t produced = 0;
+    const size_t perLevel = max<size_t>(1, target / 100);
+
+    auto emit = [&](uint16_t lvl, int m, EventKind k, int hp, int dmg) {
+        store.appendCoded(lvl, codes[m], k, static_cast<uint8_t>(hp), dmg);
+        if (rows) rows->push_back({lvl, names[m], k, static_cast<uint8_t>(hp), dmg});
+        ++produced;
+    };
+
+    while (produced < target) {
+        uint16_t lvl = static_cast<uint16_t>(1 + min<size_t>(99, produced / perLevel));
+        int m = static_cast<int>(gen() % 4);
+        int playerMax = 100 + lvl * 20, playerHp = playerMax;
+        int monsterHp = (30 + m * 40) + lvl * (10 + m * 7);
+        int monsterAtt = 8 + m * 6 + lvl * (2 + m);
+        int playerAtt = 20 + lvl * 5, playerDef = 5 + lvl * 2;
+
+        while (produced < target) {
+            int hpPct = playerHp * 100 / playerMax;
+            uint32_t roll = gen() % 100;
+            if (hpPct < 25 && roll < 30) { emit(lvl, m, EV_FLEE, hpPct, 0); break; }
+            if (hpPct < 50 && roll < 20) {
+                emit(lvl, m, EV_ITEM_USE, hpPct, 0);
+                playerHp = min(playerMax, playerHp + 30);
+            } else {
+                int dmg = max(1, playerAtt - 5 + static_cast<int>(gen() % 11));
+                monsterHp -= dmg;
+                emit(lvl, m, EV_PLAYER_HIT, hpPct, dmg);
+                if (monsterHp <= 0) { emit(lvl, m, EV_VICTORY, hpPct, 0); break; }
+            }
+            int taken = max(1, monsterAtt - 3 + static_cast<int>(gen() % 7) - playerDef);
+            playerHp -= taken;
+            emit(lvl, m, EV_MONSTER_HIT, max(0, playerHp) * 100 / playerMax, taken);
+            if (playerHp <= 0) { emit(lvl, m, EV_DEFEAT, 0, 0); break; }
+        }
+    }
+}
+
+double msSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+}
+
+int main(int argc, char* argv[]) {
+    size_t millions = argc > 1 ? stoul(argv[1]) : 20;
+    size_t target = millions * 1000000;
+    size_t threads = max(1u, thread::hardware_concurrency());
+
+    CombatLogStore store;
+    vector<RowEvent> rows;
+    const size_t rowCompare = min<size_t>(target, 2000000);   // 행 저장소는 메모리가 커서 일부만
+
+    auto t0 = chrono::steady_clock::now();
+    generateLog(store, nullptr, target);
+    cout << "=== 컬럼형 전투 로그 ===" << endl;
+    cout << "이벤트: " << store.rows() << " | 청크: " << store.allChunks().size()
+         << " | 메모리: " << store.bytes() / (1024 * 1024) << " MB"
+         << " | 적재: " << msSince(t0) << " ms | 스레드: " << threads << endl;
+
+    // 질의 1
+    auto q1 = chrono::steady_clock::now();
+    DamageByGroup dmg = averageDamageTaken(store, threads);
+    double q1ms = msSince(q1);
+    cout << "\n[질의 1] 레벨 × 몬스터별 평균 받은 피해 (" << q1ms << " ms, "
+         << store.rows() / q1ms / 1000.0 << " 백만 행/초)" << endl;
+    const Dictionary& dict = store.dictionary();
+    for (uint16_t lvl : {1, 25, 50, 100}) {
+        if (lvl > store.highestLevel()) continue;
+        cout << "  레벨 " << setw(3) << lvl << ": ";
+        for (uint16_t m = 0; m < dict.size(); ++m) {
+            size_t g = lvl * dict.size() + m;
+            if (dmg.count[g] == 0) continue;
+            cout << dict.decode(m) << " " << fixed << setprecision(1)
+                 << double(dmg.sum[g]) / dmg.count[g] << "  ";
+        }
+        cout << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+
+    // 질의 2
+    auto q2 = chrono::steady_clock::now();
+    FleeByBucket flee = fleeRateByHp(store, threads);
+    cout << "\n[질의 2] 체력 구간별 도망 비율 (" << msSince(q2) << " ms)" << endl;
+    for (int b = 0; b <= 10; ++b) {
+        if (flee.actions[b] == 0) continue;
+        cout << "  체력 " << setw(3) << b * 10 << "%대: " << fixed << setprecision(2)
+             << 100.0 * flee.flees[b] / flee.actions[b] << "%" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+
+    // 질의 3
+    auto q3 = chrono::steady_clock::now();
+    BigHits big = countBigHits(store, threads, 40, 45);
+    cout << "\n[질의 3] 레벨 40~45, 100 이상의 피해: " << big.count << "회 ("
+         << msSince(q3) << " ms, 존 맵으로 건너뛴 청크 " << big.chunksSkipped
+         << "/" << store.allChunks().size() << ")" << endl;
+
+    // 행 저장소와 비교 (같은 질의 1, 같은 데이터 일부)
+    CombatLogStore small;
+    generateLog(small, &rows, rowCompare);
+    auto r0 = chrono::steady_clock::now();
+    unordered_map<string, int64_t> rowSum, rowCount;
+    for (const auto& e : rows) {
+        if (e.kind != EV_MONSTER_HIT) continue;
+        string key = to_string(e.level) + "/" + e.monster;
+        rowSum[key] += e.damage;
+        rowCount[key] += 1;
+    }
+    double rowMs = msSince(r0);
+    auto c0 = chrono::steady_clock::now();
+    DamageByGroup smallDmg = averageDamageTaken(small, 1);
+    double colMs = msSince(c0);
+    cout << "\n=== 행 저장소 비교 (" << rows.size() << "행, 단일 스레드) ===" << endl;
+    cout << "행 저장소 + 해시 그룹: " << rowMs << " ms" << endl;
+    cout << "컬럼 저장소 + 밀집 그룹: " << colMs << " ms ("
+         << rowMs / max(colMs, 1e-6) << "배)" << endl;
+
+    bool match = true;
+    for (const auto& [key, sum] : rowSum) {
+        size_t slash = key.find('/');
+        uint16_t lvl = static_cast<uint16_t>(stoi(key.substr(0, slash)));
+        uint16_t code = small.dictionary().encode(key.substr(slash + 1));
+        size_t g = lvl * small.dictionary().size() + code;
+        match = match && smallDmg.sum[g] == sum && smallDmg.count[g] == rowCount[key];
+    }
+    cout << "결과 일치: " << (match ? "예" : "아니오") << endl;
+    return match ? 0 : 1;
+}
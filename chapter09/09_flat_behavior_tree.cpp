@@ -0,0 +1,455 @@
+/*
+ * 파일명: 09_flat_behavior_tree.cpp
+ *
+ * 주제: 평탄화된 행동 트리로 만든 몬스터 AI (Flat Behavior Tree)
+ * 정의: 행동 트리를 포인터로 연결된 노드 객체가 아니라 전위 순회 순서의 배열로 컴파일하여,
+ *       가상 함수 호출과 동적 할당 없이 수많은 몬스터의 AI 를 평가하는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 몬스터 턴은 monster.calculateDamage() 로 공격만 함
+ *
+ * 핵심 개념:
+ * - 행동 트리: 선택(Selector, 하나라도 성공하면 성공), 순서(Sequence, 모두 성공해야 성공),
+ *   조건(Condition), 행동(Action) 노드의 조합
+ * - 평탄화: 노드를 전위 순회 순서로 배열에 저장, 각 노드에 "서브트리 끝" 인덱스를 기록
+ *   → 첫 자식 = 자기 인덱스 + 1, 다음 형제 = 자식의 끝 인덱스
+ * - 8바이트 노드: 한 캐시 라인에 8개 노드 → 트리 전체가 L1 캐시에 들어감
+ * - 재귀 대신 고정 크기 스택으로 순회 → 함수 호출 없이 한 루프 안에서 평가
+ *   스택 크기를 넘는 중첩, 빈 복합 노드, int16 밖의 인자는 트리 로드 시점에 거부
+ * - 몬스터 상태는 배열 구조체(SoA)로 저장하여 순차 접근
+ * - 비교 대상: 노드마다 virtual tick() 을 가진 전통적인 객체 트리
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o behavior_tree 09_flat_behavior_tree.cpp
+ * 실행: ./behavior_tree [몬스터 수] [틱 수]
+ */
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+using namespace std;
+
+// [1] 몬스터 상태 (배열 구조체)
+struct MonsterStates {
+    vector<int> health;
+    vector<int> maxHealth;
+    vector<int> attack;
+    vector<uint8_t> enraged;
+    vector<uint8_t> healCharges;
+    vector<uint8_t> fleeing;
+    vector<uint8_t> alliesCalled;
+    vector<int> damageDealt;      // 이번 틱에 플레이어에게 준 피해
+
+    explicit MonsterStates(size_t n)
+        : health(n), maxHealth(n), attack(n), enraged(n), healCharges(n),
+          fleeing(n), alliesCalled(n), damageDealt(n) {}
+
+    size_t size() const { return health.size(); }
+};
+
+// [2] 노드 종류와 8바이트 노드
+enum NodeType : uint8_t {
+    BT_SELECTOR,
+    BT_SEQUENCE,
+    BT_HP_BELOW,         // 조건: 체력 < param%
+    BT_NOT_ENRAGED,      // 조건: 아직 광폭화하지 않음
+    BT_HAS_HEAL,         // 조건: 회복 횟수 남음
+    BT_NOT_CALLED,       // 조건: 아직 동료를 부르지 않음
+    BT_ATTACK,           // 행동: 공격 (광폭화 시 param% 추가)
+    BT_ENRAGE,           // 행동: 광폭화 (공격력 +param)
+    BT_HEAL,             // 행동: 최대 체력의 param% 회복
+    BT_FLEE,             // 행동: 도망
+    BT_CALL_ALLIES       // 행동: 동료 호출
+};
+
+struct FlatNode {
+    uint8_t type;
+    uint8_t pad;
+    int16_t param;
+    uint16_t end;        // 이 노드 서브트리의 다음 인덱스
+    uint16_t reserved;
+};
+static_assert(sizeof(FlatNode) == 8, "노드는 8바이트");
+
+// [3] 트리 작성용 중간 표현 (로드 시점에만 사용)
+struct TreeSpec {
+    NodeType type;
+    int param;
+    vector<TreeSpec> children;
+};
+
+TreeSpec selector(initializer_list<TreeSpec> c) { return {BT_SELECTOR, 0, c}; }
+TreeSpec sequence(initializer_list<TreeSpec> c) { return {BT_SEQUENCE, 0, c}; }
+TreeSpec leaf(NodeType t, int param = 0) { return {t, param, {}}; }
+
+// 평가기의 고정 스택 크기 = 허용하는 복합 노드 중첩 깊이 (FlatTree 가 로드 시점에 검사)
+constexpr int kMaxDepth = 16;
+
+class FlatTree {
+private:
+    vector<FlatNode> nodes;
+
+public:
+    explicit FlatTree(const TreeSpec& root) {
+        emit(root, 0);
+        if (nodes.size() > UINT16_MAX) throw length_error("트리가 너무 큽니다");
+    }
+
+    const FlatNode* data() const { return nodes.data(); }
+    size_t size() const { return nodes.size(); }
+
+private:
+    // depth = 이 노드 위에 있는 복합 노드 수 (평가기 스택에 쌓일 개수)
+    void emit(const TreeSpec& spec, int depth) {
+        bool composite = spec.type == BT_SELECTOR || spec.type == BT_SEQUENCE;
+        if (composite) {
+            // 빈 복합 노드는 평가기가 다음 형제(또는 배열 끝)를 자식으로 착각함
+            if (spec.children.empty()) throw invalid_argument("자식이 없는 선택/순서 노드");
+            if (depth >= kMaxDepth) throw length_error("복합 노드 중첩이 " + to_string(kMaxDepth) + "단계를 넘습니다");
+        } else if (!spec.children.empty()) {
+            throw invalid_argument("조건/행동 노드는 자식을 가질 수 없습니다");
+        }
+        if (spec.param < INT16_MIN || spec.param > INT16_MAX) {
+            throw out_of_range("노드 인자가 int16 범위를 벗어남: " + to_string(spec.param));
+        }
+        if (nodes.size() >= UINT16_MAX) throw length_error("트리가 너무 큽니다");
+
+        size_t index = nodes.size();
+        nodes.push_back({static_cast<uint8_t>(spec.type), 0, static_cast<int16_t>(spec.param), 0, 0});
+        for (const auto& child : spec.children) emit(child, depth + (composite ? 1 : 0));
+        nodes[index].end = static_cast<uint16_t>(nodes.size());
+    }
+};
+
+// [4] 평가기: 재귀 없이 작은 고정 스택으로 순회, 노드 종류는 switch 로 분기
+// 복합 노드의 결과 = 마지막으로 평가한 자식의 결과 (선택은 성공에서, 순서는 실패에서 중단)
+class BehaviorEvaluator {
+private:
+    const FlatNode* nodes;
+    // vector 대신 원시 포인터를 보관 → 루프마다 vector 내부 포인터를 다시 읽지 않음
+    int* health;
+    const int* maxHealth;
+    int* attack;
+    uint8_t* enraged;
+    uint8_t* healCharges;
+    uint8_t* fleeing;
+    uint8_t* alliesCalled;
+    int* damageDealt;
+    int playerDefense;
+
+public:
+    BehaviorEvaluator(const FlatTree& tree, MonsterStates& s, int defense)
+        : nodes(tree.data()), health(s.health.data()), maxHealth(s.maxHealth.data()),
+          attack(s.attack.data()), enraged(s.enraged.data()), healCharges(s.healCharges.data()),
+          fleeing(s.fleeing.data()), alliesCalled(s.alliesCalled.data()),
+          damageDealt(s.damageDealt.data()), playerDefense(defense) {}
+
+    bool tickRoot(size_t m) {
+        uint16_t stack[kMaxDepth];     // FlatTree 가 중첩 깊이 <= kMaxDepth 를 보장
+        int sp = 0;
+        uint16_t i = 0;
+
+        for (;;) {
+            const FlatNode& n = nodes[i];
+            if (n.type == BT_SELECTOR || n.type == BT_SEQUENCE) {
+                stack[sp++] = i;          // 복합 노드 진입 → 첫 자식으로
+                ++i;
+                continue;
+            }
+
+            bool result = leaf(n, m);
+
+            // 결과를 부모 쪽으로 전달: 중단 조건이거나 마지막 자식이면 부모도 끝남
+            uint16_t next = n.end;
+            while (sp > 0) {
+                const FlatNode& parent = nodes[stack[sp - 1]];
+                bool stop = parent.type == BT_SELECTOR ? result : !result;
+                if (!stop && next < parent.end) break;
+                next = parent.end;
+                --sp;
+            }
+            if (sp == 0) return result;
+            i = next;                     // 다음 형제
+        }
+    }
+
+private:
+    bool leaf(const FlatNode& n, size_t m) {
+        switch (n.type) {
+            case BT_HP_BELOW:
+                return health[m] * 100 < maxHealth[m] * n.param;
+            case BT_NOT_ENRAGED:
+                return !enraged[m];
+            case BT_HAS_HEAL:
+                return healCharges[m] > 0;
+            case BT_NOT_CALLED:
+                return !alliesCalled[m];
+            case BT_ATTACK: {
+                int damage = attack[m];
+                if (enraged[m]) damage += damage * n.param / 100;
+                damageDealt[m] = max(1, damage - playerDefense);
+                return true;
+            }
+            case BT_ENRAGE:
+                enraged[m] = 1;
+                attack[m] += n.param;
+                return true;
+            case BT_HEAL:
+                health[m] = min(maxHealth[m], health[m] + maxHealth[m] * n.param / 100);
+                --healCharges[m];
+                return true;
+            case BT_FLEE:
+                fleeing[m] = 1;
+                return true;
+            case BT_CALL_ALLIES:
+                alliesCalled[m] = 1;
+                return true;
+        }
+        return false;
+    }
+};
+
+// [5] 비교용: 가상 함수 기반 객체 트리
+class Node {
+public:
+    virtual ~Node() = default;
+    virtual bool tick(MonsterStates& s, size_t m, int playerDefense) = 0;
+};
+
+class CompositeNode : public Node {
+protected:
+    vector<unique_ptr<Node>> children;
+public:
+    void add(unique_ptr<Node> c) { children.push_back(move(c)); }
+};
+
+class SelectorNode : public CompositeNode {
+public:
+    bool tick(MonsterStates& s, size_t m, int d) override {
+        for (auto& c : children) if (c->tick(s, m, d)) return true;
+        return false;
+    }
+};
+
+class SequenceNode : public CompositeNode {
+public:
+    bool tick(MonsterStates& s, size_t m, int d) override {
+        for (auto& c : children) if (!c->tick(s, m, d)) return false;
+        return true;
+    }
+};
+
+class LeafNode : public Node {
+    NodeType type;
+    int param;
+public:
+    LeafNode(NodeType t, int p) : type(t), param(p) {}
+    bool tick(MonsterStates& s, size_t m, int d) override {
+        switch (type) {
+            case BT_HP_BELOW:    return s.health[m] * 100 < s.maxHealth[m] * param;
+            case BT_NOT_ENRAGED: return !s.enraged[m];
+            case BT_HAS_HEAL:    return s.healCharges[m] > 0;
+            case BT_NOT_CALLED:  return !s.alliesCalled[m];
+            case BT_ATTACK: {
+                int damage = s.attack[m];
+                if (s.enraged[m]) damage += damage * param / 100;
+                s.damageDealt[m] = max(1, damage - d);
+                return true;
+            }
+            case BT_ENRAGE:  s.enraged[m] = 1; s.attack[m] += param; return true;
+            case BT_HEAL:
+                s.health[m] = min(s.maxHealth[m], s.health[m] + s.maxHealth[m] * param / 100);
+                --s.healCharges[m];
+                return true;
+            case BT_FLEE:        s.fleeing[m] = 1; return true;
+            case BT_CALL_ALLIES: s.alliesCalled[m] = 1; return true;
+            default:             return false;
+        }
+    }
+};
+
+unique_ptr<Node> buildObjectTree(const TreeSpec& spec) {
+    if (spec.type == BT_SELECTOR || spec.type == BT_SEQUENCE) {
+        unique_ptr<CompositeNode> node;
+        if (spec.type == BT_SELECTOR) node = make_unique<SelectorNode>();
+        else node = make_unique<SequenceNode>();
+        for (const auto& c : spec.children) node->add(buildObjectTree(c));
+        return node;
+    }
+    return make_unique<LeafNode>(spec.type, spec.param);
+}
+
+// [6] 몬스터 종류별 AI 정의
+TreeSpec goblinAI() {
+    // 체력 20% 미만이면 도망, 50% 미만이고 동료를 안 불렀으면 호출, 아니면 공격
+    return selector({
+        sequence({leaf(BT_HP_BELOW, 20), leaf(BT_FLEE)}),
+        sequence({leaf(BT_HP_BELOW, 50), leaf(BT_NOT_CALLED), leaf(BT_CALL_ALLIES)}),
+        leaf(BT_ATTACK, 0)
+    });
+}
+
+TreeSpec dragonAI() {
+    // 체력 30% 미만: 회복 가능하면 회복, 아니면 광폭화 / 평소에는 공격 (광폭화 시 +50%)
+    return selector({
+        sequence({leaf(BT_HP_BELOW, 30), leaf(BT_HAS_HEAL), leaf(BT_HEAL, 25)}),
+        sequence({leaf(BT_HP_BELOW, 30), leaf(BT_NOT_ENRAGED), leaf(BT_ENRAGE, 10)}),
+        leaf(BT_ATTACK, 50)
+    });
+}
+
+void resetStates(MonsterStates& s, uint32_t seed) {
+    mt19937 gen(seed);
+    for (size_t m = 0; m < s.size(); ++m) {
+        s.maxHealth[m] = 100 + static_cast<int>(gen() % 200);
+        s.health[m] = 1 + static_cast<int>(gen() % s.maxHealth[m]);
+        s.attack[m] = 10 + static_cast<int>(gen() % 30);
+        s.enraged[m] = 0;
+        s.healCharges[m] = static_cast<uint8_t>(gen() % 3);
+        s.fleeing[m] = 0;
+        s.alliesCalled[m] = 0;
+        s.damageDealt[m] = 0;
+    }
+}
+
+// 틱 사이에 플레이어의 공격을 흉내 내어 체력을 조금씩 깎음
+void playerAttacks(MonsterStates& s, int tick) {
+    for (size_t m = 0; m < s.size(); ++m) {
+        s.health[m] = max(1, s.health[m] - ((static_cast<int>(m) + tick) % 13));
+    }
+}
+
+uint64_t stateChecksum(const MonsterStates& s) {
+    uint64_t h = 0;
+    for (size_t m = 0; m < s.size(); ++m) {
+        h = h * 1099511628211ULL + static_cast<uint64_t>(s.health[m] * 7 + s.attack[m] * 3
+              + s.enraged[m] + s.healCharges[m] * 5 + s.fleeing[m] * 11 + s.alliesCalled[m] * 13
+              + s.damageDealt[m] * 17);
+    }
+    return h;
+}
+
+const char* describe(const MonsterStates& s, size_t m) {
+    if (s.fleeing[m]) return "도망";
+    if (s.damageDealt[m]) return s.enraged[m] ? "광폭 공격" : "공격";
+    if (s.alliesCalled[m]) return "동료 호출";
+    if (s.enraged[m]) return "광폭화";
+    return "회복";
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc > 1 ? stoul(argv[1]) : 1000000;
+    int ticks = argc > 2 ? stoi(argv[2]) : 10;
+    const int playerDefense = 7;
+
+    FlatTree goblin(goblinAI());
+    FlatTree dragon(dragonAI());
+    cout << "=== 평탄화 행동 트리 ===" << endl;
+    cout << "고블린 AI: 노드 " << goblin.size() << "개 (" << goblin.size() * sizeof(FlatNode) << " 바이트)" << endl;
+    cout << "드래곤 AI: 노드 " << dragon.size() << "개 (" << dragon.size() * sizeof(FlatNode) << " 바이트)" << endl;
+
+    // 로드 시점 검사: 평가기 스택을 넘는 중첩, 빈 복합 노드, int16 밖의 인자는 트리로 만들지 않음
+    auto nested = [](int depth) {
+        TreeSpec spec = leaf(BT_ATTACK);
+        for (int d = 0; d < depth; ++d) spec = TreeSpec{d % 2 ? BT_SELECTOR : BT_SEQUENCE, 0, {spec}};
+        return spec;
+    };
+    bool validated = true;
+    {
+        FlatTree deepest(nested(kMaxDepth));        // 허용 한계: 스택을 꽉 채워 평가
+        MonsterStates one(1);
+        resetStates(one, 1);
+        BehaviorEvaluator(deepest, one, playerDefense).tickRoot(0);
+        validated = one.damageDealt[0] > 0;
+    }
+    const pair<const char*, TreeSpec> invalid[] = {
+        {"중첩 17단계", nested(kMaxDepth + 1)},
+        {"빈 선택 노드", selector({})},
+        {"마지막 자식이 빈 순서 노드", selector({leaf(BT_ATTACK), sequence({})})},
+        {"자식이 있는 행동 노드", TreeSpec{BT_ATTACK, 0, {leaf(BT_FLEE)}}},
+        {"인자 40000", leaf(BT_HP_BELOW, 40000)},
+    };
+    for (const auto& [label, spec] : invalid) {
+        try {
+            FlatTree bad(spec);
+            cout << "거부되지 않은 트리: " << label << endl;
+            validated = false;
+        } catch (const exception& e) {
+            cout << "거부: " << label << " → " << e.what() << endl;
+        }
+    }
+
+    // 전투 한 장면: 몬스터 턴에서 calculateDamage 대신 AI 가 행동 결정
+    {
+        MonsterStates one(1);
+        one.maxHealth[0] = 180;
+        one.health[0] = 180;
+        one.attack[0] = 30;
+        one.healCharges[0] = 1;
+        BehaviorEvaluator ai(dragon, one, playerDefense);
+        cout << "\n--- 드래곤 전투 ---" << endl;
+        for (int turn = 1; turn <= 6; ++turn) {
+            one.health[0] = max(1, one.health[0] - 45);      // 플레이어의 공격
+            one.damageDealt[0] = 0;
+            ai.tickRoot(0);
+            cout << "턴 " << turn << ": 체력 " << one.health[0] << "/" << one.maxHealth[0]
+                 << " → " << describe(one, 0);
+            if (one.damageDealt[0]) cout << " (" << one.damageDealt[0] << " 피해)";
+            cout << endl;
+        }
+    }
+
+    // 벤치마크: 절반은 고블린, 절반은 드래곤
+    MonsterStates flat(count), object(count);
+    resetStates(flat, 1);
+    resetStates(object, 1);
+    size_t half = count / 2;
+
+    BehaviorEvaluator goblinEval(goblin, flat, playerDefense);
+    BehaviorEvaluator dragonEval(dragon, flat, playerDefense);
+    auto t0 = chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        playerAttacks(flat, t);
+        for (size_t m = 0; m < half; ++m) goblinEval.tickRoot(m);
+        for (size_t m = half; m < count; ++m) dragonEval.tickRoot(m);
+    }
+    auto t1 = chrono::steady_clock::now();
+
+    auto goblinObj = buildObjectTree(goblinAI());
+    auto dragonObj = buildObjectTree(dragonAI());
+    auto t2 = chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        playerAttacks(object, t);
+        for (size_t m = 0; m < half; ++m) goblinObj->tick(object, m, playerDefense);
+        for (size_t m = half; m < count; ++m) dragonObj->tick(object, m, playerDefense);
+    }
+    auto t3 = chrono::steady_clock::now();
+
+    // 플레이어 공격 시뮬레이션 비용은 양쪽에 같으므로 따로 측정해서 뺌
+    MonsterStates scratch(count);
+    resetStates(scratch, 1);
+    auto t4 = chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) playerAttacks(scratch, t);
+    auto t5 = chrono::steady_clock::now();
+
+    double base = chrono::duration<double>(t5 - t4).count();
+    double flatSec = chrono::duration<double>(t1 - t0).count() - base;
+    double objSec = chrono::duration<double>(t3 - t2).count() - base;
+    double total = double(count) * ticks;
+
+    cout << "\n=== AI 틱 벤치마크 (몬스터 " << count << ", 틱 " << ticks << ") ===" << endl;
+    cout << "평탄화 트리:   " << total / flatSec / 1e6 << " 백만 AI 틱/초 ("
+         << flatSec / ticks * 1000 << " ms/프레임)" << endl;
+    cout << "가상 함수 트리: " << total / objSec / 1e6 << " 백만 AI 틱/초 ("
+         << objSec / ticks * 1000 << " ms/프레임)" << endl;
+
+    bool same = stateChecksum(flat) == stateChecksum(object);
+    cout << "두 구현의 결과 일치: " << (same ? "예" : "아니오") << endl;
+    return same && validated ? 0 : 1;
+}
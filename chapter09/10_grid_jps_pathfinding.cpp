@@ -0,0 +1,824 @@
+/*
+ * 파일명: 10_grid_jps_pathfinding.cpp
+ *
+ * 주제: 격자 던전 지도와 A* / 점프 포인트 탐색 (Grid Map + A* / Jump Point Search)
+ * 정의: 던전 층을 최대 4096×4096 타일 지도로 표현하고, 이동 가능 여부를 비트셋으로 압축한 뒤
+ *       A* 와 점프 포인트 탐색(JPS)으로 경로를 찾고, 구역 쌍 단위로 경로를 캐시하는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 던전은 정수 Game::dungeon_level 하나뿐, 공간 개념이 없음
+ *
+ * 핵심 개념:
+ * - 비트셋 지도: 타일 하나를 1비트로 저장 → 4096×4096 지도가 2MB
+ * - A*: f = g(지금까지 비용) + h(남은 거리 추정) 가 작은 노드부터 확장
+ *   8방향 이동, 직선 10 / 대각선 14, 대각선은 양옆이 모두 열려 있을 때만 허용(모서리 통과 금지)
+ * - JPS: 대칭인 경로를 건너뛰고 "강제 이웃"이 생기는 점프 포인트만 열린 목록에 넣음
+ *   모서리 통과 금지 규칙: 직선 이동 중 옆 칸이 열려 있고 그 뒤 칸이 막혔을 때만 옆으로 갈라짐
+ *   → 넓은 공간에서 확장 노드 수가 크게 줄어듦 (결과 비용은 A* 와 동일, 실행 때 매번 검사)
+ * - 직선 점프는 행/열(전치) 비트셋에서 64칸씩 꺼내 벽과 강제 이웃을 비트 연산으로 한 번에 찾음
+ * - 작업 공간: 칸마다 배열 대신 8×8 칸 페이지를 해시 디렉터리로 관리 → 스레드당 메모리가
+ *   지도 크기가 아니라 질의가 건드린 넓이에 비례, 세대 번호로 질의마다 지우지 않고 재사용
+ * - 경로 캐시: (출발 구역, 도착 구역) → 경유점 목록. 새 출발/도착점을 캐시된 경로의 양 끝에
+ *   직선 또는 짧은(확장 수 제한) JPS 로 이어 재사용 (최적은 아닐 수 있지만 항상 유효한 경로)
+ * - 캐시는 여러 조각(shard)으로 나누고 조각마다 shared_mutex → 여러 스레드가 동시에 질의
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o pathfinding 10_grid_jps_pathfinding.cpp
+ * 실행: ./pathfinding [큰 지도 크기(기본 4096)] [긴 질의 수] [스레드 수]
+ *       512 지도와 큰 지도에서 각각 동굴/미로를 측정, JPS 비용이 A* 와 다르면 종료 코드 1
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <queue>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+using namespace std;
+
+// [1] 비트셋 격자 지도
+class GridMap {
+private:
+    int width;
+    int height;
+    vector<uint64_t> bits;      // 1 = 이동 가능
+
+public:
+    GridMap(int w, int h) : width(w), height(h), bits((size_t(w) * h + 63) / 64, 0) {
+        if (w <= 0 || h <= 0 || w > 4096 || h > 4096) {
+            throw invalid_argument("지도 크기는 1~4096 이어야 합니다");
+        }
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t cells() const { return size_t(width) * height; }
+    size_t bytes() const { return bits.size() * sizeof(uint64_t); }
+
+    uint32_t index(int x, int y) const { return static_cast<uint32_t>(y) * width + x; }
+
+    bool walkable(int x, int y) const {
+        if (x < 0 || y < 0 || x >= width || y >= height) return false;
+        uint32_t i = index(x, y);
+        return (bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void set(int x, int y, bool open) {
+        uint32_t i = index(x, y);
+        if (open) bits[i >> 6] |= 1ULL << (i & 63);
+        else bits[i >> 6] &= ~(1ULL << (i & 63));
+    }
+};
+
+struct Point {
+    int x, y;
+    bool operator==(const Point& o) const { return x == o.x && y == o.y; }
+};
+
+// [2] 지도 생성기
+// 미로: 홀수 좌표 칸을 반복형 깊이 우선 탐색으로 연결
+GridMap generateMaze(int size, uint32_t seed) {
+    GridMap map(size, size);
+    mt19937 gen(seed);
+    int cellsW = (size - 1) / 2, cellsH = (size - 1) / 2;
+    vector<uint8_t> visited(size_t(cellsW) * cellsH, 0);
+    vector<pair<int, int>> stack{{0, 0}};
+    visited[0] = 1;
+    map.set(1, 1, true);
+
+    const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+    while (!stack.empty()) {
+        auto [cx, cy] = stack.back();
+        int options[4], n = 0;
+        for (int d = 0; d < 4; ++d) {
+            int nx = cx + dx[d], ny = cy + dy[d];
+            if (nx >= 0 && ny >= 0 && nx < cellsW && ny < cellsH && !visited[size_t(ny) * cellsW + nx]) {
+                options[n++] = d;
+            }
+        }
+        if (n == 0) { stack.pop_back(); continue; }
+        int d = options[gen() % n];
+        int nx = cx + dx[d], ny = cy + dy[d];
+        visited[size_t(ny) * cellsW + nx] = 1;
+        map.set(2 * cx + 1 + dx[d], 2 * cy + 1 + dy[d], true);   // 사이 벽 제거
+        map.set(2 * nx + 1, 2 * ny + 1, true);
+        stack.push_back({nx, ny});
+    }
+    // 벽 일부를 허물어 순환 경로를 만듦 (완전 미로는 경로가 하나뿐이라 너무 단조로움)
+    for (size_t k = 0; k < map.cells() / 50; ++k) {
+        map.set(1 + int(gen() % (size - 2)), 1 + int(gen() % (size - 2)), true);
+    }
+    return map;
+}
+
+// 동굴: 무작위로 채운 뒤 셀룰러 오토마타 4회 (주변 벽이 5개 이상이면 벽)
+GridMap generateCave(int size, uint32_t seed) {
+    mt19937 gen(seed);
+    vector<uint8_t> wall(size_t(size) * size), next(wall.size());
+    for (auto& w : wall) w = gen() % 100 < 45;
+
+    for (int step = 0; step < 4; ++step) {
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                int walls = 0;
+                for (int oy = -1; oy <= 1; ++oy) {
+                    for (int ox = -1; ox <= 1; ++ox) {
+                        int nx = x + ox, ny = y + oy;
+                        walls += (nx < 0 || ny < 0 || nx >= size || ny >= size)
+                                 ? 1 : wall[size_t(ny) * size + nx];
+                    }
+                }
+                next[size_t(y) * size + x] = walls >= 5;
+            }
+        }
+        swap(wall, next);
+    }
+
+    GridMap map(size, size);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) map.set(x, y, !wall[size_t(y) * size + x]);
+    }
+    return map;
+}
+
+// 연결 요소 번호: 서로 닿을 수 없는 출발/도착 쌍을 탐색 전에 걸러냄
+vector<uint32_t> labelComponents(const GridMap& map) {
+    vector<uint32_t> label(map.cells(), 0);
+    uint32_t next = 1;
+    vector<Point> stack;
+    for (int y = 0; y < map.getHeight(); ++y) {
+        for (int x = 0; x < map.getWidth(); ++x) {
+            if (!map.walkable(x, y) || label[map.index(x, y)]) continue;
+            label[map.index(x, y)] = next;
+            stack.push_back({x, y});
+            while (!stack.empty()) {
+                Point p = stack.back();
+                stack.pop_back();
+                const int dx[4] = {1, -1, 0, 0}, dy[4] = {0, 0, 1, -1};
+                for (int d = 0; d < 4; ++d) {
+                    int nx = p.x + dx[d], ny = p.y + dy[d];
+                    if (map.walkable(nx, ny) && !label[map.index(nx, ny)]) {
+                        label[map.index(nx, ny)] = next;
+                        stack.push_back({nx, ny});
+                    }
+                }
+            }
+            ++next;
+        }
+    }
+    return label;
+}
+
+// [3] 탐색 공통: 옥타일 거리, 대각선 규칙
+inline uint32_t octile(int x0, int y0, int x1, int y1) {
+    int dx = abs(x1 - x0), dy = abs(y1 - y0);
+    return 10 * static_cast<uint32_t>(max(dx, dy)) + 4 * static_cast<uint32_t>(min(dx, dy));
+}
+
+// 대각선 이동은 양옆 직선 칸이 모두 열려 있어야 함
+inline bool canStep(const GridMap& m, int x, int y, int dx, int dy) {
+    if (!m.walkable(x + dx, y + dy)) return false;
+    if (dx != 0 && dy != 0) return m.walkable(x + dx, y) && m.walkable(x, y + dy);
+    return true;
+}
+
+// 줄 단위 비트셋: 행(가로 점프용)과 열(세로 점프용, 전치) 두 벌을 지도마다 한 번 만들어 모든 스레드가 공유
+// 각 줄 앞뒤에 64칸, 위아래에 한 줄씩 벽을 덧대어 경계 검사 없이 임의 위치의 64칸을 꺼냄
+class LineBits {
+private:
+    size_t wordsPerLine;
+    vector<uint64_t> bits;
+
+public:
+    LineBits(const GridMap& map, bool transposed) {
+        int lines = transposed ? map.getWidth() : map.getHeight();
+        int length = transposed ? map.getHeight() : map.getWidth();
+        wordsPerLine = size_t(length + 128) / 64 + 1;
+        bits.assign(wordsPerLine * size_t(lines + 2), 0);
+        for (int line = 0; line < lines; ++line) {
+            for (int pos = 0; pos < length; ++pos) {
+                if (transposed ? map.walkable(line, pos) : map.walkable(pos, line)) {
+                    size_t b = size_t(pos) + 64;
+                    bits[size_t(line + 1) * wordsPerLine + (b >> 6)] |= 1ULL << (b & 63);
+                }
+            }
+        }
+    }
+
+    size_t bytes() const { return bits.size() * sizeof(uint64_t); }
+
+    // bit k = (line, pos + k) 칸. line 은 -1..lines, pos 는 -64 이상
+    uint64_t window(int line, int pos) const {
+        const uint64_t* row = &bits[size_t(line + 1) * wordsPerLine];
+        size_t b = size_t(pos + 64);
+        unsigned s = b & 63;
+        return s ? (row[b >> 6] >> s) | (row[(b >> 6) + 1] << (64 - s)) : row[b >> 6];
+    }
+
+    // (line, pos) 에서 dir(±1) 로 직선 점프: 강제 이웃이 생기는 칸이나 goal 에 닿으면 그 위치, 벽이면 -1
+    // 강제 이웃 = 옆 줄의 칸이 열려 있는데 그 칸의 바로 뒤(진행 반대쪽)가 막힌 경우
+    int jump(int line, int pos, int dir, int goal) const {
+        if (dir > 0) {
+            for (;;) {
+                uint64_t c = window(line, pos), u = window(line - 1, pos), d = window(line + 1, pos);
+                uint64_t forced = ((u & ~(u << 1)) | (d & ~(d << 1))) & c;
+                uint64_t stop = (~c | forced) & ~1ULL;
+                if (goal > pos && goal - pos < 64) stop |= 1ULL << (goal - pos);
+                if (stop) {
+                    int k = __builtin_ctzll(stop);
+                    return (c >> k) & 1 ? pos + k : -1;
+                }
+                pos += 63;
+            }
+        }
+        for (;;) {
+            // bit j = (line, pos - 63 + j) 칸, 현재 칸은 j = 63
+            uint64_t c = window(line, pos - 63), u = window(line - 1, pos - 63), d = window(line + 1, pos - 63);
+            uint64_t forced = ((u & ~(u >> 1)) | (d & ~(d >> 1))) & c;
+            uint64_t stop = (~c | forced) & (~0ULL >> 1);
+            if (goal >= 0 && goal < pos && pos - goal < 64) stop |= 1ULL << (63 - (pos - goal));
+            if (stop) {
+                int j = 63 - __builtin_clzll(stop);
+                return (c >> j) & 1 ? pos - 63 + j : -1;
+            }
+            pos -= 63;
+        }
+    }
+};
+
+struct PathResult {
+    bool found = false;
+    uint32_t cost = 0;
+    vector<Point> waypoints;     // 출발점과 도착점을 포함
+    size_t expanded = 0;
+};
+
+// 질의 하나가 건드린 칸의 g / 부모 / 닫힘 정보
+// 칸마다 배열을 두면 4096×4096 에서 스레드당 200MB → 지도를 8×8 칸 페이지로 나누고
+// 건드린 페이지만 해시 디렉터리로 찾아 씀 (이웃 칸은 같은 페이지라 캐시 지역성도 유지)
+class NodeTable {
+public:
+    static constexpr int kTileShift = 3;
+    static constexpr int kTileMask = (1 << kTileShift) - 1;
+    static_assert(2 * kTileShift <= 6, "페이지 칸 수가 64비트 마스크를 넘음");
+
+    struct Ref {
+        uint32_t page;
+        unsigned bit;
+    };
+
+private:
+    struct Page {
+        uint64_t seen;          // g / parent 가 유효한 칸
+        uint64_t closed;
+        uint32_t g[1 << (2 * kTileShift)];
+        uint32_t parent[1 << (2 * kTileShift)];
+    };
+    struct DirSlot {
+        uint32_t tile;
+        uint32_t stamp;         // 이번 질의의 세대 번호와 같을 때만 유효
+        uint32_t page;
+    };
+
+    static constexpr size_t kRetainedPages = 2048;      // 이보다 큰 풀은 다음 질의 전에 돌려줌 (약 1MB)
+
+    uint32_t tilesPerRow;
+    vector<DirSlot> dir;
+    int dirShift;
+    vector<Page> pages;
+    uint32_t usedPages = 0;
+    uint32_t generation = 1;
+    uint32_t lastTile = UINT32_MAX, lastPage = 0;
+    size_t peak = 0;
+
+    size_t home(uint32_t tile) const { return size_t((tile * 0x9E3779B97F4A7C15ULL) >> dirShift); }
+
+    void growDir() {
+        vector<DirSlot> old;
+        old.swap(dir);
+        dir.assign(old.size() * 2, DirSlot{0, 0, 0});
+        --dirShift;
+        for (const DirSlot& d : old) {
+            if (d.stamp != generation) continue;
+            size_t i = home(d.tile);
+            while (dir[i].stamp == generation) i = (i + 1) & (dir.size() - 1);
+            dir[i] = d;
+        }
+    }
+
+    uint32_t pageFor(int x, int y) {
+        uint32_t tile = uint32_t(y >> kTileShift) * tilesPerRow + uint32_t(x >> kTileShift);
+        if (tile == lastTile) return lastPage;
+        if ((usedPages + 1) * 2 > dir.size()) growDir();
+        size_t i = home(tile);
+        for (; dir[i].stamp == generation; i = (i + 1) & (dir.size() - 1)) {
+            if (dir[i].tile == tile) {
+                lastTile = tile;
+                return lastPage = dir[i].page;
+            }
+        }
+        if (usedPages == pages.size()) pages.emplace_back();
+        pages[usedPages].seen = pages[usedPages].closed = 0;
+        dir[i] = DirSlot{tile, generation, usedPages};
+        lastTile = tile;
+        return lastPage = usedPages++;
+    }
+
+public:
+    explicit NodeTable(int width)
+        : tilesPerRow(uint32_t(width + kTileMask) >> kTileShift), dir(1 << 10, DirSlot{0, 0, 0}), dirShift(64 - 10) {}
+
+    // 세대 번호만 올려 디렉터리 전체를 비운 것으로 취급, 페이지는 재사용
+    // 지도를 가로지르는 큰 탐색 뒤에는 풀과 디렉터리를 돌려줘 평소 스레드당 메모리를 작게 유지
+    void reset() {
+        peak = max(peak, bytes());
+        if (pages.capacity() > kRetainedPages) {
+            vector<Page>().swap(pages);
+            vector<DirSlot>(1 << 10, DirSlot{0, 0, 0}).swap(dir);
+            dirShift = 64 - 10;
+        }
+        if (++generation == UINT32_MAX) {
+            for (auto& d : dir) d.stamp = 0;
+            generation = 1;
+        }
+        usedPages = 0;
+        lastTile = UINT32_MAX;
+    }
+
+    size_t bytes() const { return dir.size() * sizeof(DirSlot) + pages.capacity() * sizeof(Page); }
+    size_t peakBytes() const { return max(peak, bytes()); }
+
+    // 반환한 Ref 는 다음 at() 호출 뒤에도 유효 (페이지 번호로 가리킴)
+    Ref at(int x, int y) {
+        return Ref{pageFor(x, y), unsigned(((y & kTileMask) << kTileShift) | (x & kTileMask))};
+    }
+
+    uint32_t g(Ref r) const {
+        const Page& p = pages[r.page];
+        return (p.seen >> r.bit) & 1 ? p.g[r.bit] : UINT32_MAX;
+    }
+    uint32_t parent(Ref r) const { return pages[r.page].parent[r.bit]; }
+    bool closed(Ref r) const { return (pages[r.page].closed >> r.bit) & 1; }
+    void close(Ref r) { pages[r.page].closed |= 1ULL << r.bit; }
+
+    void update(Ref r, uint32_t g, uint32_t parent) {
+        Page& p = pages[r.page];
+        p.seen |= 1ULL << r.bit;
+        p.g[r.bit] = g;
+        p.parent[r.bit] = parent;
+    }
+};
+
+// 지도 + 점프용 비트셋: 한 번 만들어 여러 스레드의 SearchContext 가 공유 (읽기 전용)
+struct SearchGrid {
+    const GridMap& map;
+    LineBits rows;
+    LineBits cols;
+
+    explicit SearchGrid(const GridMap& m) : map(m), rows(m, false), cols(m, true) {}
+};
+
+class SearchContext {
+private:
+    const GridMap& map;
+    const SearchGrid& grid;
+    NodeTable nodes;
+
+    using Entry = uint64_t;     // (f << 32) | 칸 번호 → 정수 한 번 비교로 정렬
+    vector<Entry> heap;
+
+public:
+    explicit SearchContext(const SearchGrid& g) : map(g.map), grid(g), nodes(g.map.getWidth()) {
+        heap.reserve(1 << 12);
+    }
+
+    // maxExpanded: 이만큼 확장해도 못 찾으면 포기 (경로 캐시의 짧은 연결 탐색용)
+    PathResult astar(Point s, Point t, size_t maxExpanded = SIZE_MAX) {
+        return search(s, t, false, maxExpanded);
+    }
+
+    PathResult jps(Point s, Point t, size_t maxExpanded = SIZE_MAX) {
+        return search(s, t, true, maxExpanded);
+    }
+
+    // 지금까지 질의 중 가장 컸던 작업 공간 (노드 표 + 열린 목록)
+    size_t scratchBytes() const { return nodes.peakBytes() + heap.capacity() * sizeof(Entry); }
+
+private:
+    void push(uint32_t i, uint32_t f) {
+        heap.push_back((uint64_t(f) << 32) | i);
+        push_heap(heap.begin(), heap.end(), greater<Entry>());
+    }
+
+    void relax(uint32_t from, int nx, int ny, uint32_t cost, Point t) {
+        NodeTable::Ref n = nodes.at(nx, ny);
+        if (nodes.closed(n) || cost >= nodes.g(n)) return;
+        nodes.update(n, cost, from);
+        push(map.index(nx, ny), cost + octile(nx, ny, t.x, t.y));
+    }
+
+    PathResult search(Point s, Point t, bool useJps, size_t maxExpanded) {
+        nodes.reset();
+        heap.clear();
+        PathResult result;
+        if (!map.walkable(s.x, s.y) || !map.walkable(t.x, t.y)) return result;
+
+        uint32_t si = map.index(s.x, s.y), ti = map.index(t.x, t.y);
+        nodes.update(nodes.at(s.x, s.y), 0, si);
+        push(si, octile(s.x, s.y, t.x, t.y));
+
+        while (!heap.empty() && result.expanded < maxExpanded) {
+            pop_heap(heap.begin(), heap.end(), greater<Entry>());
+            uint32_t ci = uint32_t(heap.back());
+            heap.pop_back();
+            int cx = int(ci % map.getWidth()), cy = int(ci / map.getWidth());
+            NodeTable::Ref c = nodes.at(cx, cy);
+            if (nodes.closed(c)) continue;      // 더 나쁜 비용으로 들어간 중복 항목
+            nodes.close(c);
+            ++result.expanded;
+            uint32_t cg = nodes.g(c), cp = nodes.parent(c);
+
+            if (ci == ti) {
+                result.found = true;
+                result.cost = cg;
+                for (uint32_t i = ci; ; ) {
+                    Point p{int(i % map.getWidth()), int(i / map.getWidth())};
+                    result.waypoints.push_back(p);
+                    if (i == si) break;
+                    i = nodes.parent(nodes.at(p.x, p.y));
+                }
+                reverse(result.waypoints.begin(), result.waypoints.end());
+                return result;
+            }
+
+            if (useJps) expandJps(ci, cp, cg, cx, cy, t);
+            else expandAstar(ci, cg, cx, cy, t);
+        }
+        return result;
+    }
+
+    void expandAstar(uint32_t ci, uint32_t cg, int cx, int cy, Point t) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if ((dx || dy) && canStep(map, cx, cy, dx, dy)) {
+                    relax(ci, cx + dx, cy + dy, cg + (dx && dy ? 14 : 10), t);
+                }
+            }
+        }
+    }
+
+    // [4] JPS (모서리 통과 금지 규칙): 이웃 가지치기 + 점프
+    //   대각선 이동: 자연 이웃 3개 (두 직선 + 대각선), 강제 이웃 없음
+    //   직선 이동: 자연 이웃은 정면 1개. 옆 칸이 열려 있고 그 뒤가 막혀 있을 때만
+    //   옆 칸(과 열려 있으면 앞쪽 대각선)이 강제 이웃 → jump() 의 정지 조건과 같은 규칙
+    void expandJps(uint32_t ci, uint32_t pi, uint32_t cg, int cx, int cy, Point t) {
+        int dirs[8][2];
+        int n = 0;
+        auto add = [&](int ax, int ay) { dirs[n][0] = ax; dirs[n][1] = ay; ++n; };
+
+        if (pi == ci) {     // 출발점: 모든 방향
+            for (int dy = -1; dy <= 1; ++dy)
+                for (int dx = -1; dx <= 1; ++dx)
+                    if ((dx || dy) && canStep(map, cx, cy, dx, dy)) add(dx, dy);
+        } else {
+            int px = int(pi % map.getWidth()), py = int(pi / map.getWidth());
+            int dx = (cx > px) - (cx < px), dy = (cy > py) - (cy < py);
+
+            if (dx && dy) {
+                bool v = map.walkable(cx, cy + dy), h = map.walkable(cx + dx, cy);
+                if (v) add(0, dy);
+                if (h) add(dx, 0);
+                if (v && h && map.walkable(cx + dx, cy + dy)) add(dx, dy);
+            } else if (dx) {
+                bool next = map.walkable(cx + dx, cy);
+                if (next) add(dx, 0);
+                for (int side : {1, -1}) {
+                    if (map.walkable(cx, cy + side) && !map.walkable(cx - dx, cy + side)) {
+                        add(0, side);
+                        if (next && map.walkable(cx + dx, cy + side)) add(dx, side);
+                    }
+                }
+            } else {
+                bool next = map.walkable(cx, cy + dy);
+                if (next) add(0, dy);
+                for (int side : {1, -1}) {
+                    if (map.walkable(cx + side, cy) && !map.walkable(cx + side, cy - dy)) {
+                        add(side, 0);
+                        if (next && map.walkable(cx + side, cy + dy)) add(side, dy);
+                    }
+                }
+            }
+        }
+
+        for (int k = 0; k < n; ++k) {
+            Point jp;
+            if (jump(cx, cy, dirs[k][0], dirs[k][1], t, jp)) {
+                relax(ci, jp.x, jp.y, cg + octile(cx, cy, jp.x, jp.y), t);
+            }
+        }
+    }
+
+    // 직선 점프: 비트셋으로 한 번에 63칸씩 검사
+    bool jumpStraight(int x, int y, int dx, int dy, Point t, Point& out) const {
+        if (dx) {
+            int nx = grid.rows.jump(y, x, dx, t.y == y ? t.x : -1);
+            if (nx < 0) return false;
+            out = {nx, y};
+        } else {
+            int ny = grid.cols.jump(x, y, dy, t.x == x ? t.y : -1);
+            if (ny < 0) return false;
+            out = {x, ny};
+        }
+        return true;
+    }
+
+    // 대각선 점프: 매 칸에서 두 직선 방향으로 점프해 보고, 무엇이든 찾으면 그 칸이 점프 포인트
+    bool jump(int x, int y, int dx, int dy, Point t, Point& out) const {
+        if (!dx || !dy) return jumpStraight(x, y, dx, dy, t, out);
+        Point ignored;
+        while (true) {
+            if (!canStep(map, x, y, dx, dy)) return false;
+            x += dx;
+            y += dy;
+            if (x == t.x && y == t.y) { out = {x, y}; return true; }
+            if (jumpStraight(x, y, dx, 0, t, ignored) || jumpStraight(x, y, 0, dy, t, ignored)) {
+                out = {x, y};
+                return true;
+            }
+        }
+    }
+};
+
+// [5] 직선 이동 가능 여부 (브레젠험 직선 위의 모든 칸이 열려 있고 대각선 규칙도 만족)
+bool lineOfSight(const GridMap& map, Point a, Point b) {
+    int dx = abs(b.x - a.x), dy = abs(b.y - a.y);
+    int sx = a.x < b.x ? 1 : -1, sy = a.y < b.y ? 1 : -1;
+    int err = dx - dy;
+    int x = a.x, y = a.y;
+    while (!(x == b.x && y == b.y)) {
+        int e2 = 2 * err;
+        int stepX = 0, stepY = 0;
+        if (e2 > -dy) { err -= dy; stepX = sx; }
+        if (e2 < dx) { err += dx; stepY = sy; }
+        if (!canStep(map, x, y, stepX, stepY)) return false;
+        x += stepX;
+        y += stepY;
+    }
+    return true;
+}
+
+// [6] 구역 쌍 경로 캐시
+class PathCache {
+public:
+    static constexpr int kRegionShift = 5;          // 32×32 타일 = 한 구역
+    static constexpr size_t kShards = 64;
+    static constexpr size_t kEntriesPerShard = 4096;
+
+private:
+    struct Shard {
+        shared_mutex mtx;
+        unordered_map<uint64_t, vector<Point>> entries;
+    };
+    Shard shards[kShards];
+    atomic<uint64_t> hits{0}, misses{0};
+
+    static uint64_t key(Point s, Point t) {
+        uint64_t a = (uint64_t(s.x >> kRegionShift) << 16) | uint64_t(s.y >> kRegionShift);
+        uint64_t b = (uint64_t(t.x >> kRegionShift) << 16) | uint64_t(t.y >> kRegionShift);
+        return (a << 32) | b;
+    }
+    Shard& shardFor(uint64_t k) { return shards[(k * 0x9E3779B97F4A7C15ULL) >> 58]; }
+
+public:
+    bool lookup(Point s, Point t, vector<Point>& out) {
+        uint64_t k = key(s, t);
+        Shard& shard = shardFor(k);
+        shared_lock<shared_mutex> lock(shard.mtx);
+        auto it = shard.entries.find(k);
+        if (it == shard.entries.end()) return false;
+        out = it->second;
+        return true;
+    }
+
+    void store(Point s, Point t, const vector<Point>& path) {
+        uint64_t k = key(s, t);
+        Shard& shard = shardFor(k);
+        unique_lock<shared_mutex> lock(shard.mtx);
+        if (shard.entries.size() >= kEntriesPerShard) shard.entries.clear();   // 단순 용량 제한
+        shard.entries[k] = path;
+    }
+
+    void countHit() { hits.fetch_add(1, memory_order_relaxed); }
+    void countMiss() { misses.fetch_add(1, memory_order_relaxed); }
+    uint64_t hitCount() const { return hits.load(); }
+    uint64_t missCount() const { return misses.load(); }
+};
+
+// 경유점 경로를 칸 단위로 펼쳐 실제로 걸을 수 있는지 검증
+bool validatePath(const GridMap& map, const vector<Point>& waypoints) {
+    for (size_t i = 1; i < waypoints.size(); ++i) {
+        if (!lineOfSight(map, waypoints[i - 1], waypoints[i])) return false;
+    }
+    return true;
+}
+
+// path 끝(a)에서 b 까지 이어 붙임: 직선으로 보이면 그대로, 아니면 확장 수를 제한한 짧은 JPS
+constexpr size_t kLinkBudget = 4096;
+
+bool linkTo(const GridMap& map, SearchContext& ctx, Point b, vector<Point>& path) {
+    Point a = path.back();
+    if (a.x == b.x && a.y == b.y) return true;
+    if (lineOfSight(map, a, b)) {
+        path.push_back(b);
+        return true;
+    }
+    PathResult r = ctx.jps(a, b, kLinkBudget);
+    if (!r.found) return false;
+    path.insert(path.end(), r.waypoints.begin() + 1, r.waypoints.end());
+    return true;
+}
+
+// 캐시 우선 경로 탐색: 같은 구역 쌍의 경로가 있으면 새 출발/도착점을 그 양 끝에 이어 재사용
+// (최적은 아닐 수 있지만 항상 걸을 수 있는 경로), 이을 수 없으면 JPS 로 새로 찾아 저장
+bool findPathCached(const GridMap& map, PathCache& cache, SearchContext& ctx,
+                    Point s, Point t, vector<Point>& path, vector<Point>& cached) {
+    if (cache.lookup(s, t, cached)) {
+        path.assign(1, s);
+        if (linkTo(map, ctx, cached.front(), path)) {
+            path.insert(path.end(), cached.begin() + 1, cached.end());
+            if (linkTo(map, ctx, t, path)) {
+                cache.countHit();
+                return true;
+            }
+        }
+    }
+    cache.countMiss();
+    PathResult r = ctx.jps(s, t);
+    path = r.waypoints;
+    if (r.found) cache.store(s, t, r.waypoints);
+    return r.found;
+}
+
+// [7] 벤치마크
+struct Query {
+    Point s, t;
+};
+
+vector<Query> makeQueries(const GridMap& map, const vector<uint32_t>& label, size_t count,
+                          uint32_t seed, bool local) {
+    mt19937 gen(seed);
+    int w = map.getWidth(), h = map.getHeight();
+    vector<Query> q;
+    // local: 플레이어들이 있는 256×256 활동 영역 안의 거점 8곳 사이를 몬스터들이 오가는 상황
+    // (캐시가 효과적인 분포, 지도가 커져도 질의 길이는 비슷)
+    auto randomNear = [&](Point center, int radius) {
+        return Point{min(w - 1, max(0, center.x + int(gen() % (2 * radius + 1)) - radius)),
+                     min(h - 1, max(0, center.y + int(gen() % (2 * radius + 1)) - radius))};
+    };
+    int zoneW = min(w, 256), zoneH = min(h, 256);
+    Point zone{int(gen() % (w - zoneW + 1)), int(gen() % (h - zoneH + 1))};
+    Point hubs[8];
+    for (auto& hub : hubs) hub = {zone.x + int(gen() % zoneW), zone.y + int(gen() % zoneH)};
+
+    while (q.size() < count) {
+        Point s, t;
+        if (local) {
+            s = randomNear(hubs[gen() % 8], 12);
+            t = randomNear(hubs[gen() % 8], 12);
+        } else {
+            s = {int(gen() % w), int(gen() % h)};
+            t = {int(gen() % w), int(gen() % h)};
+        }
+        if (!map.walkable(s.x, s.y) || !map.walkable(t.x, t.y)) continue;
+        if (label[map.index(s.x, s.y)] != label[map.index(t.x, t.y)]) continue;
+        q.push_back({s, t});
+    }
+    return q;
+}
+
+double secondsSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+constexpr size_t kTickQueries = 4000;       // 한 틱에 경로를 요청하는 몬스터 수
+
+// 자체 검사: JPS 비용이 A* 와 다르거나 잘못된 경로가 하나라도 나오면 false
+bool benchmarkMap(const string& name, const GridMap& map, size_t queries, size_t threads) {
+    vector<uint32_t> label = labelComponents(map);
+    size_t open = 0;
+    for (int y = 0; y < map.getHeight(); ++y)
+        for (int x = 0; x < map.getWidth(); ++x) open += map.walkable(x, y);
+    SearchGrid grid(map);
+
+    cout << "\n=== " << name << " " << map.getWidth() << "×" << map.getHeight()
+         << " (비트셋 " << map.bytes() / 1024 << " KB + 점프용 행/열 "
+         << (grid.rows.bytes() + grid.cols.bytes()) / 1024 << " KB, 열린 칸 "
+         << 100 * open / map.cells() << "%) ===" << endl;
+
+    // 단일 스레드: 지도 전체에 흩어진 긴 질의로 A* vs JPS (같은 질의, 비용 일치 확인)
+    // 큰 지도는 A* 가 질의당 수백만 노드를 확장하므로 10개만
+    if (map.cells() > (1u << 20)) queries = min<size_t>(queries, 10);
+    vector<Query> qs = makeQueries(map, label, queries, 11, false);
+    SearchContext ctx(grid);
+    size_t astarExpanded = 0, jpsExpanded = 0, mismatches = 0, invalid = 0;
+    vector<uint32_t> costs(qs.size());
+
+    auto t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < qs.size(); ++i) {
+        PathResult r = ctx.astar(qs[i].s, qs[i].t);
+        costs[i] = r.cost;
+        astarExpanded += r.expanded;
+    }
+    double astarSec = secondsSince(t0);
+    size_t astarScratch = ctx.scratchBytes();
+
+    SearchContext jctx(grid);
+    t0 = chrono::steady_clock::now();
+    for (size_t i = 0; i < qs.size(); ++i) {
+        PathResult r = jctx.jps(qs[i].s, qs[i].t);
+        jpsExpanded += r.expanded;
+        mismatches += r.cost != costs[i];
+        invalid += !r.found || !validatePath(map, r.waypoints);
+    }
+    double jpsSec = secondsSince(t0);
+
+    cout << "긴 질의 " << qs.size() << "개" << endl;
+    cout << "A*  : " << qs.size() / astarSec << " 질의/초, 평균 확장 "
+         << astarExpanded / qs.size() << " 노드, 작업 공간 " << astarScratch / 1024 << " KB" << endl;
+    cout << "JPS : " << qs.size() / jpsSec << " 질의/초, 평균 확장 "
+         << jpsExpanded / qs.size() << " 노드, 작업 공간 " << jctx.scratchBytes() / 1024
+         << " KB (비용 불일치 " << mismatches << ", 잘못된 경로 " << invalid << ")" << endl;
+
+    // 다중 스레드 + 경로 캐시: 몬스터들이 몇몇 구역 사이로 길을 찾는 틱을 두 번 연속 실행
+    // 첫 틱은 빈 캐시, 둘째 틱은 첫 틱이 채운 캐시를 그대로 씀 (실제 게임의 정상 상태)
+    vector<Query> local = makeQueries(map, label, 2 * kTickQueries, 23, true);
+    PathCache cache;
+    atomic<size_t> bad{0}, scratch{0};
+    for (int tick = 0; tick < 2; ++tick) {
+        atomic<size_t> next{size_t(tick) * kTickQueries};
+        size_t end = size_t(tick + 1) * kTickQueries;
+        uint64_t hitsBefore = cache.hitCount();
+        auto worker = [&] {
+            SearchContext c(grid);
+            vector<Point> path, cached;
+            size_t i;
+            while ((i = next.fetch_add(1, memory_order_relaxed)) < end) {
+                const Query& q = local[i];
+                if (!findPathCached(map, cache, c, q.s, q.t, path, cached) || !validatePath(map, path) ||
+                    path.front().x != q.s.x || path.front().y != q.s.y ||
+                    path.back().x != q.t.x || path.back().y != q.t.y) {
+                    bad.fetch_add(1);
+                }
+            }
+            size_t mine = c.scratchBytes(), seen = scratch.load();
+            while (mine > seen && !scratch.compare_exchange_weak(seen, mine)) {}
+        };
+        t0 = chrono::steady_clock::now();
+        vector<thread> pool;
+        for (size_t k = 0; k < threads; ++k) pool.emplace_back(worker);
+        for (auto& th : pool) th.join();
+        double tickSec = secondsSince(t0);
+
+        cout << "JPS + 캐시 " << (tick ? "둘째" : "첫") << " 틱 (" << threads << " 스레드): "
+             << kTickQueries / tickSec << " 질의/초, " << kTickQueries << "개 질의 " << tickSec * 1000
+             << " ms, 캐시 적중 " << cache.hitCount() - hitsBefore << "/" << kTickQueries << endl;
+    }
+    cout << "스레드당 작업 공간 최대 " << scratch.load() / 1024 << " KB, 잘못된 경로 " << bad.load() << endl;
+
+    return mismatches == 0 && invalid == 0 && bad.load() == 0;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int size = argc > 1 ? stoi(argv[1]) : 4096;
+        size_t queries = argc > 2 ? stoul(argv[2]) : 100;
+        size_t threads = argc > 3 ? stoul(argv[3]) : max(1u, thread::hardware_concurrency());
+
+        cout << "=== 격자 던전 경로 탐색 ===" << endl;
+        bool ok = true;
+        vector<int> sizes{min(size, 512)};
+        if (size > 512) sizes.push_back(size);
+        for (int n : sizes) {
+            ok &= benchmarkMap("동굴", generateCave(n, 1), queries, threads);
+            ok &= benchmarkMap("미로", generateMaze(n % 2 ? n : n - 1, 2), queries, threads);   // 미로는 홀수 크기
+        }
+        if (!ok) {
+            cout << "\n자체 검사 실패: JPS 비용 불일치 또는 잘못된 경로" << endl;
+            return 1;
+        }
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,758 @@
+/*
+ * 파일명: 11_procedural_floor_streaming.cpp
+ *
+ * 주제: 병렬 절차적 던전 생성과 층 스트리밍 (Parallel Procedural Generation + Floor Streaming)
+ * 정의: 시드 하나로 각 층을 동굴(셀룰러 오토마타) 또는 방(BSP)으로 생성하되, 지도를 청크로
+ *       나누어 병렬로 만들고, 다음 층은 미리 백그라운드에서 준비하며, 오래된 층은 디스크로
+ *       내보내 메모리 사용량을 일정하게 유지하는 기법
+ *
+ * 핵심 개념:
+ * - 좌표 해시 잡음: 초기 벽 여부 = hash(시드, 층, x, y) → 어느 청크가 먼저 만들어지든 결과 동일
+ * - 여유 테두리(apron): 오토마타 1회마다 이웃 1칸이 필요 → 반복 횟수만큼 테두리를 더 계산하면
+ *   청크 단위 결과가 지도 전체를 한 번에 만든 결과와 비트 단위로 같음
+ * - BSP 방: 층 전체의 방/통로 사각형 목록은 가볍게 한 번만 만들고, 청크마다 겹치는 부분만 칠함
+ * - 청크 폭 64 = 비트셋 워드 하나 → 청크끼리 같은 워드를 쓰지 않아 잠금 없이 병렬 기록
+ * - 지연 생성 + 선행 로딩: 층에 들어갈 때 없으면 생성, 들어가는 순간 다음 층을 백그라운드에 예약
+ *   진행 중인 생성은 shared_future 로 공유 → 같은 층을 두 번 만들지 않음
+ * - 페이지 아웃: 상주 층 수를 제한(LRU), 밀려난 층은 런 길이 부호화(RLE) 파일로 저장
+ *   → 플레이어가 판 구멍 같은 변경 사항도 보존
+ *   임시 파일에 다 쓰고 확인한 뒤 rename, 저장에 실패한 층은 버리지 않고 상주로 남김
+ * - 선행 로딩 스레드의 실패(손상된 파일 등)는 층별로 보관했다가 그 층에 들어갈 때 예외로 전달
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o floors 11_procedural_floor_streaming.cpp
+ * 실행: ./floors [지도 크기(64의 배수)] [내려갈 층 수] [생성 스레드 수]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+using namespace std;
+namespace fs = std::filesystem;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] 층 지도: 1비트 = 1타일, 행마다 64비트 워드 단위로 정렬
+// dig() 는 게임 스레드, 페이지 아웃 저장은 선행 로딩 스레드에서 일어남 → 변경과 사본 뜨기는 mtx 로 보호
+class FloorMap {
+private:
+    int floor;
+    int size;
+    int wordsPerRow;
+    vector<uint64_t> bits;      // 1 = 이동 가능
+    mutable mutex mtx;
+    bool dirty = false;         // 생성/로드 이후 바뀐 적이 있는지
+    uint64_t version = 0;       // dig() 마다 증가
+
+public:
+    FloorMap(int f, int s) : floor(f), size(s), wordsPerRow(s / 64), bits(size_t(s) * (s / 64), 0) {}
+
+    int getFloor() const { return floor; }
+    int getSize() const { return size; }
+    size_t bytes() const { return bits.size() * sizeof(uint64_t); }
+    bool isDirty() const {
+        lock_guard<mutex> lock(mtx);
+        return dirty;
+    }
+
+    // 저장할 비트셋 사본과 그 시점의 버전 (다른 스레드가 dig 하는 중에도 일관된 사본)
+    uint64_t snapshot(vector<uint64_t>& out) const {
+        lock_guard<mutex> lock(mtx);
+        out = bits;
+        return version;
+    }
+
+    // 저장한 사본 이후로 바뀐 게 없을 때만 깨끗하다고 표시
+    void markClean(uint64_t savedVersion) {
+        lock_guard<mutex> lock(mtx);
+        if (version == savedVersion) dirty = false;
+    }
+
+    bool walkable(int x, int y) const {
+        if (x < 0 || y < 0 || x >= size || y >= size) return false;
+        return (bits[size_t(y) * wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+
+    // 생성기 전용: 청크 하나가 (행, 워드) 하나를 통째로 씀
+    void setWord(int y, int wordX, uint64_t w) { bits[size_t(y) * wordsPerRow + wordX] = w; }
+    const vector<uint64_t>& words() const { return bits; }
+    vector<uint64_t>& words() { return bits; }
+
+    // 플레이어의 변경 (예: 벽 파기)
+    void dig(int x, int y) {
+        lock_guard<mutex> lock(mtx);
+        bits[size_t(y) * wordsPerRow + (x >> 6)] |= 1ULL << (x & 63);
+        dirty = true;
+        ++version;
+    }
+
+    uint64_t hash() const {
+        uint64_t h = mix64(uint64_t(floor) << 32 | uint32_t(size));
+        for (uint64_t w : bits) h = mix64(h ^ w);
+        return h;
+    }
+};
+
+// [2] 생성기
+constexpr int kChunk = 64;            // 청크 한 변 (비트셋 워드 폭과 같음)
+constexpr int kCaveSteps = 4;         // 오토마타 반복 횟수 = 필요한 테두리 폭
+
+enum class FloorStyle { Cave, Rooms };
+
+FloorStyle styleFor(int floor) { return floor % 3 == 0 ? FloorStyle::Rooms : FloorStyle::Cave; }
+
+struct Rect {
+    int x, y, w, h;
+};
+
+// 층 전체의 BSP 방/통로 목록 (청크 생성 전에 한 번만 계산, 수백 개 사각형)
+vector<Rect> buildBspLayout(uint64_t seed, int floor, int size) {
+    mt19937 gen(static_cast<uint32_t>(mix64(seed ^ uint64_t(floor) * 0x51ED27ULL)));
+    vector<Rect> carved;
+
+    // 반환값: 이 영역 안에 있는 방 하나의 중심 (통로 연결용)
+    function<pair<int, int>(Rect)> split = [&](Rect r) -> pair<int, int> {
+        bool canH = r.w >= 24, canV = r.h >= 24;
+        if (!canH && !canV) {
+            int rw = 4 + int(gen() % (r.w - 6)), rh = 4 + int(gen() % (r.h - 6));
+            int rx = r.x + 1 + int(gen() % (r.w - rw - 1)), ry = r.y + 1 + int(gen() % (r.h - rh - 1));
+            carved.push_back({rx, ry, rw, rh});
+            return {rx + rw / 2, ry + rh / 2};
+        }
+        bool horizontal = canH && (!canV || r.w >= r.h);
+        pair<int, int> a, b;
+        if (horizontal) {
+            int cut = r.w / 3 + int(gen() % (r.w / 3));
+            a = split({r.x, r.y, cut, r.h});
+            b = split({r.x + cut, r.y, r.w - cut, r.h});
+        } else {
+            int cut = r.h / 3 + int(gen() % (r.h / 3));
+            a = split({r.x, r.y, r.w, cut});
+            b = split({r.x, r.y + cut, r.w, r.h - cut});
+        }
+        // L자 통로: 가로 구간 + 세로 구간
+        carved.push_back({min(a.first, b.first), a.second, abs(a.first - b.first) + 1, 1});
+        carved.push_back({b.first, min(a.second, b.second), 1, abs(a.second - b.second) + 1});
+        return gen() % 2 ? a : b;
+    };
+    split({0, 0, size, size});
+    return carved;
+}
+
+void generateRoomChunk(FloorMap& map, const vector<Rect>& layout, int cx, int cy) {
+    int x0 = cx * kChunk, y0 = cy * kChunk;
+    uint64_t rows[kChunk] = {};
+    for (const Rect& r : layout) {
+        int ax = max(r.x, x0), bx = min(r.x + r.w, x0 + kChunk);
+        int ay = max(r.y, y0), by = min(r.y + r.h, y0 + kChunk);
+        if (ax >= bx || ay >= by) continue;
+        int span = bx - ax;
+        uint64_t mask = (span == 64 ? ~0ULL : ((1ULL << span) - 1)) << (ax - x0);
+        for (int y = ay; y < by; ++y) rows[y - y0] |= mask;
+    }
+    for (int y = 0; y < kChunk; ++y) map.setWord(y0 + y, cx, rows[y]);
+}
+
+// 동굴 청크: (64 + 2×4)² 영역을 계산하고 가운데 64² 만 기록
+void generateCaveChunk(FloorMap& map, uint64_t seed, int cx, int cy) {
+    constexpr int kApron = kCaveSteps;
+    constexpr int kSpan = kChunk + 2 * kApron;
+    int size = map.getSize();
+    int ox = cx * kChunk - kApron, oy = cy * kChunk - kApron;
+    uint64_t floorKey = mix64(seed ^ uint64_t(map.getFloor()) * 0x9E3779B1ULL);
+
+    static thread_local vector<uint8_t> wall, next;
+    wall.assign(kSpan * kSpan, 1);
+    next.assign(kSpan * kSpan, 1);
+    auto inside = [&](int gx, int gy) { return gx >= 0 && gy >= 0 && gx < size && gy < size; };
+
+    for (int y = 0; y < kSpan; ++y) {
+        for (int x = 0; x < kSpan; ++x) {
+            int gx = ox + x, gy = oy + y;
+            if (inside(gx, gy)) {
+                wall[y * kSpan + x] = mix64(floorKey ^ (uint64_t(gy) << 32 | uint32_t(gx))) % 100 < 45;
+            }
+        }
+    }
+    // 반복할 때마다 정확한 영역이 한 칸씩 줄어듦: step 번째에는 [step, kSpan - step) 만 갱신
+    for (int step = 1; step <= kCaveSteps; ++step) {
+        for (int y = step; y < kSpan - step; ++y) {
+            for (int x = step; x < kSpan - step; ++x) {
+                if (!inside(ox + x, oy + y)) { next[y * kSpan + x] = 1; continue; }
+                int walls = 0;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx)
+                        walls += wall[(y + dy) * kSpan + (x + dx)];
+                next[y * kSpan + x] = walls >= 5;
+            }
+        }
+        swap(wall, next);
+    }
+    for (int y = 0; y < kChunk; ++y) {
+        uint64_t w = 0;
+        for (int x = 0; x < kChunk; ++x) {
+            if (!wall[(y + kApron) * kSpan + x + kApron]) w |= 1ULL << x;
+        }
+        map.setWord(cy * kChunk + y, cx, w);
+    }
+}
+
+// [3] 청크 작업자: 고정된 스레드들이 원자적 인덱스로 청크를 나누어 가짐
+class ChunkWorkers {
+private:
+    vector<thread> threads;
+    mutex mtx;
+    condition_variable cv;
+    condition_variable doneCv;
+    function<void(int)> job;
+    int jobSize = 0;
+    atomic<int> nextIndex{0};
+    int busy = 0;
+    uint64_t jobId = 0;
+    bool stopping = false;
+    mutex submitMtx;            // 한 번에 작업 하나 (선행 로딩과 본 스레드가 동시에 요청할 수 있음)
+
+public:
+    explicit ChunkWorkers(size_t n) {
+        for (size_t i = 0; i < max<size_t>(1, n); ++i) threads.emplace_back(&ChunkWorkers::loop, this);
+    }
+
+    ~ChunkWorkers() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    size_t size() const { return threads.size(); }
+
+    void run(int count, function<void(int)> fn) {
+        lock_guard<mutex> submit(submitMtx);
+        unique_lock<mutex> lock(mtx);
+        job = move(fn);
+        jobSize = count;
+        nextIndex.store(0);
+        busy = static_cast<int>(threads.size());
+        ++jobId;
+        cv.notify_all();
+        doneCv.wait(lock, [&] { return busy == 0; });
+    }
+
+private:
+    void loop() {
+        uint64_t seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> lock(mtx);
+                cv.wait(lock, [&] { return stopping || jobId != seen; });
+                if (stopping) return;
+                seen = jobId;
+            }
+            int i;
+            while ((i = nextIndex.fetch_add(1)) < jobSize) job(i);
+            lock_guard<mutex> lock(mtx);
+            if (--busy == 0) doneCv.notify_one();
+        }
+    }
+};
+
+shared_ptr<FloorMap> generateFloor(ChunkWorkers& workers, uint64_t seed, int floor, int size) {
+    auto map = make_shared<FloorMap>(floor, size);
+    int chunks = size / kChunk;
+    if (styleFor(floor) == FloorStyle::Rooms) {
+        vector<Rect> layout = buildBspLayout(seed, floor, size);
+        workers.run(chunks * chunks, [&](int i) { generateRoomChunk(*map, layout, i % chunks, i / chunks); });
+    } else {
+        workers.run(chunks * chunks, [&](int i) { generateCaveChunk(*map, seed, i % chunks, i / chunks); });
+    }
+    return map;
+}
+
+// [4] 디스크 형식: 헤더 + 벽/통로가 번갈아 나오는 런 길이(가변 길이 정수)
+//   "FLR1" | 층(4바이트) | 크기(4바이트) | 런 개수(4바이트) | varint 런...
+//   잡음이 많은 동굴은 런이 짧아 RLE 가 비트셋보다 커질 수 있음 → 그때는 "FLR0" + 비트셋 그대로
+void writeVarint(vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) { out.push_back(uint8_t(v | 0x80)); v >>= 7; }
+    out.push_back(uint8_t(v));
+}
+
+// savedVersion: 저장한 사본의 버전 (호출자가 markClean 에 넘김)
+// 쓰기/닫기 중 하나라도 실패하면 예외 → 호출자는 층을 깨끗하다고 표시하지 않음
+size_t saveFloor(const FloorMap& map, const fs::path& path, uint64_t* savedVersion = nullptr) {
+    vector<uint64_t> words;
+    uint64_t version = map.snapshot(words);
+    vector<uint8_t> runs;
+    uint32_t runCount = 0, current = 0;
+    bool state = false;         // 벽 런부터 시작
+    const uint64_t cells = uint64_t(map.getSize()) * uint64_t(map.getSize());
+    for (uint64_t c = 0; c < cells; ++c) {      // 행 길이가 64의 배수라 칸 번호 = 비트 번호
+        if (bool((words[c >> 6] >> (c & 63)) & 1) != state) {
+            writeVarint(runs, current);
+            ++runCount;
+            state = !state;
+            current = 0;
+        }
+        ++current;
+    }
+    writeVarint(runs, current);
+    ++runCount;
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file) throw runtime_error("층 파일을 쓸 수 없습니다: " + path.string());
+    bool raw = runs.size() >= map.bytes();
+    int32_t header[3] = {map.getFloor(), map.getSize(), raw ? 0 : static_cast<int32_t>(runCount)};
+    file.write(raw ? "FLR0" : "FLR1", 4);
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    if (raw) file.write(reinterpret_cast<const char*>(words.data()), map.bytes());
+    else file.write(reinterpret_cast<const char*>(runs.data()), runs.size());
+    file.flush();
+    if (!file.good()) throw runtime_error("층 파일 쓰기 실패: " + path.string());
+    file.close();
+    if (file.fail()) throw runtime_error("층 파일 닫기 실패: " + path.string());
+    if (savedVersion) *savedVersion = version;
+    return 4 + sizeof(header) + (raw ? map.bytes() : runs.size());
+}
+
+// 파일 내용은 믿지 않음: 크기, 런 개수, 각 런과 varint 를 모두 검사한 뒤에만 비트를 씀
+shared_ptr<FloorMap> loadFloor(const fs::path& path) {
+    auto corrupt = [&](const string& why) { return runtime_error("손상된 층 파일 (" + why + "): " + path.string()); };
+    ifstream file(path, ios::binary);
+    if (!file) throw runtime_error("층 파일을 열 수 없습니다: " + path.string());
+    vector<uint8_t> data((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+    int32_t header[3];
+    string magic = data.size() >= 4 ? string(data.begin(), data.begin() + 4) : "";
+    if (data.size() < 4 + sizeof(header) || (magic != "FLR0" && magic != "FLR1")) throw corrupt("헤더");
+    memcpy(header, data.data() + 4, sizeof(header));
+    int32_t floor = header[0], size = header[1], runCount = header[2];
+    if (floor < 0) throw corrupt("층 번호");
+    if (size < kChunk || size > 4096 || size % kChunk != 0) throw corrupt("지도 크기");
+    const uint64_t cells = uint64_t(size) * uint64_t(size);
+    if (magic == "FLR0" ? runCount != 0 : (runCount < 1 || uint64_t(runCount) > cells + 1)) throw corrupt("런 개수");
+
+    auto map = make_shared<FloorMap>(floor, size);
+    size_t pos = 4 + sizeof(header);
+    if (magic == "FLR0") {
+        if (data.size() - pos != map->bytes()) throw corrupt("비트셋 길이");
+        memcpy(map->words().data(), data.data() + pos, map->bytes());
+        return map;
+    }
+    uint64_t cell = 0;
+    bool state = false;
+    auto& words = map->words();
+    for (int32_t r = 0; r < runCount; ++r) {
+        uint64_t run = 0;
+        for (int shift = 0;; shift += 7) {
+            if (pos >= data.size()) throw corrupt("잘린 varint");
+            if (shift > 28) throw corrupt("너무 긴 varint");
+            uint8_t b = data[pos++];
+            run |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) break;
+        }
+        if (run > cells - cell) throw corrupt("지도 밖으로 나가는 런");
+        if (state) {    // 행 길이가 64의 배수라 칸 번호 = 워드 배열의 비트 번호
+            for (uint64_t c = cell; c < cell + run; ++c) words[c >> 6] |= 1ULL << (c & 63);
+        }
+        cell += run;
+        state = !state;
+    }
+    if (cell != cells) throw corrupt("런 합계가 지도 크기와 다름");
+    if (pos != data.size()) throw corrupt("남는 바이트");
+    return map;
+}
+
+// [5] 층 스트리머: 지연 생성, 선행 로딩, LRU 페이지 아웃
+class FloorStreamer {
+public:
+    struct Stats {
+        size_t generated = 0;
+        size_t loadedFromDisk = 0;
+        size_t pagedOut = 0;
+        size_t diskBytes = 0;
+        size_t peakResident = 0;
+        size_t saveFailures = 0;        // 저장에 실패해 상주로 남긴 횟수
+    };
+
+private:
+    uint64_t seed;
+    int size;
+    size_t maxResident;
+    fs::path directory;
+    ChunkWorkers& workers;
+
+    mutex mtx;
+    unordered_map<int, shared_ptr<FloorMap>> resident;
+    list<int> lru;                                  // 앞쪽이 가장 최근
+    unordered_map<int, shared_future<shared_ptr<FloorMap>>> inflight;
+    unordered_set<int> onDisk;
+    unordered_map<int, exception_ptr> failed;       // 선행 로딩이 실패한 층 → 다음 enter() 에서 던짐
+    Stats stats;
+
+    thread prefetcher;
+    deque<int> prefetchQueue;
+    condition_variable prefetchCv;
+    bool stopping = false;
+
+public:
+    FloorStreamer(uint64_t s, int mapSize, size_t resident, fs::path dir, ChunkWorkers& w)
+        : seed(s), size(mapSize), maxResident(max<size_t>(2, resident)), directory(move(dir)), workers(w) {
+        fs::create_directories(directory);
+        prefetcher = thread(&FloorStreamer::prefetchLoop, this);
+    }
+
+    ~FloorStreamer() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+            prefetchQueue.clear();
+        }
+        prefetchCv.notify_all();
+        prefetcher.join();
+    }
+
+    FloorStreamer(const FloorStreamer&) = delete;
+    FloorStreamer& operator=(const FloorStreamer&) = delete;
+
+    // 층에 들어감: 필요하면 생성/로드하고, 다음 층을 백그라운드에 예약
+    shared_ptr<FloorMap> enter(int floor) {
+        shared_ptr<FloorMap> map = acquire(floor);
+        {
+            lock_guard<mutex> lock(mtx);
+            prefetchQueue.push_back(floor + 1);
+        }
+        prefetchCv.notify_one();
+        return map;
+    }
+
+    Stats getStats() {
+        lock_guard<mutex> lock(mtx);
+        return stats;
+    }
+
+private:
+    fs::path pathFor(int floor) const { return directory / ("floor_" + to_string(floor) + ".bin"); }
+
+    shared_ptr<FloorMap> acquire(int floor) {
+        unique_lock<mutex> lock(mtx);
+        auto fail = failed.find(floor);
+        if (fail != failed.end()) {                 // 한 번 알리고 지움 → 다음 진입은 다시 시도
+            exception_ptr error = fail->second;
+            failed.erase(fail);
+            rethrow_exception(error);
+        }
+        auto it = resident.find(floor);
+        if (it != resident.end()) {
+            lru.remove(floor);
+            lru.push_front(floor);
+            return it->second;
+        }
+        auto pending = inflight.find(floor);
+        if (pending != inflight.end()) {            // 선행 로딩이 만드는 중 → 결과를 기다림
+            shared_future<shared_ptr<FloorMap>> f = pending->second;
+            lock.unlock();
+            return f.get();
+        }
+
+        promise<shared_ptr<FloorMap>> done;
+        inflight[floor] = done.get_future().share();
+        bool fromDisk = onDisk.count(floor) > 0;
+        lock.unlock();
+
+        shared_ptr<FloorMap> map;
+        try {
+            map = fromDisk ? loadFloor(pathFor(floor)) : generateFloor(workers, seed, floor, size);
+            if (map->getFloor() != floor || map->getSize() != size) {
+                throw runtime_error("층 파일의 층/크기가 맞지 않습니다: " + pathFor(floor).string());
+            }
+        } catch (...) {
+            lock.lock();
+            inflight.erase(floor);
+            done.set_exception(current_exception());
+            throw;
+        }
+
+        lock.lock();
+        inflight.erase(floor);
+        resident[floor] = map;
+        lru.push_front(floor);
+        if (fromDisk) ++stats.loadedFromDisk;
+        else ++stats.generated;
+        evictLocked();
+        stats.peakResident = max(stats.peakResident, resident.size());
+        lock.unlock();
+
+        done.set_value(map);
+        return map;
+    }
+
+    // 상주 층이 한도를 넘으면 가장 오래 안 쓴 층을 디스크로 (파일은 작아서 잠금 안에서 씀)
+    // 임시 파일에 다 쓴 뒤 rename → 실패해도 기존 파일은 그대로, 저장에 실패한 층은 상주로 남김
+    // (한도를 잠시 넘더라도 유일한 사본을 버리지 않음, 다음 축출 때 다시 시도)
+    void evictLocked() {
+        while (resident.size() > maxResident) {
+            int victim = lru.back();
+            shared_ptr<FloorMap> map = resident[victim];
+            if (map->isDirty() || !onDisk.count(victim)) {
+                fs::path tmp = pathFor(victim);
+                tmp += ".tmp";
+                try {
+                    uint64_t version = 0;
+                    size_t written = saveFloor(*map, tmp, &version);
+                    fs::rename(tmp, pathFor(victim));
+                    stats.diskBytes += written;
+                    map->markClean(version);
+                    onDisk.insert(victim);
+                } catch (const exception&) {
+                    ++stats.saveFailures;
+                    lru.pop_back();
+                    lru.push_front(victim);
+                    return;
+                }
+            }
+            lru.pop_back();
+            resident.erase(victim);
+            ++stats.pagedOut;
+        }
+    }
+
+    void prefetchLoop() {
+        while (true) {
+            int floor;
+            {
+                unique_lock<mutex> lock(mtx);
+                prefetchCv.wait(lock, [&] { return stopping || !prefetchQueue.empty(); });
+                if (stopping) return;
+                floor = prefetchQueue.front();
+                prefetchQueue.pop_front();
+                if (resident.count(floor) || inflight.count(floor) || failed.count(floor)) continue;
+            }
+            // 실패는 이 스레드에서 죽지 않고 층별로 보관 → 그 층에 들어가는 쪽이 예외를 받음
+            try {
+                acquire(floor);
+            } catch (...) {
+                lock_guard<mutex> lock(mtx);
+                failed[floor] = current_exception();
+            }
+        }
+    }
+};
+
+// [6] 데모와 측정
+double msSince(chrono::steady_clock::time_point t) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - t).count();
+}
+
+void preview(const FloorMap& map, int rows, int cols) {
+    for (int y = 0; y < rows; ++y) {
+        string line;
+        for (int x = 0; x < cols; ++x) line += map.walkable(x, y) ? '.' : '#';
+        cout << "  " << line << endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int size = argc > 1 ? stoi(argv[1]) : 1024;
+        int depth = argc > 2 ? stoi(argv[2]) : 20;
+        size_t threads = argc > 3 ? stoul(argv[3]) : max(1u, thread::hardware_concurrency());
+        if (size < kChunk || size % kChunk != 0 || size > 4096) {
+            throw invalid_argument("지도 크기는 64의 배수(64~4096)여야 합니다");
+        }
+        const uint64_t seed = 20261018;
+
+        cout << "=== 병렬 절차적 던전 생성 ===" << endl;
+        cout << "지도 " << size << "×" << size << ", 청크 " << kChunk << "×" << kChunk
+             << " (" << (size / kChunk) * (size / kChunk) << "개), 생성 스레드 " << threads << "개" << endl;
+
+        // 청크 병렬 생성이 스레드 수와 무관하게 같은 지도를 만드는지 확인
+        bool consistent = true;
+        for (int floor : {1, 3}) {
+            ChunkWorkers one(1), many(threads * 2);
+            auto t0 = chrono::steady_clock::now();
+            auto a = generateFloor(one, seed, floor, size);
+            double msOne = msSince(t0);
+            t0 = chrono::steady_clock::now();
+            auto b = generateFloor(many, seed, floor, size);
+            double msMany = msSince(t0);
+            bool same = a->hash() == b->hash();
+            consistent = consistent && same;
+            cout << "\n" << floor << "층 (" << (styleFor(floor) == FloorStyle::Cave ? "동굴" : "BSP 방")
+                 << "): 1 스레드 " << msOne << " ms, " << many.size() << " 스레드 " << msMany
+                 << " ms, 해시 " << (same ? "일치" : "불일치!") << endl;
+            preview(*a, 8, 64);
+        }
+
+        // 청크 경계 확인: 청크를 역순으로 만들어도 같아야 함 (이웃 청크 결과에 의존하지 않음)
+        {
+            ChunkWorkers one(1);
+            auto forward = generateFloor(one, seed, 2, size);
+            auto reversed = make_shared<FloorMap>(2, size);
+            int chunks = size / kChunk;
+            one.run(chunks * chunks, [&](int i) {
+                int j = chunks * chunks - 1 - i;
+                generateCaveChunk(*reversed, seed, j % chunks, j / chunks);
+            });
+            bool same = forward->hash() == reversed->hash();
+            consistent = consistent && same;
+            cout << "\n청크 생성 순서를 뒤집어도 같은 지도: " << (same ? "예" : "아니오!") << endl;
+        }
+
+        // 손상된 층 파일: 잘리거나 바이트가 바뀐 파일은 예외로 거부되거나, 범위 안의 지도로만 읽혀야 함
+        bool corruptRejected = true;
+        {
+            fs::path dir = fs::temp_directory_path() / ("floor_corrupt_" + to_string(::getpid()));
+            fs::create_directories(dir);
+            ChunkWorkers one(1);
+            size_t truncations = 0, mutations = 0, rejected = 0;
+            mt19937 rng(7);
+            for (int floor : {1, 3}) {
+                fs::path path = dir / "floor.bin";
+                saveFloor(*generateFloor(one, seed, floor, min(size, 256)), path);
+                ifstream in(path, ios::binary);
+                const vector<uint8_t> good((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+                auto tryLoad = [&](const vector<uint8_t>& bytes) {
+                    ofstream(path, ios::binary | ios::trunc).write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+                    try {
+                        loadFloor(path);
+                        return false;
+                    } catch (const runtime_error&) {
+                        return true;
+                    }
+                };
+                for (size_t len = 0; len < good.size(); len += 1 + good.size() / 300) {
+                    ++truncations;
+                    bool r = tryLoad(vector<uint8_t>(good.begin(), good.begin() + len));
+                    rejected += r;
+                    corruptRejected = corruptRejected && r;     // 잘린 파일은 반드시 거부
+                }
+                for (int i = 0; i < 300; ++i) {
+                    vector<uint8_t> bad = good;
+                    size_t at = i < 60 ? rng() % 16 : rng() % bad.size();     // 헤더를 더 자주 건드림
+                    bad[at] ^= uint8_t(1 + rng() % 255);
+                    ++mutations;
+                    rejected += tryLoad(bad);
+                }
+                int32_t hugeSize = 1 << 20;
+                vector<uint8_t> bad = good;
+                memcpy(bad.data() + 8, &hugeSize, 4);
+                ++mutations;
+                bool r = tryLoad(bad);
+                rejected += r;
+                corruptRejected = corruptRejected && r;
+            }
+            fs::remove_all(dir);
+            cout << "\n손상된 층 파일: 잘림 " << truncations << "개 + 바이트 변조 " << mutations << "개 중 "
+                 << rejected << "개 거부 (잘린 파일 모두 거부: " << (corruptRejected ? "예" : "아니오!") << ")" << endl;
+        }
+
+        // 디스크 장애: 쓰기 실패는 예외, 저장 못 한 층은 상주로 남고,
+        // 선행 로딩 스레드가 읽다 실패한 층은 프로세스를 죽이지 않고 그 층에 들어갈 때 예외로 전달
+        bool faultsHandled = true;
+        {
+            ChunkWorkers one(1);
+            bool fullRejected = false;
+            try {
+                saveFloor(*generateFloor(one, seed, 1, 128), "/dev/full");
+            } catch (const runtime_error&) {
+                fullRejected = true;
+            }
+
+            fs::path faultDir = fs::temp_directory_path() / ("floor_fault_" + to_string(::getpid()));
+            fs::create_directories(faultDir / "floor_1.bin.tmp");      // 1층 임시 파일을 못 만들게 막음
+            FloorStreamer streamer(seed, 128, 2, faultDir, one);
+            streamer.enter(1)->dig(5, 0);
+            streamer.enter(2);
+            streamer.enter(3);                                          // 1층을 내보내려다 실패
+            this_thread::sleep_for(chrono::milliseconds(200));          // 4층 선행 로딩이 끝나길 기다림
+            size_t failures = streamer.getStats().saveFailures;
+            bool kept = streamer.enter(1)->walkable(5, 0);       // 다시 생성됐다면 판 칸이 사라짐
+
+            fs::remove_all(faultDir / "floor_1.bin.tmp");
+            for (int floor = 5; floor <= 7; ++floor) streamer.enter(floor);    // 이번에는 1층이 디스크로
+            this_thread::sleep_for(chrono::milliseconds(200));
+            ofstream(faultDir / "floor_1.bin", ios::binary | ios::trunc) << "FLR1 garbage";
+            streamer.enter(0);                                          // 선행 로딩이 손상된 1층을 읽음
+            this_thread::sleep_for(chrono::milliseconds(200));
+            bool surfaced = false;
+            try {
+                streamer.enter(1);
+            } catch (const runtime_error& e) {
+                surfaced = true;
+                cout << "\n손상된 층 진입 → " << e.what() << endl;
+            }
+            faultsHandled = fullRejected && failures > 0 && kept && surfaced;
+            cout << "디스크 장애: /dev/full 쓰기 거부 " << (fullRejected ? "예" : "아니오!")
+                 << ", 저장 실패 " << failures << "회 동안 1층 상주 유지 " << (kept ? "예" : "아니오!")
+                 << ", 선행 로딩 실패를 진입 때 전달 " << (surfaced ? "예" : "아니오!") << endl;
+        }
+        fs::remove_all(fs::temp_directory_path() / ("floor_fault_" + to_string(::getpid())));
+
+        // 층 스트리밍: 내려가면서 층마다 벽을 하나 파고, 다시 올라가 변경이 보존됐는지 확인
+        cout << "\n=== 층 스트리밍 (상주 한도 3층) ===" << endl;
+        fs::path dir = fs::temp_directory_path() / ("floor_stream_" + to_string(::getpid()));
+        ChunkWorkers workers(threads);
+        vector<double> enterMs;
+        bool preserved = true;
+        {
+            FloorStreamer streamer(seed, size, 3, dir, workers);
+            for (int floor = 1; floor <= depth; ++floor) {
+                auto t0 = chrono::steady_clock::now();
+                auto map = streamer.enter(floor);
+                enterMs.push_back(msSince(t0));
+                map->dig(floor % size, 0);                 // 첫 행은 원래 대부분 벽
+                this_thread::sleep_for(chrono::milliseconds(100));  // 플레이어가 이 층을 탐험하는 시간
+            }
+            for (int floor : {depth / 2, 2, 1}) {
+                auto map = streamer.enter(floor);
+                preserved = preserved && map->walkable(floor % size, 0);
+            }
+            auto stats = streamer.getStats();
+            size_t raw = size_t(size) * size / 8;
+            cout << "생성 " << stats.generated << "층, 디스크에서 로드 " << stats.loadedFromDisk
+                 << "층, 페이지 아웃 " << stats.pagedOut << "회" << endl;
+            cout << "최대 상주 층 " << stats.peakResident << "개 (층당 비트셋 "
+                 << raw / 1024 << " KB), 디스크 기록 평균 "
+                 << stats.diskBytes / max<size_t>(1, stats.pagedOut) / 1024 << " KB/층" << endl;
+        }
+        fs::remove_all(dir);
+
+        double first = enterMs[0];
+        double sum = 0, worst = 0;
+        for (size_t i = 1; i < enterMs.size(); ++i) { sum += enterMs[i]; worst = max(worst, enterMs[i]); }
+        cout << "층 진입 대기: 첫 층 " << first << " ms (선행 로딩 없음), 이후 평균 "
+             << sum / max<size_t>(1, enterMs.size() - 1) << " ms, 최악 " << worst << " ms" << endl;
+        cout << "다시 올라간 층의 변경 보존: " << (preserved ? "예" : "아니오!") << endl;
+
+        return consistent && preserved && corruptRejected && faultsHandled ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
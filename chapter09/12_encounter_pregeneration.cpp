@@ -0,0 +1,498 @@
+/*
+ * 파일명: 12_encounter_pregeneration.cpp
+ *
+ * 주제: 다음 조우의 파이프라인 선행 생성 (Speculative Encounter Pregeneration)
+ * 정의: 플레이어가 전투 결과를 읽는 동안 백그라운드 작업자가 다음 전투에 필요한
+ *       몬스터, 전리품, 전투 지형을 미리 만들어 두어 "몬스터와 전투"를 고른 순간의
+ *       대기 시간을 거의 0으로 만드는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - Game::fight() 가 메뉴 선택 뒤에야 MonsterFactory::createRandomMonster() 를 호출
+ * - 생성이 무거워질수록(지형, 전리품 표, 연출 텍스트) 선택 직후의 멈춤이 길어짐
+ *
+ * 핵심 개념:
+ * - 추측 실행(speculation): 다음 조우의 키 = (던전 레벨, 세계 시각)
+ *   전투에서 이기면 레벨이 오르므로 전투 직후 새 키로 예약
+ * - 조우 난수는 키에서 유도 → 미리 만들든 그 자리에서 만들든 같은 몬스터가 나옴
+ * - 휴식/종료는 세계 시각을 바꾸거나 게임을 끝냄 → 진행 중인 작업은 협력적 취소,
+ *   완성된 결과는 버림 (잘못된 조우가 새어 나오지 않음)
+ * - 준비 중인 키를 요청하면 처음부터 다시 만들지 않고 끝나기를 기다림,
+ *   예약만 되고 아직 시작 전이면 예약을 가져와 직접 만듦 (휴식 직후 바로 전투) → 둘 다 "합류"
+ *   취소된 작업은 키가 같아도 합류/중복 예약 판단에서 제외 (작업 시작 때의 epoch 비교)
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o encounter 12_encounter_pregeneration.cpp
+ * 실행: ./encounter [행동 수] [결과를 읽는 시간(ms)]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+using namespace std;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] chapter08/game.cpp 의 캐릭터 (출력 없이 전투 규칙만)
+class Character {
+protected:
+    string name;
+    int health;
+    int maxHealth;
+    int attack;
+    int defense;
+
+public:
+    Character(const string& n, int hp, int att, int def)
+        : name(n), health(hp), maxHealth(hp), attack(att), defense(def) {}
+    virtual ~Character() = default;
+
+    void takeDamage(int damage) {
+        health = max(0, health - max(1, damage - defense));
+    }
+    void heal(int amount) { health = min(maxHealth, health + amount); }
+
+    bool isAlive() const { return health > 0; }
+    const string& getName() const { return name; }
+    int getHealth() const { return health; }
+    int getMaxHealth() const { return maxHealth; }
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+};
+
+class Player : public Character {
+private:
+    int level = 1;
+    int experience = 0;
+    int gold = 50;
+
+public:
+    explicit Player(const string& n) : Character(n, 100, 20, 5) {}
+
+    void gainExperience(int exp) {
+        experience += exp;
+        if (experience >= level * 100) {      // Player::levelUp 과 같은 성장
+            level++;
+            maxHealth += 20;
+            health = maxHealth;
+            attack += 5;
+            defense += 2;
+        }
+    }
+    void addGold(int amount) { gold += amount; }
+    bool spendGold(int amount) {
+        if (gold < amount) return false;
+        gold -= amount;
+        return true;
+    }
+    void revive() { health = maxHealth; }
+
+    int getLevel() const { return level; }
+    int getGold() const { return gold; }
+};
+
+class Monster : public Character {
+private:
+    int expReward;
+    int goldReward;
+
+public:
+    Monster(const string& n, int hp, int att, int def, int exp, int gold)
+        : Character(n, hp, att, def), expReward(exp), goldReward(gold) {}
+    int getExpReward() const { return expReward; }
+    int getGoldReward() const { return goldReward; }
+};
+
+// [2] 조우 하나에 필요한 모든 것 (미리 만들어 둘 대상)
+struct EncounterKey {
+    int dungeonLevel;
+    uint64_t worldTime;     // 휴식할 때마다 증가
+    bool operator==(const EncounterKey& o) const {
+        return dungeonLevel == o.dungeonLevel && worldTime == o.worldTime;
+    }
+};
+
+struct PreparedEncounter {
+    EncounterKey key;
+    unique_ptr<Monster> monster;
+    int bonusGold = 0;              // 전리품 굴림 결과
+    string lootName;
+    vector<uint8_t> arena;          // 전투 지형 (셀룰러 오토마타 동굴)
+    int arenaSize = 0;
+    int openTiles = 0;
+    string introduction;            // 미리 조립한 등장 문구
+    uint64_t battleSeed = 0;
+};
+
+unique_ptr<Monster> rollMonster(mt19937_64& gen, int dungeonLevel) {
+    int lv = max(1, dungeonLevel);
+    switch (gen() % 4) {      // MonsterFactory::createRandomMonster 와 같은 수치
+        case 0: return make_unique<Monster>("슬라임", 30 + lv * 10, 8 + lv * 2, 1 + lv, 20 + lv * 5, 10 + lv * 3);
+        case 1: return make_unique<Monster>("고블린", 50 + lv * 15, 12 + lv * 3, 3 + lv, 35 + lv * 8, 20 + lv * 5);
+        case 2: return make_unique<Monster>("오크", 80 + lv * 20, 18 + lv * 4, 5 + lv * 2, 50 + lv * 10, 35 + lv * 7);
+        default: return make_unique<Monster>("드래곤", 150 + lv * 30, 25 + lv * 5, 8 + lv * 3, 100 + lv * 15, 75 + lv * 10);
+    }
+}
+
+// 조우 생성 (무거운 부분은 지형). cancelled() 가 true 를 돌려주면 중간에 포기
+template <typename CancelFn>
+unique_ptr<PreparedEncounter> prepareEncounter(uint64_t seed, EncounterKey key, int arenaSize,
+                                               CancelFn cancelled) {
+    auto enc = make_unique<PreparedEncounter>();
+    enc->key = key;
+    mt19937_64 gen(mix64(seed ^ mix64(uint64_t(key.dungeonLevel) << 32 ^ key.worldTime)));
+
+    enc->monster = rollMonster(gen, key.dungeonLevel);
+    static const char* loot[] = {"낡은 동전 주머니", "빛나는 보석", "녹슨 열쇠", "마법 두루마리"};
+    enc->lootName = loot[gen() % 4];
+    enc->bonusGold = static_cast<int>(gen() % (5 * key.dungeonLevel + 1));
+    enc->battleSeed = gen();
+
+    // 전투 지형: 동굴 오토마타 4회 (한 단계마다 취소 확인)
+    int n = arenaSize;
+    enc->arenaSize = n;
+    enc->arena.resize(size_t(n) * n);
+    vector<uint8_t> next(enc->arena.size());
+    for (auto& c : enc->arena) c = gen() % 100 < 45;
+    for (int step = 0; step < 4; ++step) {
+        if (cancelled()) return nullptr;
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                int walls = 0;
+                for (int dy = -1; dy <= 1; ++dy)
+                    for (int dx = -1; dx <= 1; ++dx) {
+                        int nx = x + dx, ny = y + dy;
+                        walls += (nx < 0 || ny < 0 || nx >= n || ny >= n) ? 1 : enc->arena[size_t(ny) * n + nx];
+                    }
+                next[size_t(y) * n + x] = walls >= 5;
+            }
+        }
+        swap(enc->arena, next);
+    }
+    enc->openTiles = static_cast<int>(count(enc->arena.begin(), enc->arena.end(), 0));
+
+    const Monster& m = *enc->monster;
+    enc->introduction = m.getName() + "이(가) 나타났습니다! (체력 " + to_string(m.getHealth())
+                        + ", 공격력 " + to_string(m.getAttack()) + ", 방어력 " + to_string(m.getDefense())
+                        + ") 전장의 열린 칸 " + to_string(enc->openTiles) + "개";
+    return enc;
+}
+
+// [3] 선행 생성기: 작업자 스레드 하나, 예약은 항상 "가장 최근 키" 하나
+class EncounterPrefetcher {
+public:
+    struct Stats {
+        size_t hits = 0;            // 완성된 결과를 바로 받음
+        size_t joined = 0;          // 만드는 중이거나 막 예약된 결과를 가져옴 (기다리거나 직접 만듦)
+        size_t misses = 0;          // 그 자리에서 생성
+        size_t discarded = 0;       // 휴식/종료/키 불일치로 버린 결과
+        size_t cancelled = 0;       // 중간에 취소된 작업
+    };
+
+private:
+    uint64_t seed;
+    int arenaSize;
+    thread worker;
+    mutex mtx;
+    condition_variable cv;
+
+    bool hasRequest = false;
+    EncounterKey requested{0, 0};
+    bool building = false;
+    EncounterKey buildingKey{0, 0};
+    uint64_t buildingEpoch = 0;     // 작업 시작 때의 epoch, 지금 epoch 와 다르면 취소된 작업
+    unique_ptr<PreparedEncounter> ready;
+    atomic<uint64_t> epoch{0};      // 바뀌면 진행 중인 작업은 무효
+    bool stopping = false;
+    Stats stats;
+
+public:
+    EncounterPrefetcher(uint64_t s, int arena) : seed(s), arenaSize(arena) {
+        worker = thread(&EncounterPrefetcher::loop, this);
+    }
+
+    ~EncounterPrefetcher() {
+        {
+            lock_guard<mutex> lock(mtx);
+            stopping = true;
+            epoch.fetch_add(1);
+        }
+        cv.notify_all();
+        worker.join();
+    }
+
+    EncounterPrefetcher(const EncounterPrefetcher&) = delete;
+    EncounterPrefetcher& operator=(const EncounterPrefetcher&) = delete;
+
+    // 다음 조우를 예약 (이전 예약과 완성본은 버림)
+    void speculate(EncounterKey key) {
+        {
+            lock_guard<mutex> lock(mtx);
+            if ((ready && ready->key == key) || (hasRequest && requested == key) || buildingLiveLocked(key)) return;
+            dropLocked();
+            hasRequest = true;
+            requested = key;
+        }
+        cv.notify_all();
+    }
+
+    // 휴식/종료: 예약, 진행 중인 작업, 완성본을 모두 버림
+    void discard() {
+        lock_guard<mutex> lock(mtx);
+        dropLocked();
+    }
+
+    // 메뉴에서 "몬스터와 전투"를 고른 순간 호출
+    unique_ptr<PreparedEncounter> take(EncounterKey key) {
+        unique_lock<mutex> lock(mtx);
+        if (ready && ready->key == key) {
+            ++stats.hits;
+            return move(ready);
+        }
+        if (buildingLiveLocked(key)) {          // 작업자가 만드는 중 → 끝나기를 기다림
+            cv.wait(lock, [&] { return !building || (ready && ready->key == key); });
+            if (ready && ready->key == key) {
+                ++stats.joined;
+                return move(ready);
+            }
+        }
+        // 예약만 되고 작업자가 아직 집어 가지 않음 (휴식 직후 바로 전투) → 예약을 가져와 직접 만듦
+        // 작업자가 취소된 이전 작업을 마무리하는 중이어도 기다리지 않음
+        bool claimed = hasRequest && requested == key;
+        dropLocked();
+        ++(claimed ? stats.joined : stats.misses);
+        lock.unlock();
+        return prepareEncounter(seed, key, arenaSize, [] { return false; });
+    }
+
+    Stats getStats() {
+        lock_guard<mutex> lock(mtx);
+        return stats;
+    }
+
+private:
+    bool buildingLiveLocked(EncounterKey key) const {
+        return building && buildingKey == key && buildingEpoch == epoch.load();
+    }
+
+    void dropLocked() {
+        if (ready) {
+            ready.reset();
+            ++stats.discarded;
+        }
+        hasRequest = false;
+        if (building) epoch.fetch_add(1);       // 작업자가 다음 단계에서 포기
+    }
+
+    void loop() {
+        unique_lock<mutex> lock(mtx);
+        while (true) {
+            cv.wait(lock, [&] { return stopping || hasRequest; });
+            if (stopping) return;
+
+            EncounterKey key = requested;
+            hasRequest = false;
+            building = true;
+            buildingKey = key;
+            uint64_t myEpoch = buildingEpoch = epoch.load();
+            lock.unlock();
+
+            auto enc = prepareEncounter(seed, key, arenaSize,
+                                        [&] { return epoch.load(memory_order_relaxed) != myEpoch; });
+
+            lock.lock();
+            building = false;
+            if (enc && epoch.load() == myEpoch) {
+                ready = move(enc);
+            } else {
+                ++stats.cancelled;
+            }
+            cv.notify_all();
+        }
+    }
+};
+
+// [4] 전투 (BattleSystem::battle 의 규칙, 출력 없음)
+bool battle(Player& player, Monster& monster, uint64_t battleSeed) {
+    mt19937_64 gen(battleSeed);
+    while (player.isAlive() && monster.isAlive()) {
+        monster.takeDamage(max(1, player.getAttack() - 5 + int(gen() % 11)));
+        if (!monster.isAlive()) break;
+        player.takeDamage(max(1, monster.getAttack() - 3 + int(gen() % 7)));
+    }
+    return player.isAlive();
+}
+
+// [5] 대본대로 플레이하는 게임 (결과를 읽는 시간은 sleep 으로 흉내)
+struct SessionResult {
+    vector<double> fightLatencyUs;  // 메뉴 선택 → 몬스터 등장 문구 준비 완료
+    uint64_t fingerprint = 0;
+    int finalLevel = 0;
+    int finalDungeon = 0;
+    EncounterPrefetcher::Stats stats;
+    double quitMs = 0;
+};
+
+class Game {
+private:
+    uint64_t seed;
+    Player player{"용사"};
+    int dungeonLevel = 1;
+    uint64_t worldTime = 0;
+    unique_ptr<EncounterPrefetcher> prefetcher;    // nullptr 이면 원래처럼 동기 생성
+    int arenaSize;
+
+public:
+    Game(uint64_t s, bool pipelined, int arena) : seed(s), arenaSize(arena) {
+        if (pipelined) {
+            prefetcher = make_unique<EncounterPrefetcher>(seed, arenaSize);
+            prefetcher->speculate(currentKey());
+        }
+    }
+
+    EncounterKey currentKey() const { return {dungeonLevel, worldTime}; }
+
+    // 메뉴 1번
+    double fight(uint64_t& fingerprint, bool verbose) {
+        auto t0 = chrono::steady_clock::now();
+        unique_ptr<PreparedEncounter> enc = prefetcher
+            ? prefetcher->take(currentKey())
+            : prepareEncounter(seed, currentKey(), arenaSize, [] { return false; });
+        double us = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+        if (verbose) cout << "  " << enc->introduction << endl;
+
+        if (battle(player, *enc->monster, enc->battleSeed)) {
+            player.gainExperience(enc->monster->getExpReward());
+            player.addGold(enc->monster->getGoldReward() + enc->bonusGold);
+            dungeonLevel++;
+        } else {
+            player.revive();        // 측정을 계속하기 위해 게임 오버 대신 부활
+            dungeonLevel = max(1, dungeonLevel - 1);
+        }
+        fingerprint = mix64(fingerprint ^ uint64_t(enc->monster->getHealth())
+                            ^ uint64_t(player.getHealth()) << 16 ^ uint64_t(dungeonLevel) << 40);
+
+        if (prefetcher) prefetcher->speculate(currentKey());   // 결과를 읽는 동안 다음 조우 준비
+        return us;
+    }
+
+    // 메뉴 4번: 세계 시각이 흐르므로 준비해 둔 조우는 무효
+    void rest() {
+        ++worldTime;
+        if (prefetcher) prefetcher->discard();
+        if (player.spendGold(20)) player.heal(player.getMaxHealth());
+        if (prefetcher) prefetcher->speculate(currentKey());
+    }
+
+    // 메뉴 5번: 진행 중인 생성을 취소하고 작업자를 정리
+    double quit() {
+        auto t0 = chrono::steady_clock::now();
+        prefetcher.reset();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+
+    EncounterPrefetcher::Stats stats() const {
+        return prefetcher ? prefetcher->getStats() : EncounterPrefetcher::Stats{};
+    }
+    int getDungeonLevel() const { return dungeonLevel; }
+    int getPlayerLevel() const { return player.getLevel(); }
+};
+
+SessionResult playSession(bool pipelined, int actions, int readMs, int arenaSize, bool verbose) {
+    SessionResult result;
+    Game game(777, pipelined, arenaSize);
+    mt19937 script(2024);           // 같은 대본: 두 모드가 같은 행동을 함
+    for (int a = 0; a < actions; ++a) {
+        if (script() % 5 == 0) {
+            game.rest();
+            // 휴식 직후 바로 전투를 고르는 경우도 섞음 (이때는 준비 중인 작업에 합류)
+            if (script() % 2) this_thread::sleep_for(chrono::milliseconds(readMs));
+        } else {
+            result.fightLatencyUs.push_back(game.fight(result.fingerprint, verbose && a < 4));
+            this_thread::sleep_for(chrono::milliseconds(readMs));   // 전투 결과를 읽는 시간
+        }
+    }
+    result.finalLevel = game.getPlayerLevel();
+    result.finalDungeon = game.getDungeonLevel();
+    result.stats = game.stats();
+    // 종료 직전 새 예약을 걸어 두어, 진행 중인 작업이 있는 상태에서의 종료 시간을 잰다
+    game.rest();
+    result.quitMs = game.quit();
+    return result;
+}
+
+void report(const string& label, SessionResult& r) {
+    vector<double>& v = r.fightLatencyUs;
+    sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) sum += x;
+    cout << label << ": 전투 선택 지연 평균 " << sum / v.size() / 1000.0 << " ms, 중앙값 "
+         << v[v.size() / 2] / 1000.0 << " ms, p99 " << v[v.size() * 99 / 100] / 1000.0
+         << " ms (전투 " << v.size() << "회)" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int actions = argc > 1 ? stoi(argv[1]) : 120;
+        int readMs = argc > 2 ? stoi(argv[2]) : 15;
+        const int arenaSize = 384;
+
+        cout << "=== 다음 조우 선행 생성 ===" << endl;
+        cout << "행동 " << actions << "회, 결과를 읽는 시간 " << readMs << " ms, 전장 "
+             << arenaSize << "×" << arenaSize << endl << endl;
+
+        SessionResult sync = playSession(false, actions, readMs, arenaSize, true);
+        SessionResult piped = playSession(true, actions, readMs, arenaSize, false);
+
+        cout << endl;
+        report("동기 생성 ", sync);
+        report("선행 생성 ", piped);
+        const auto& s = piped.stats;
+        cout << "선행 생성 통계: 바로 받음 " << s.hits << ", 합류 " << s.joined << ", 즉석 생성 "
+             << s.misses << ", 버림 " << s.discarded << ", 취소 " << s.cancelled << endl;
+        cout << "진행 중인 작업이 있을 때 종료까지: " << piped.quitMs << " ms" << endl;
+
+        // 같은 키를 취소 직후 다시 예약: 취소된 작업에 묶이지 않고 새로 만들어져야 함
+        bool respeculated = true;
+        {
+            EncounterPrefetcher p(99, arenaSize);
+            for (int i = 0; i < 5; ++i) {
+                EncounterKey key{3, uint64_t(i)};
+                p.speculate(key);
+                this_thread::sleep_for(chrono::milliseconds(2));      // 작업자가 만들기 시작하도록
+                p.discard();
+                p.speculate(key);
+                this_thread::sleep_for(chrono::milliseconds(readMs * 2));
+                p.take(key);
+            }
+            auto ps = p.getStats();
+            respeculated = ps.misses == 0 && ps.hits + ps.joined == 5;
+            cout << "취소 직후 같은 키 재예약: 바로 받음 " << ps.hits << ", 합류 " << ps.joined
+                 << ", 즉석 생성 " << ps.misses << " → " << (respeculated ? "정상" : "실패!") << endl;
+        }
+
+        bool same = sync.fingerprint == piped.fingerprint && sync.finalDungeon == piped.finalDungeon
+                    && sync.finalLevel == piped.finalLevel;
+        cout << "두 모드의 게임 결과 (던전 " << piped.finalDungeon << "층, 레벨 " << piped.finalLevel
+             << "): " << (same ? "동일" : "다름!") << endl;
+        if (s.misses != 0) cout << "선행 생성 모드에서 즉석 생성이 나오면 안 됨!" << endl;
+        return same && respeculated && s.misses == 0 ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,477 @@
+/*
+ * 파일명: 13_diff_terminal_renderer.cpp
+ *
+ * 주제: 차이만 출력하는 이중 버퍼 터미널 렌더러 (Diff-based Double-buffered Renderer)
+ * 정의: 화면을 메모리 속 셀 격자에 먼저 그리고, 터미널에 이미 보이는 이전 프레임과 비교하여
+ *       바뀐 칸에 대해서만 최소한의 ANSI 커서 이동/색 변경/문자를 만들어 write 한 번으로 내보내는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - showMainMenu, Player::displayInfo, showInventory 가 매번 모든 줄을 endl 로 출력
+ * - endl 은 줄마다 flush → 느린 SSH 에서는 매 턴 전체 화면 + 줄 수만큼의 시스템 호출
+ *
+ * 핵심 개념:
+ * - 이중 버퍼: front = 터미널에 보이는 것, back = 이번 프레임. 비교 후 back 을 front 로 복사
+ * - 셀 = (문자, 글자색, 배경색, 굵게, 종류). 한글은 2칸 → "앞 칸" + "이어지는 칸"으로 저장
+ * - 폭 계산: 한글 음절/자모, CJK, 전각 문자는 2칸 (wcwidth 와 같은 규칙의 축약판)
+ * - 한 칸만 바뀐 2칸 문자도 앞 칸부터 통째로 다시 출력, 줄 끝에 걸친 2칸 문자는 공백으로 대체
+ * - 커서 추적: 바로 다음 칸이면 이동 생략, 같은 줄이면 짧은 상대 이동(CSI n C), 아니면 절대 이동
+ * - 출력 검증: 내보낸 바이트를 작은 터미널 에뮬레이터로 재생하여 back 버퍼와 같은지 확인
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o renderer 13_diff_terminal_renderer.cpp
+ * 실행: ./renderer [턴 수]            (측정만)
+ *       ./renderer [턴 수] --live     (터미널에서 실제로 그리기)
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <cerrno>
+#include <cctype>
+#include <fcntl.h>
+#include <unistd.h>
+using namespace std;
+
+// [1] UTF-8 과 표시 폭
+int displayWidth(char32_t c) {
+    if (c < 0x20) return 0;
+    if ((c >= 0x1100 && c <= 0x115F) ||          // 한글 자모 (초성)
+        (c >= 0x2E80 && c <= 0xA4CF && c != 0x303F) ||   // CJK 부수 ~ 이(Yi) 음절
+        (c >= 0xAC00 && c <= 0xD7A3) ||          // 한글 음절
+        (c >= 0xF900 && c <= 0xFAFF) ||          // CJK 호환 한자
+        (c >= 0xFE30 && c <= 0xFE4F) ||
+        (c >= 0xFF00 && c <= 0xFF60) ||          // 전각 문자
+        (c >= 0xFFE0 && c <= 0xFFE6)) {
+        return 2;
+    }
+    return 1;
+}
+
+// 잘못된 바이트는 U+FFFD 로 바꾸며 한 글자씩 읽음
+char32_t decodeUtf8(const string& s, size_t& i) {
+    unsigned char b = s[i];
+    int extra = b < 0x80 ? 0 : (b >> 5) == 0x6 ? 1 : (b >> 4) == 0xE ? 2 : (b >> 3) == 0x1E ? 3 : -1;
+    if (extra < 0) { ++i; return 0xFFFD; }
+    char32_t c = extra == 0 ? b : b & (0x3F >> extra);
+    ++i;
+    for (int k = 0; k < extra; ++k, ++i) {
+        if (i >= s.size() || (static_cast<unsigned char>(s[i]) & 0xC0) != 0x80) return 0xFFFD;
+        c = (c << 6) | (static_cast<unsigned char>(s[i]) & 0x3F);
+    }
+    return c;
+}
+
+void encodeUtf8(string& out, char32_t c) {
+    if (c < 0x80) {
+        out += char(c);
+    } else if (c < 0x800) {
+        out += char(0xC0 | (c >> 6));
+        out += char(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += char(0xE0 | (c >> 12));
+        out += char(0x80 | ((c >> 6) & 0x3F));
+        out += char(0x80 | (c & 0x3F));
+    } else {
+        out += char(0xF0 | (c >> 18));
+        out += char(0x80 | ((c >> 12) & 0x3F));
+        out += char(0x80 | ((c >> 6) & 0x3F));
+        out += char(0x80 | (c & 0x3F));
+    }
+}
+
+// [2] 셀과 화면 버퍼
+enum Color : uint8_t { Black, Red, Green, Yellow, Blue, Magenta, Cyan, White, Default = 9 };
+
+struct Style {
+    uint8_t fg = Default;
+    uint8_t bg = Default;
+    bool bold = false;
+    bool operator==(const Style& o) const { return fg == o.fg && bg == o.bg && bold == o.bold; }
+    bool operator!=(const Style& o) const { return !(*this == o); }
+};
+
+enum class CellKind : uint8_t { Narrow, WideLead, WideTail };
+
+struct Cell {
+    char32_t ch = U' ';
+    Style style;
+    CellKind kind = CellKind::Narrow;
+    bool operator==(const Cell& o) const { return ch == o.ch && style == o.style && kind == o.kind; }
+    bool operator!=(const Cell& o) const { return !(*this == o); }
+};
+
+class ScreenBuffer {
+private:
+    int width;
+    int height;
+    vector<Cell> cells;
+
+public:
+    ScreenBuffer(int w, int h) : width(w), height(h), cells(size_t(w) * h) {}
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    Cell& at(int x, int y) { return cells[size_t(y) * width + x]; }
+    const Cell& at(int x, int y) const { return cells[size_t(y) * width + x]; }
+
+    void clear() { fill(cells.begin(), cells.end(), Cell{}); }
+
+    // 한 칸 쓰기: 2칸 문자의 반쪽을 덮으면 나머지 반쪽은 공백이 됨 (실제 터미널과 같은 동작)
+    void put(int x, int y, char32_t ch, Style style) {
+        int w = displayWidth(ch);
+        if (w == 0 || y < 0 || y >= height || x < 0 || x >= width) return;
+        if (w == 2 && x + 1 >= width) { ch = U' '; w = 1; }   // 줄 끝에 걸침 → 공백
+
+        breakWide(x, y);
+        if (w == 2) breakWide(x + 1, y);
+        at(x, y) = {ch, style, w == 2 ? CellKind::WideLead : CellKind::Narrow};
+        if (w == 2) at(x + 1, y) = {U' ', style, CellKind::WideTail};
+    }
+
+    // 문자열 쓰기, 차지한 칸 수를 반환
+    int text(int x, int y, const string& utf8, Style style = {}) {
+        int start = x;
+        for (size_t i = 0; i < utf8.size();) {
+            char32_t c = decodeUtf8(utf8, i);
+            if (x >= width) break;
+            put(x, y, c, style);
+            x += displayWidth(c);
+        }
+        return x - start;
+    }
+
+    void fillRow(int y, int x0, int x1, char32_t ch, Style style = {}) {
+        for (int x = x0; x < x1; ++x) put(x, y, ch, style);
+    }
+
+private:
+    void breakWide(int x, int y) {
+        Cell& c = at(x, y);
+        if (c.kind == CellKind::WideLead && x + 1 < width) at(x + 1, y) = Cell{U' ', c.style, CellKind::Narrow};
+        if (c.kind == CellKind::WideTail && x > 0) at(x - 1, y) = Cell{U' ', c.style, CellKind::Narrow};
+        c.kind = CellKind::Narrow;
+    }
+};
+
+// [3] 차이 렌더러
+class DiffRenderer {
+private:
+    ScreenBuffer front;     // 터미널에 보이는 내용 (우리가 아는 한)
+    ScreenBuffer back;      // 그리는 중인 다음 프레임
+    string out;             // 한 프레임의 출력 (재사용하여 할당을 줄임)
+    int cursorX = -1, cursorY = -1;     // -1 = 모름
+    Style currentStyle;
+    bool firstFrame = true;
+    int fd;
+
+public:
+    size_t bytesWritten = 0;
+    size_t writeCalls = 0;
+    size_t cellsEmitted = 0;
+
+    DiffRenderer(int w, int h, int outputFd) : front(w, h), back(w, h), fd(outputFd) {
+        out.reserve(size_t(w) * h * 4);
+    }
+
+    ScreenBuffer& canvas() { return back; }
+    const string& lastFrame() const { return out; }
+
+    // back 과 front 를 비교해 바뀐 칸만 내보냄 → write 한 번
+    void present() {
+        out.clear();
+        if (firstFrame) {
+            out += "\x1b[?25l\x1b[0m\x1b[2J";       // 커서 숨김, 스타일 초기화, 화면 지우기
+            front.clear();
+            currentStyle = Style{};
+            cursorX = cursorY = -1;
+            firstFrame = false;
+        }
+
+        for (int y = 0; y < back.getHeight(); ++y) {
+            for (int x = 0; x < back.getWidth(); ++x) {
+                const Cell& b = back.at(x, y);
+                bool changed = b != front.at(x, y);
+                if (b.kind == CellKind::WideLead) changed = changed || back.at(x + 1, y) != front.at(x + 1, y);
+                if (!changed) continue;
+
+                int lead = x;
+                if (b.kind == CellKind::WideTail) lead = x - 1;     // 뒤쪽 반만 바뀜 → 앞 칸부터
+                emitCell(lead, y);
+                if (back.at(lead, y).kind == CellKind::WideLead) x = lead + 1;
+            }
+        }
+        if (currentStyle != Style{}) {      // 프레임 밖의 출력이 색을 물려받지 않도록
+            out += "\x1b[0m";
+            currentStyle = Style{};
+        }
+        front = back;
+
+        if (!out.empty()) {
+            size_t done = 0;
+            while (done < out.size()) {
+                ssize_t n = ::write(fd, out.data() + done, out.size() - done);
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    throw runtime_error(string("터미널 출력 실패: ") + strerror(errno));
+                }
+                done += size_t(n);
+            }
+            bytesWritten += out.size();
+            ++writeCalls;
+        }
+    }
+
+    void shutdown() {
+        string bye = "\x1b[0m\x1b[" + to_string(back.getHeight() + 1) + ";1H\x1b[?25h";
+        if (::write(fd, bye.data(), bye.size()) < 0) { /* 종료 중이므로 무시 */ }
+    }
+
+private:
+    void moveTo(int x, int y) {
+        if (x == cursorX && y == cursorY) return;
+        string absolute = "\x1b[" + to_string(y + 1) + ";" + to_string(x + 1) + "H";
+        if (y == cursorY && x > cursorX) {
+            int gap = x - cursorX;
+            string relative = gap == 1 ? "\x1b[C" : "\x1b[" + to_string(gap) + "C";
+            // 사이 칸이 모두 같은 스타일의 1칸 문자이고 짧으면 다시 출력하는 편이 더 짧음
+            bool reprint = gap <= 3;
+            for (int k = cursorX; reprint && k < x; ++k) {
+                const Cell& c = back.at(k, y);
+                reprint = c.kind == CellKind::Narrow && c.ch < 0x80 && c.style == currentStyle;
+            }
+            if (reprint) {
+                for (int k = cursorX; k < x; ++k) out += char(back.at(k, y).ch);
+            } else {
+                out += relative.size() < absolute.size() ? relative : absolute;
+            }
+        } else {
+            out += absolute;
+        }
+        cursorX = x;
+        cursorY = y;
+    }
+
+    void setStyle(const Style& s) {
+        if (s == currentStyle) return;
+        out += "\x1b[0";
+        if (s.bold) out += ";1";
+        if (s.fg != Default) { out += ";3"; out += char('0' + s.fg); }
+        if (s.bg != Default) { out += ";4"; out += char('0' + s.bg); }
+        out += 'm';
+        currentStyle = s;
+    }
+
+    void emitCell(int x, int y) {
+        const Cell& c = back.at(x, y);
+        moveTo(x, y);
+        setStyle(c.style);
+        encodeUtf8(out, c.ch);
+        ++cellsEmitted;
+        cursorX += c.kind == CellKind::WideLead ? 2 : 1;
+        if (cursorX >= back.getWidth()) cursorX = cursorY = -1;   // 줄 끝의 자동 줄바꿈 보류 상태는 믿지 않음
+    }
+};
+
+// [4] 검증용 미니 터미널: 렌더러의 출력을 해석하여 화면을 재구성
+class VirtualTerminal {
+private:
+    ScreenBuffer screen;
+    int x = 0, y = 0;
+    Style style;
+
+public:
+    VirtualTerminal(int w, int h) : screen(w, h) {}
+
+    void feed(const string& bytes) {
+        for (size_t i = 0; i < bytes.size();) {
+            if (bytes[i] == '\x1b' && i + 1 < bytes.size() && bytes[i + 1] == '[') {
+                i += 2;
+                bool priv = i < bytes.size() && bytes[i] == '?';
+                if (priv) ++i;
+                vector<int> params{0};
+                while (i < bytes.size() && (isdigit(static_cast<unsigned char>(bytes[i])) || bytes[i] == ';')) {
+                    if (bytes[i] == ';') params.push_back(0);
+                    else params.back() = params.back() * 10 + (bytes[i] - '0');
+                    ++i;
+                }
+                char cmd = bytes[i++];
+                if (priv) continue;
+                if (cmd == 'H') { y = max(1, params[0]) - 1; x = max(1, params.size() > 1 ? params[1] : 1) - 1; }
+                else if (cmd == 'C') x += max(1, params[0]);
+                else if (cmd == 'J') screen.clear();
+                else if (cmd == 'm') {
+                    for (int p : params) {
+                        if (p == 0) style = Style{};
+                        else if (p == 1) style.bold = true;
+                        else if (p >= 30 && p <= 37) style.fg = uint8_t(p - 30);
+                        else if (p >= 40 && p <= 47) style.bg = uint8_t(p - 40);
+                    }
+                }
+                continue;
+            }
+            char32_t c = decodeUtf8(bytes, i);
+            if (x < screen.getWidth()) screen.put(x, y, c, style);
+            x += displayWidth(c);
+        }
+    }
+
+    bool matches(const ScreenBuffer& expected) const {
+        for (int row = 0; row < expected.getHeight(); ++row)
+            for (int col = 0; col < expected.getWidth(); ++col)
+                if (screen.at(col, row) != expected.at(col, row)) return false;
+        return true;
+    }
+};
+
+// [5] 게임 화면: 메인 메뉴 + 상태 + 인벤토리 + 전투 기록
+struct GameView {
+    string name = "용사";
+    int level = 1, health = 100, maxHealth = 100, attack = 20, defense = 5;
+    int experience = 0, gold = 50, dungeonLevel = 1;
+    vector<pair<string, int>> inventory{{"체력 포션", 2}, {"강철 검", 1}};
+    vector<string> log;
+};
+
+// 원래 방식: 모든 줄을 endl 로 출력 (줄마다 flush = write 한 번)
+string drawWithEndl(const GameView& v, size_t& flushes) {
+    vector<string> lines;
+    lines.push_back("=== 메인 메뉴 ===");
+    lines.push_back("던전 레벨: " + to_string(v.dungeonLevel));
+    lines.push_back("=== " + v.name + " 정보 ===");
+    lines.push_back("레벨: " + to_string(v.level));
+    lines.push_back("체력: " + to_string(v.health) + "/" + to_string(v.maxHealth));
+    lines.push_back("공격력: " + to_string(v.attack) + " | 방어력: " + to_string(v.defense));
+    lines.push_back("경험치: " + to_string(v.experience) + "/" + to_string(v.level * 100));
+    lines.push_back("골드: " + to_string(v.gold));
+    lines.push_back("=== 인벤토리 ===");
+    for (size_t i = 0; i < v.inventory.size(); ++i)
+        lines.push_back(to_string(i + 1) + ". " + v.inventory[i].first + " x" + to_string(v.inventory[i].second));
+    for (const string& l : v.log) lines.push_back(l);
+    lines.push_back("1. 몬스터와 전투");
+    lines.push_back("2. 상태 확인");
+    lines.push_back("3. 인벤토리");
+    lines.push_back("4. 휴식 (체력 회복)");
+    lines.push_back("5. 게임 종료");
+    string all;
+    for (const string& l : lines) all += l + "\n";
+    flushes += lines.size();
+    return all;
+}
+
+void drawScreen(ScreenBuffer& s, const GameView& v) {
+    const Style title{Yellow, Default, true}, label{Cyan, Default, false}, frame{Blue, Default, false};
+    s.clear();
+    int w = s.getWidth();
+    s.fillRow(0, 0, w, U'=', frame);
+    s.text(2, 0, " 메인 메뉴 ", title);
+    s.text(w - 20, 0, " 던전 레벨: " + to_string(v.dungeonLevel) + " ", title);
+
+    s.text(2, 2, v.name + " (레벨 " + to_string(v.level) + ")", Style{White, Default, true});
+    s.text(2, 3, "체력", label);
+    int bar = 30 * v.health / max(1, v.maxHealth);
+    Style hp{uint8_t(v.health * 3 < v.maxHealth ? Red : Green), Default, false};
+    s.fillRow(3, 8, 8 + bar, U'#', hp);
+    s.fillRow(3, 8 + bar, 38, U'.', Style{});
+    s.text(40, 3, to_string(v.health) + "/" + to_string(v.maxHealth));
+    s.text(2, 4, "공격력", label);
+    s.text(10, 4, to_string(v.attack));
+    s.text(16, 4, "방어력", label);
+    s.text(24, 4, to_string(v.defense));
+    s.text(30, 4, "골드", label);
+    s.text(36, 4, to_string(v.gold), Style{Yellow, Default, false});
+    s.text(2, 5, "경험치 " + to_string(v.experience) + "/" + to_string(v.level * 100));
+
+    s.text(54, 2, "인벤토리", title);
+    for (size_t i = 0; i < v.inventory.size() && i < 4; ++i) {
+        s.text(54, 3 + int(i), to_string(i + 1) + ". " + v.inventory[i].first + " x" + to_string(v.inventory[i].second));
+    }
+
+    s.fillRow(7, 0, w, U'-', frame);
+    for (size_t i = 0; i < v.log.size(); ++i) s.text(2, 8 + int(i), v.log[i]);
+    s.fillRow(14, 0, w, U'-', frame);
+    s.text(2, 15, "1. 몬스터와 전투  2. 상태 확인  3. 인벤토리  4. 휴식  5. 게임 종료");
+    s.text(2, 16, "선택: ");
+}
+
+// 한 턴의 게임 진행 흉내 (체력, 골드, 기록 몇 줄만 바뀜)
+void advance(GameView& v, mt19937& gen, int turn) {
+    static const char* monsters[] = {"슬라임", "고블린", "오크", "드래곤"};
+    string monster = monsters[gen() % 4];
+    int dealt = 15 + int(gen() % 11), taken = int(gen() % 20);
+    v.health = max(1, v.health - taken);
+    if (turn % 6 == 5) v.health = v.maxHealth;
+    v.log.push_back(to_string(turn) + "턴: " + monster + "에게 " + to_string(dealt) + " 피해, "
+                    + to_string(taken) + " 피해를 받음");
+    if (v.log.size() > 5) v.log.erase(v.log.begin());
+    if (gen() % 3 == 0) {
+        v.gold += 10 + int(gen() % 20);
+        v.experience += 35;
+        if (v.experience >= v.level * 100) {
+            v.experience = 0;
+            ++v.level;
+            v.maxHealth += 20;
+            v.attack += 5;
+            v.defense += 2;
+            v.dungeonLevel++;
+        }
+    }
+    if (gen() % 10 == 0 && v.inventory[0].second > 0) --v.inventory[0].second;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int turns = argc > 1 ? stoi(argv[1]) : 500;
+        bool live = argc > 2 && string(argv[2]) == "--live" && isatty(STDOUT_FILENO);
+        const int width = 80, height = 18;
+
+        // 측정 모드는 /dev/null 로 실제 write 를 수행
+        int fd = live ? STDOUT_FILENO : ::open("/dev/null", O_WRONLY);
+        if (fd < 0) throw runtime_error("/dev/null 을 열 수 없습니다");
+
+        DiffRenderer renderer(width, height, fd);
+        VirtualTerminal term(width, height);
+        GameView view;
+        mt19937 gen(7);
+        size_t endlBytes = 0, endlFlushes = 0;
+        bool faithful = true;
+
+        auto t0 = chrono::steady_clock::now();
+        for (int t = 1; t <= turns; ++t) {
+            advance(view, gen, t);
+            endlBytes += drawWithEndl(view, endlFlushes).size();
+
+            drawScreen(renderer.canvas(), view);
+            renderer.present();
+            if (!live) {
+                term.feed(renderer.lastFrame());
+                faithful = faithful && term.matches(renderer.canvas());
+            } else {
+                this_thread::sleep_for(chrono::milliseconds(60));
+            }
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        if (live) renderer.shutdown();
+        else ::close(fd);
+
+        cout << "=== 차이 기반 터미널 렌더러 (" << width << "×" << height << ", " << turns << "턴) ===" << endl;
+        cout << "endl 전체 출력: " << endlBytes << " 바이트, write " << endlFlushes << "회 ("
+             << endlBytes / turns << " 바이트/턴)" << endl;
+        cout << "차이 렌더러  : " << renderer.bytesWritten << " 바이트, write " << renderer.writeCalls << "회 ("
+             << renderer.bytesWritten / turns << " 바이트/턴, 다시 그린 칸 "
+             << renderer.cellsEmitted / turns << "개/턴)" << endl;
+        cout << "전송량 비율: " << 100.0 * renderer.bytesWritten / max<size_t>(1, endlBytes) << "%" << endl;
+        cout << "렌더링 시간: " << ms * 1000.0 / turns << " us/턴 (화면 그리기 + 비교 + 검증 포함)" << endl;
+        if (!live) cout << "가상 터미널 재생 결과가 매 프레임 일치: " << (faithful ? "예" : "아니오!") << endl;
+        return faithful ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
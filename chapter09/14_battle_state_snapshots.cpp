@@ -0,0 +1,374 @@
+/*
+ * 파일명: 14_battle_state_snapshots.cpp
+ *
+ * 주제: 비트 압축 전투 스냅숏과 상태 해시로 결정론 확인 (Bit-packed Snapshots + State Hash)
+ * 정의: 전투 상태 전체(플레이어/몬스터 능력치, 인벤토리 개수, 난수 상태)를 40바이트로 압축하고
+ *       매 턴 64비트 해시를 기록하여, 두 실행이 처음으로 갈라진 턴을 찾아내는 기법
+ *
+ * 핵심 개념:
+ * - 비트 압축: 필드마다 필요한 비트 수만 사용 (체력 16비트, 레벨 8비트, 아이템 개수 6비트 ...)
+ *   → 구조체 패딩/엔디언/컴파일러와 무관한 표준 표현 (정해진 비트 순서로 기록)
+ * - 필드 폭은 한 곳의 표(kLayout)에서 정의 → 압축과 해제가 항상 같은 순서
+ * - 범위 초과는 조용히 잘라내지 않고 예외 (값이 잘리면 해시가 같아 보이는 거짓 일치가 생김)
+ * - 상태 해시: 압축된 5개 워드를 128비트 곱셈으로 접음 (wyhash 방식) → 턴당 수 ns
+ * - 불일치 검사기: 두 실행의 턴별 해시를 비교해 첫 불일치 턴을 찾고,
+ *   그 턴의 스냅숏을 풀어 어떤 필드가 다른지 보여줌
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o snapshots 14_battle_state_snapshots.cpp
+ * 실행: ./snapshots [캠페인 수] [캠페인당 턴 수] [스레드 수]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <type_traits>
+using namespace std;
+
+// [1] 전투 상태 (chapter08/game.cpp 의 Player/Monster 에서 전투에 필요한 값 전부)
+constexpr int kItemKinds = 4;   // 체력 포션, 큰 체력 포션, 힘의 물약, 해독제
+constexpr uint32_t kMaxLevel = 99;  // 만렙: 능력치가 압축 폭을 넘지 않도록
+
+struct BattleState {
+    uint32_t turn = 0;
+    uint32_t playerHealth = 100, playerMaxHealth = 100, playerAttack = 20, playerDefense = 5;
+    uint32_t playerLevel = 1, playerExp = 0, playerGold = 50;
+    uint32_t monsterHealth = 0, monsterMaxHealth = 0, monsterAttack = 0, monsterDefense = 0;
+    uint32_t monsterType = 0;
+    uint32_t items[kItemKinds] = {2, 0, 0, 0};
+    uint64_t rng = 0;           // splitmix64 상태
+};
+
+// [2] 비트 배치 표: (필드 이름, 비트 수)
+struct FieldSpec {
+    const char* name;
+    unsigned bits;
+};
+
+constexpr FieldSpec kLayout[] = {
+    {"턴", 24},
+    {"플레이어 체력", 16}, {"플레이어 최대 체력", 16}, {"플레이어 공격력", 12}, {"플레이어 방어력", 12},
+    {"플레이어 레벨", 8}, {"플레이어 경험치", 20}, {"플레이어 골드", 24},
+    {"몬스터 체력", 16}, {"몬스터 최대 체력", 16}, {"몬스터 공격력", 12}, {"몬스터 방어력", 12},
+    {"몬스터 종류", 3},
+    {"아이템 0", 6}, {"아이템 1", 6}, {"아이템 2", 6}, {"아이템 3", 6},
+    {"난수 상태", 64},
+};
+constexpr size_t kFieldCount = sizeof(kLayout) / sizeof(kLayout[0]);
+
+constexpr unsigned totalBits() {
+    unsigned sum = 0;
+    for (const auto& f : kLayout) sum += f.bits;
+    return sum;
+}
+constexpr size_t kWords = (totalBits() + 63) / 64;
+
+struct PackedState {
+    uint64_t words[kWords];
+    bool operator==(const PackedState& o) const {
+        for (size_t i = 0; i < kWords; ++i) if (words[i] != o.words[i]) return false;
+        return true;
+    }
+};
+static_assert(sizeof(PackedState) <= 48, "스냅숏은 수십 바이트 안에 들어가야 함");
+
+constexpr unsigned offsetOf(size_t field) {
+    unsigned pos = 0;
+    for (size_t i = 0; i < field; ++i) pos += kLayout[i].bits;
+    return pos;
+}
+
+// 필드 순서대로 값을 꺼내고 넣는 접근자 (압축/해제/비교가 같은 목록을 사용)
+// 필드 번호를 컴파일 시간 상수로 넘겨 비트 위치 계산이 모두 상수가 되게 함
+// 강제 인라인: 호출로 남으면 압축 결과가 레지스터 대신 메모리를 오가며 수십 ns 가 걸림
+#define SNAPSHOT_INLINE inline __attribute__((always_inline))
+
+template <size_t I, typename Fn, typename T>
+SNAPSHOT_INLINE void visitField(Fn& fn, T& value) { fn(integral_constant<size_t, I>{}, value); }
+
+template <typename State, typename Fn>
+SNAPSHOT_INLINE void forEachField(State& s, Fn fn) {
+    visitField<0>(fn, s.turn);
+    visitField<1>(fn, s.playerHealth); visitField<2>(fn, s.playerMaxHealth);
+    visitField<3>(fn, s.playerAttack); visitField<4>(fn, s.playerDefense);
+    visitField<5>(fn, s.playerLevel); visitField<6>(fn, s.playerExp); visitField<7>(fn, s.playerGold);
+    visitField<8>(fn, s.monsterHealth); visitField<9>(fn, s.monsterMaxHealth);
+    visitField<10>(fn, s.monsterAttack); visitField<11>(fn, s.monsterDefense);
+    visitField<12>(fn, s.monsterType);
+    visitField<13>(fn, s.items[0]); visitField<14>(fn, s.items[1]);
+    visitField<15>(fn, s.items[2]); visitField<16>(fn, s.items[3]);
+    visitField<17>(fn, s.rng);
+    static_assert(kFieldCount == 18 && kItemKinds == 4, "kLayout 과 forEachField 가 어긋남");
+}
+
+class SnapshotOverflow : public exception {
+private:
+    string message;
+public:
+    explicit SnapshotOverflow(const string& field) : message("스냅숏 필드 범위 초과: " + field) {}
+    const char* what() const noexcept override { return message.c_str(); }
+};
+
+// [3] 압축과 해제
+// 드문 경로: 어떤 필드가 넘쳤는지 다시 찾아 보고 (압축 본체에 예외 코드가 섞이지 않도록 분리)
+[[noreturn]] __attribute__((noinline)) void reportOverflow(const BattleState& s) {
+    forEachField(s, [&](auto field, auto value) {
+        if constexpr (kLayout[field].bits < 64) {
+            if (uint64_t(value) >> kLayout[field].bits) throw SnapshotOverflow(kLayout[field].name);
+        }
+    });
+    throw SnapshotOverflow("알 수 없음");
+}
+
+inline PackedState pack(const BattleState& s) {
+    PackedState p{};
+    uint64_t overflow = 0;
+    forEachField(s, [&](auto field, auto value) {
+        constexpr unsigned bits = kLayout[field].bits;
+        constexpr unsigned idx = offsetOf(field) >> 6, off = offsetOf(field) & 63;
+        uint64_t v = value;
+        if constexpr (bits < 64) overflow |= v >> bits;
+        p.words[idx] |= v << off;
+        if constexpr (off != 0 && off + bits > 64) p.words[idx + 1] |= v >> (64 - off);
+    });
+    if (overflow) reportOverflow(s);
+    return p;
+}
+
+inline BattleState unpack(const PackedState& p) {
+    BattleState s;
+    forEachField(s, [&](auto field, auto& value) {
+        constexpr unsigned bits = kLayout[field].bits;
+        constexpr unsigned idx = offsetOf(field) >> 6, off = offsetOf(field) & 63;
+        uint64_t v = p.words[idx] >> off;
+        if constexpr (off != 0 && off + bits > 64) v |= p.words[idx + 1] << (64 - off);
+        if constexpr (bits < 64) v &= (1ULL << bits) - 1;
+        value = static_cast<remove_reference_t<decltype(value)>>(v);
+    });
+    return s;
+}
+
+// [4] 상태 해시: 128비트 곱셈 접기(wyhash 방식). 워드 쌍마다 곱셈이 서로 독립이라
+//     순차적인 곱셈 사슬보다 지연 시간이 짧음
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t foldMul(uint64_t a, uint64_t b) {
+    __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+}
+
+inline uint64_t hashState(const PackedState& p) {
+    static_assert(kWords == 5, "해시는 5워드 스냅숏 기준");
+    uint64_t a = foldMul(p.words[0] ^ 0xA0761D6478BD642FULL, p.words[1] ^ 0xE7037ED1A0B428DBULL);
+    uint64_t b = foldMul(p.words[2] ^ 0x8EBC6AF09C88C6E3ULL, p.words[3] ^ 0x589965CC75374CC3ULL);
+    uint64_t c = foldMul(p.words[4] ^ 0x1D8E4E27C47D124FULL, a ^ 0xA0761D6478BD642FULL);
+    return foldMul(b ^ 0xE7037ED1A0B428DBULL, c ^ 0x8EBC6AF09C88C6E3ULL);
+}
+
+// [5] 전투 진행 (난수도 상태의 일부 → 스냅숏에서 재개 가능)
+inline uint64_t nextRandom(BattleState& s) {
+    uint64_t z = (s.rng += 0x9E3779B97F4A7C15ULL);
+    return mix64(z);
+}
+
+// 빌드 차이를 흉내내기 위한 선택: 치명타 배율을 부동소수점으로 계산하는 "다른 빌드"
+enum class Build { Reference, FloatCrit };
+
+void spawnMonster(BattleState& s) {
+    uint32_t lv = s.playerLevel;
+    s.monsterType = uint32_t(nextRandom(s) % 4);
+    static const uint32_t base[4][3] = {{30, 8, 1}, {50, 12, 3}, {80, 18, 5}, {150, 25, 8}};
+    static const uint32_t grow[4][3] = {{10, 2, 1}, {15, 3, 1}, {20, 4, 2}, {30, 5, 3}};
+    const uint32_t t = s.monsterType;
+    s.monsterMaxHealth = s.monsterHealth = base[t][0] + grow[t][0] * lv;
+    s.monsterAttack = base[t][1] + grow[t][1] * lv;
+    s.monsterDefense = base[t][2] + grow[t][2] * lv;
+}
+
+inline void takeDamage(uint32_t& health, uint32_t damage, uint32_t defense) {
+    uint32_t actual = damage > defense ? damage - defense : 1;     // max(1, damage - defense)
+    health = health > actual ? health - actual : 0;
+}
+
+void playTurn(BattleState& s, Build build) {
+    ++s.turn;
+    if (s.monsterHealth == 0) spawnMonster(s);
+
+    // 체력이 1/4 아래면 포션 사용 (BattleSystem 의 아이템 사용)
+    if (s.playerHealth * 4 < s.playerMaxHealth && s.items[0] > 0) {
+        --s.items[0];
+        s.playerHealth = min(s.playerMaxHealth, s.playerHealth + 50);
+    } else {
+        uint64_t r = nextRandom(s);
+        uint32_t damage = s.playerAttack - 5 + uint32_t(r % 11);
+        if ((r >> 32) % 100 < 10) {         // 치명타 ×1.5
+            damage = build == Build::Reference ? damage * 3 / 2 : uint32_t(damage * 1.5f + 0.5f);
+        }
+        takeDamage(s.monsterHealth, damage, s.monsterDefense);
+    }
+
+    if (s.monsterHealth == 0) {
+        static const uint32_t exp[4] = {20, 35, 50, 100}, gold[4] = {10, 20, 35, 75};
+        s.playerExp = min<uint32_t>(s.playerExp + exp[s.monsterType] + 5 * s.playerLevel, 0xFFFFF);
+        s.playerGold = min<uint32_t>(s.playerGold + gold[s.monsterType], 0xFFFFFF);
+        if (nextRandom(s) % 4 == 0) {       // 전리품: 아이템 하나 (종류당 최대 63개)
+            uint32_t& slot = s.items[nextRandom(s) % kItemKinds];
+            slot = min<uint32_t>(63, slot + 1);
+        }
+        if (s.playerLevel < kMaxLevel && s.playerExp >= s.playerLevel * 100) {
+            s.playerExp = 0;
+            ++s.playerLevel;
+            s.playerMaxHealth += 20;
+            s.playerHealth = s.playerMaxHealth;
+            s.playerAttack += 5;
+            s.playerDefense += 2;
+        }
+        return;
+    }
+
+    uint32_t damage = s.monsterAttack - 3 + uint32_t(nextRandom(s) % 7);
+    takeDamage(s.playerHealth, damage, s.playerDefense);
+    if (s.playerHealth == 0) {          // 쓰러지면 골드 절반을 잃고 부활
+        s.playerGold /= 2;
+        s.playerHealth = s.playerMaxHealth;
+        s.monsterHealth = 0;
+    }
+}
+
+// [6] 턴 기록과 불일치 검사
+struct TurnRecord {
+    vector<uint64_t> hashes;
+    vector<PackedState> snapshots;      // 검사기에서 필드 비교용 (턴당 40바이트)
+};
+
+TurnRecord runCampaign(uint64_t seed, uint32_t turns, Build build, bool keepSnapshots) {
+    TurnRecord rec;
+    rec.hashes.reserve(turns);
+    if (keepSnapshots) rec.snapshots.reserve(turns);
+    BattleState s;
+    s.rng = seed;
+    for (uint32_t t = 0; t < turns; ++t) {
+        playTurn(s, build);
+        PackedState p = pack(s);
+        rec.hashes.push_back(hashState(p));
+        if (keepSnapshots) rec.snapshots.push_back(p);
+    }
+    return rec;
+}
+
+// 첫 불일치 턴 (없으면 -1)
+long firstDivergence(const vector<uint64_t>& a, const vector<uint64_t>& b) {
+    size_t n = min(a.size(), b.size());
+    auto mismatch = std::mismatch(a.begin(), a.begin() + n, b.begin());
+    if (mismatch.first != a.begin() + n) return long(mismatch.first - a.begin());
+    return a.size() == b.size() ? -1 : long(n);
+}
+
+void explainDivergence(const TurnRecord& a, const TurnRecord& b, long turn) {
+    cout << "첫 불일치: " << turn + 1 << "번째 턴" << endl;
+    if (a.snapshots.empty() || b.snapshots.empty()) return;
+    BattleState sa = unpack(a.snapshots[turn]), sb = unpack(b.snapshots[turn]);
+    vector<uint64_t> va, vb;
+    forEachField(sa, [&](size_t, auto v) { va.push_back(v); });
+    forEachField(sb, [&](size_t, auto v) { vb.push_back(v); });
+    for (size_t f = 0; f < kFieldCount; ++f) {
+        if (va[f] != vb[f]) cout << "  " << kLayout[f].name << ": " << va[f] << " vs " << vb[f] << endl;
+    }
+    if (turn > 0) {
+        BattleState prev = unpack(a.snapshots[turn - 1]);
+        cout << "  (직전 턴 몬스터 체력 " << prev.monsterHealth << ", 방어력 " << prev.monsterDefense << ")" << endl;
+    }
+}
+
+// 캠페인 여러 개를 스레드로 나누어 실행 → 캠페인별 해시 기록
+vector<vector<uint64_t>> runParallel(size_t campaigns, uint32_t turns, size_t threads) {
+    vector<vector<uint64_t>> logs(campaigns);
+    atomic<size_t> next{0};
+    vector<thread> pool;
+    for (size_t t = 0; t < max<size_t>(1, threads); ++t) {
+        pool.emplace_back([&] {
+            size_t i;
+            while ((i = next.fetch_add(1)) < campaigns) {
+                logs[i] = runCampaign(1000 + i, turns, Build::Reference, false).hashes;
+            }
+        });
+    }
+    for (auto& th : pool) th.join();
+    return logs;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t campaigns = argc > 1 ? stoul(argv[1]) : 64;
+        uint32_t turns = argc > 2 ? static_cast<uint32_t>(stoul(argv[2])) : 200000;
+        size_t threads = argc > 3 ? stoul(argv[3]) : max(1u, thread::hardware_concurrency());
+
+        cout << "=== 비트 압축 전투 스냅숏 ===" << endl;
+        cout << "상태 필드 " << kFieldCount << "개, " << totalBits() << "비트 → "
+             << sizeof(PackedState) << "바이트 (BattleState 구조체는 " << sizeof(BattleState) << "바이트)" << endl;
+
+        // 압축/해제 왕복 확인
+        BattleState probe;
+        probe.rng = 0xDEADBEEFCAFEF00DULL;
+        for (int i = 0; i < 5000; ++i) playTurn(probe, Build::Reference);
+        PackedState packed = pack(probe);
+        bool roundTrip = pack(unpack(packed)) == packed;
+        cout << "왕복(압축 → 해제 → 압축) 일치: " << (roundTrip ? "예" : "아니오!") << endl;
+
+        // 턴당 비용: 기록 없이 / 압축+해시 기록
+        auto timeTurns = [&](bool record) {
+            BattleState s;
+            s.rng = 42;
+            uint64_t sink = 0;
+            auto t0 = chrono::steady_clock::now();
+            for (uint32_t t = 0; t < turns; ++t) {
+                playTurn(s, Build::Reference);
+                if (record) sink ^= hashState(pack(s));
+            }
+            double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / turns;
+            return make_pair(ns, sink ^ s.rng);
+        };
+        double plain = 1e9, hashed = 1e9;
+        for (int rep = 0; rep < 5; ++rep) {     // 번갈아 5회 측정, 가장 빠른 값 (잡음 제거)
+            plain = min(plain, timeTurns(false).first);
+            hashed = min(hashed, timeTurns(true).first);
+        }
+        cout << fixed << setprecision(1);
+        cout << "턴 진행만: " << plain << " ns/턴, 압축+해시 포함: " << hashed
+             << " ns/턴 (추가 " << hashed - plain << " ns)" << endl;
+        cout.unsetf(ios::fixed);
+        cout << setprecision(6);
+
+        // 스레드 수가 달라도 캠페인별 해시 기록이 같아야 함
+        auto reference = runParallel(campaigns, turns / 10, 1);
+        auto parallel = runParallel(campaigns, turns / 10, threads * 2);
+        size_t diverged = 0;
+        for (size_t i = 0; i < campaigns; ++i) diverged += firstDivergence(reference[i], parallel[i]) >= 0;
+        cout << "\n캠페인 " << campaigns << "개 × " << turns / 10 << "턴, 스레드 1개 vs "
+             << threads * 2 << "개: 불일치 캠페인 " << diverged << "개" << endl;
+
+        // 다른 빌드(부동소수점 치명타 반올림)와 비교 → 첫 불일치 턴과 필드
+        cout << "\n=== 다른 빌드와 비교 ===" << endl;
+        TurnRecord a = runCampaign(7, turns, Build::Reference, true);
+        TurnRecord b = runCampaign(7, turns, Build::FloatCrit, true);
+        long turn = firstDivergence(a.hashes, b.hashes);
+        if (turn < 0) cout << "불일치 없음" << endl;
+        else explainDivergence(a, b, turn);
+
+        return roundTrip && diverged == 0 ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
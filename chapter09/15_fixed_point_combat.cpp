@@ -0,0 +1,351 @@
+/*
+ * 파일명: 15_fixed_point_combat.cpp
+ *
+ * 주제: 고정소수점 전투 계산 (Fixed-point Combat Arithmetic)
+ * 정의: 백분율 버프, 치명타 배율, 방어력 감쇠처럼 소수가 필요한 전투 공식을 float 대신
+ *       정수 안에 소수부 비트를 둔 고정소수점 수로 계산하여, 컴파일러/최적화 옵션/SIMD 여부와
+ *       무관하게 항상 비트 단위로 같은 결과를 얻는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 지금은 모든 공식이 정수라 결정론적이지만, "공격력 +15%", "치명타 ×1.5" 를 넣는 순간
+ *   float 가 들어오고 -O0/-O3, FMA 축약(-ffp-contract), x87/SSE 에 따라 결과가 달라질 수 있음
+ *
+ * 핵심 개념:
+ * - Fixed: int64_t 안에 Q47.16 (소수부 16비트, 1 = 65536)
+ *   덧셈/뺄셈은 정수 그대로, 곱셈은 (a×b + 0.5) >> 16, 나눗셈은 (a×65536) / b (0 쪽으로 버림)
+ *   → 모든 연산이 정수 연산이므로 어떤 최적화에서도 결과가 같음
+ * - 반올림 규칙을 한 곳(Fixed)에 고정 → 공식마다 반올림이 제각각이 되지 않음
+ * - 전투 공식은 수 타입에 대한 템플릿(BasicCharacter<N>) 하나로 작성하고
+ *   int / Fixed / float 로 각각 인스턴스화 → 같은 공식으로 속도와 결정론을 비교
+ * - 일괄 처리(SoA) 커널을 자동 벡터화판과 스칼라판으로 같은 바이너리 안에서 실행하여 비교
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o fixed_point 15_fixed_point_combat.cpp
+ * 빌드 간 비교: 아래처럼 여러 옵션으로 빌드해 출력된 "지문"을 비교
+ *   g++ -std=c++17 -O0 ...   /   g++ -std=c++17 -O3 -march=native ...
+ * 실행: ./fixed_point [전투 수]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+// [1] 고정소수점 수
+class Fixed {
+public:
+    static constexpr int kFracBits = 16;
+    static constexpr int64_t kOne = int64_t(1) << kFracBits;
+
+private:
+    int64_t raw;
+    struct RawTag {};
+    constexpr Fixed(int64_t r, RawTag) : raw(r) {}
+
+public:
+    constexpr Fixed() : raw(0) {}
+    constexpr Fixed(int value) : raw(int64_t(value) * kOne) {}     // 정수는 정확히 표현되므로 암시적 변환 허용
+
+    static constexpr Fixed fromRaw(int64_t r) { return Fixed(r, RawTag{}); }
+    // num/den 을 소수부 16비트로 (0 쪽으로 버림). 예: ratio(3, 2) = 1.5
+    // 음수의 << 는 C++17 에서 정의되지 않은 동작 → 소수부로 올릴 때는 항상 kOne 을 곱함
+    static constexpr Fixed ratio(int num, int den) { return fromRaw(int64_t(num) * kOne / den); }
+
+    constexpr int64_t rawValue() const { return raw; }
+    // 음수의 >> 는 GCC/Clang 에서 산술 이동 (C++20 부터는 표준) → 내림
+    constexpr int floorInt() const { return static_cast<int>(raw >> kFracBits); }
+    constexpr int roundInt() const { return static_cast<int>((raw + kOne / 2) >> kFracBits); }
+    double toDouble() const { return double(raw) / kOne; }      // 출력 전용
+
+    constexpr Fixed operator+(Fixed o) const { return fromRaw(raw + o.raw); }
+    constexpr Fixed operator-(Fixed o) const { return fromRaw(raw - o.raw); }
+    constexpr Fixed operator*(Fixed o) const { return fromRaw((raw * o.raw + kOne / 2) >> kFracBits); }
+    constexpr Fixed operator/(Fixed o) const { return fromRaw(raw * kOne / o.raw); }
+    Fixed& operator+=(Fixed o) { raw += o.raw; return *this; }
+    Fixed& operator-=(Fixed o) { raw -= o.raw; return *this; }
+
+    constexpr bool operator<(Fixed o) const { return raw < o.raw; }
+    constexpr bool operator>(Fixed o) const { return raw > o.raw; }
+    constexpr bool operator<=(Fixed o) const { return raw <= o.raw; }
+    constexpr bool operator>=(Fixed o) const { return raw >= o.raw; }
+    constexpr bool operator==(Fixed o) const { return raw == o.raw; }
+};
+
+static_assert(Fixed::ratio(3, 2) * Fixed(10) == Fixed(15), "1.5 × 10 = 15");
+static_assert((Fixed(7) / Fixed(2)).floorInt() == 3, "3.5 의 내림은 3");
+static_assert((Fixed(-7) / Fixed(2)).rawValue() == -7 * Fixed::kOne / 2, "음수 나눗셈도 0 쪽으로 버림");
+static_assert(Fixed::ratio(-3, 2) == Fixed(0) - Fixed::ratio(3, 2), "음수 비율");
+
+// 수 타입별 공통 연산 (출력용 정수 변환, 지문용 비트 표현)
+inline int displayInt(int v) { return v; }
+inline int displayInt(Fixed v) { return v.floorInt(); }
+inline int displayInt(float v) { return static_cast<int>(v); }
+
+inline uint64_t bitsOf(int v) { return static_cast<uint32_t>(v); }
+inline uint64_t bitsOf(Fixed v) { return static_cast<uint64_t>(v.rawValue()); }
+inline uint64_t bitsOf(float v) { uint32_t b; memcpy(&b, &v, sizeof(b)); return b; }
+
+// [2] 결정론적 난수 (전투 공식과 분리: 어떤 수 타입이든 같은 주사위)
+struct Dice {
+    uint64_t state;
+    uint32_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return static_cast<uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+};
+
+// [3] 전투 공식: chapter08/game.cpp 의 Character/Player/Monster 를 수 타입 N 에 대해 작성
+template <typename N>
+class BasicCharacter {
+protected:
+    string name;
+    N health;
+    N maxHealth;
+    N attack;
+    N defense;
+
+public:
+    BasicCharacter(const string& n, N hp, N att, N def)
+        : name(n), health(hp), maxHealth(hp), attack(att), defense(def) {}
+    virtual ~BasicCharacter() = default;
+
+    // 방어력 감쇠: 피해 × 100 / (100 + 방어력), 최소 1 (원래의 max(1, 피해 - 방어력) 를 비율로)
+    void takeDamage(N damage) {
+        N actual = damage * N(100) / (defense + N(100));
+        if (actual < N(1)) actual = N(1);
+        health -= actual;
+        if (health < N(0)) health = N(0);
+    }
+
+    void heal(N amount) {
+        health += amount;
+        if (health > maxHealth) health = maxHealth;
+    }
+
+    bool isAlive() const { return health > N(0); }
+    const string& getName() const { return name; }
+    N getHealth() const { return health; }
+    N getMaxHealth() const { return maxHealth; }
+    N getAttack() const { return attack; }
+    N getDefense() const { return defense; }
+};
+
+template <typename N>
+class BasicPlayer : public BasicCharacter<N> {
+private:
+    int level = 1;
+    int experience = 0;
+    int gold = 50;
+    N attackBuffPercent = N(15);        // 장비 효과: 공격력 +15%
+
+public:
+    explicit BasicPlayer(const string& n) : BasicCharacter<N>(n, N(100), N(20), N(5)) {}
+
+    // 공격력 ±5, 버프 적용, 10% 확률 치명타 ×1.5
+    N calculateDamage(Dice& dice) const {
+        N base = this->attack + N(int(dice.next() % 11) - 5);
+        N buffed = base * (N(100) + attackBuffPercent) / N(100);
+        if (dice.next() % 100 < 10) buffed = buffed * N(3) / N(2);
+        return buffed < N(1) ? N(1) : buffed;
+    }
+
+    void gainExperience(int exp) {
+        experience += exp;
+        if (experience >= level * 100) levelUp();
+    }
+    void addGold(int amount) { gold += amount; }
+    void restoreFull() { this->health = this->maxHealth; }
+    int getLevel() const { return level; }
+    int getGold() const { return gold; }
+
+private:
+    void levelUp() {
+        level++;
+        experience = 0;
+        this->maxHealth += N(20);
+        this->health = this->maxHealth;
+        this->attack += N(5);
+        this->defense += N(2);
+    }
+};
+
+template <typename N>
+class BasicMonster : public BasicCharacter<N> {
+private:
+    int expReward;
+    int goldReward;
+
+public:
+    BasicMonster(const string& n, N hp, N att, N def, int exp, int gold)
+        : BasicCharacter<N>(n, hp, att, def), expReward(exp), goldReward(gold) {}
+
+    N calculateDamage(Dice& dice) const {
+        N d = this->attack + N(int(dice.next() % 7) - 3);
+        return d < N(1) ? N(1) : d;
+    }
+
+    int getExpReward() const { return expReward; }
+    int getGoldReward() const { return goldReward; }
+
+    // MonsterFactory::createRandomMonster 의 수치에 "레벨당 +8%" 성장 배율을 곱함
+    static BasicMonster create(Dice& dice, int level) {
+        static const char* names[] = {"슬라임", "고블린", "오크", "드래곤"};
+        static const int base[4][5] = {{30, 8, 1, 20, 10}, {50, 12, 3, 35, 20}, {80, 18, 5, 50, 35}, {150, 25, 8, 100, 75}};
+        static const int grow[4][3] = {{10, 2, 1}, {15, 3, 1}, {20, 4, 2}, {30, 5, 3}};
+        int t = int(dice.next() % 4);
+        int lv = max(1, level);
+        auto scaled = [&](int stat) { return N(stat) * (N(100) + N(8 * lv)) / N(100); };
+        return BasicMonster(names[t],
+                            scaled(base[t][0] + grow[t][0] * lv),
+                            scaled(base[t][1] + grow[t][1] * lv),
+                            scaled(base[t][2] + grow[t][2] * lv),
+                            base[t][3] + 5 * lv, base[t][4] + 3 * lv);
+    }
+};
+
+using Character = BasicCharacter<Fixed>;
+using Player = BasicPlayer<Fixed>;
+using Monster = BasicMonster<Fixed>;
+
+// [4] 전투 캠페인: 턴마다 체력의 비트 표현을 지문에 섞음
+inline uint64_t mixInto(uint64_t h, uint64_t v) {
+    h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+struct CampaignResult {
+    uint64_t fingerprint = 0;
+    int finalLevel = 0;
+    long turns = 0;
+    double ms = 0;
+};
+
+template <typename N>
+CampaignResult runCampaign(int fights, uint64_t seed) {
+    CampaignResult r;
+    Dice dice{seed};
+    BasicPlayer<N> player("용사");
+    auto t0 = chrono::steady_clock::now();
+    for (int f = 0; f < fights; ++f) {
+        auto monster = BasicMonster<N>::create(dice, player.getLevel());
+        while (player.isAlive() && monster.isAlive()) {
+            monster.takeDamage(player.calculateDamage(dice));
+            ++r.turns;
+            if (!monster.isAlive()) break;
+            player.takeDamage(monster.calculateDamage(dice));
+            r.fingerprint = mixInto(r.fingerprint, bitsOf(player.getHealth()) ^ bitsOf(monster.getHealth()) << 32);
+        }
+        if (player.isAlive()) {
+            player.gainExperience(monster.getExpReward());
+            player.addGold(monster.getGoldReward());
+        } else {
+            player.restoreFull();   // 측정을 이어가기 위해 부활
+        }
+        if (f % 3 == 2) player.heal(N(30));
+    }
+    r.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    r.finalLevel = player.getLevel();
+    return r;
+}
+
+// [5] 일괄 처리 커널: 많은 전투원의 체력에 피해를 한꺼번에 적용 (SoA)
+//     감쇠 계수 100 / (100 + 방어력) 은 미리 계산 → 루프 안은 곱셈과 이동뿐이라 벡터화 가능
+template <typename N>
+void applyDamageBatch(N* health, const N* damage, const N* mitigation, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        N actual = damage[i] * mitigation[i];
+        if (actual < N(1)) actual = N(1);
+        N h = health[i] - actual;
+        health[i] = h < N(0) ? N(0) : h;
+    }
+}
+
+// 같은 공식을 벡터화 없이 (GCC 전용 함수 속성)
+template <typename N>
+__attribute__((optimize("no-tree-vectorize"), noinline))
+void applyDamageBatchScalar(N* health, const N* damage, const N* mitigation, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        N actual = damage[i] * mitigation[i];
+        if (actual < N(1)) actual = N(1);
+        N h = health[i] - actual;
+        health[i] = h < N(0) ? N(0) : h;
+    }
+}
+
+template <typename N>
+pair<uint64_t, uint64_t> batchFingerprints(size_t n, int rounds) {
+    Dice dice{99};
+    vector<N> damage(n), mitigation(n), a(n), b(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = b[i] = N(int(5000 + dice.next() % 5000));
+        int def = int(dice.next() % 200);
+        mitigation[i] = N(100) / N(100 + def);
+    }
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < n; ++i) damage[i] = N(int(dice.next() % 60)) / N(7);
+        applyDamageBatch(a.data(), damage.data(), mitigation.data(), n);
+        applyDamageBatchScalar(b.data(), damage.data(), mitigation.data(), n);
+    }
+    uint64_t ha = 0, hb = 0;
+    for (size_t i = 0; i < n; ++i) {
+        ha = mixInto(ha, bitsOf(a[i]));
+        hb = mixInto(hb, bitsOf(b[i]));
+    }
+    return {ha, hb};
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int fights = argc > 1 ? stoi(argv[1]) : 200000;
+
+        cout << "=== 고정소수점 전투 계산 (Q47.16) ===" << endl;
+        Fixed crit = Fixed::ratio(3, 2), buff = Fixed(115) / Fixed(100);
+        cout << "예: 공격력 37 × 1.15 × 1.5 = " << (Fixed(37) * buff * crit).toDouble()
+             << " (원시 값 " << (Fixed(37) * buff * crit).rawValue() << ")" << endl;
+
+        // 같은 공식, 세 가지 수 타입 (빠른 값을 쓰기 위해 3회 측정)
+        CampaignResult asInt, asFixed, asFloat;
+        asInt.ms = asFixed.ms = asFloat.ms = 1e18;
+        for (int rep = 0; rep < 3; ++rep) {
+            auto i = runCampaign<int>(fights, 1);
+            auto x = runCampaign<Fixed>(fights, 1);
+            auto f = runCampaign<float>(fights, 1);
+            if (i.ms < asInt.ms) asInt = i;
+            if (x.ms < asFixed.ms) asFixed = x;
+            if (f.ms < asFloat.ms) asFloat = f;
+        }
+        cout << "\n전투 " << fights << "회 (같은 주사위, 같은 공식)" << endl;
+        cout << "int   : " << dec << asInt.ms << " ms, " << asInt.turns << "턴, 최종 레벨 " << asInt.finalLevel
+             << ", 지문 " << hex << asInt.fingerprint << endl;
+        cout << "Fixed : " << dec << asFixed.ms << " ms, " << asFixed.turns << "턴, 최종 레벨 " << asFixed.finalLevel
+             << ", 지문 " << hex << asFixed.fingerprint << endl;
+        cout << "float : " << dec << asFloat.ms << " ms, " << asFloat.turns << "턴, 최종 레벨 " << asFloat.finalLevel
+             << ", 지문 " << hex << asFloat.fingerprint << dec << endl;
+        cout << "Fixed / int 시간 비율: " << asFixed.ms / asInt.ms << endl;
+
+        // 벡터화 커널과 스칼라 커널이 같은 결과를 내는지
+        auto fx = batchFingerprints<Fixed>(1 << 16, 50);
+        auto fl = batchFingerprints<float>(1 << 16, 50);
+        cout << "\n일괄 커널 (벡터화 vs 스칼라)" << endl;
+        cout << "Fixed: " << hex << fx.first << " / " << fx.second << dec
+             << (fx.first == fx.second ? " (일치)" : " (불일치!)") << endl;
+        cout << "float: " << hex << fl.first << " / " << fl.second << dec
+             << (fl.first == fl.second ? " (일치)" : " (불일치)") << endl;
+
+        // 빌드 간 비교용 한 줄 요약 (옵션을 바꿔 빌드해도 Fixed 지문은 같아야 함)
+        cout << "\n빌드 지문: Fixed " << hex << asFixed.fingerprint << "-" << fx.first
+             << " | float " << asFloat.fingerprint << "-" << fl.first << dec << endl;
+        return fx.first == fx.second ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,439 @@
+/*
+ * 파일명: 16_cow_world_snapshots.cpp
+ *
+ * 주제: 쓰기 시 복사(COW) 세계 스냅숏으로 만드는 "만약에" 시뮬레이션 (Copy-on-write World Snapshots)
+ * 정의: 게임 상태(플레이어, 인벤토리, 던전 레벨, 난수)를 구조 공유하는 영속 자료구조로 표현하여,
+ *       상태 복제(fork)는 포인터 몇 개 복사로 끝내고 실제로 바뀌는 조각만 그때 복사하는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - Player 가 vector<unique_ptr<Item>> 를 소유 → 상태를 복제하려면 아이템마다 새로 할당하는 깊은 복사
+ * - AI 의 미리보기나 "여기서 100번 더 싸우면?" 질의를 수천 번 하면 복제 비용이 시뮬레이션보다 큼
+ *
+ * 핵심 개념:
+ * - 구조 공유: fork() = shared_ptr 몇 개 복사 → O(1), 인벤토리 크기와 무관
+ * - 쓰기 시 복사: 수정하려는 조각의 use_count() 가 1 보다 크면 그 조각만 복제 후 수정
+ *   (한 번 복제된 조각은 이후 제자리 수정 → 턴마다 할당하지 않음)
+ * - 영속 벡터: 루트(청크 포인터 배열) + 32칸 청크. 아이템 하나를 바꾸면 루트와 청크 하나만 복사
+ * - 아이템 정의(이름, 효과)는 불변 카탈로그에 두고 인벤토리는 포인터만 보관
+ * - 비교 대상: game.cpp 와 같은 unique_ptr<Item> 인벤토리를 가진 Player 의 깊은 복사
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o cow_snapshots 16_cow_world_snapshots.cpp
+ * 실행: ./cow_snapshots [인벤토리 크기] [fork 수] [fork 당 전투 수]
+ */
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+using namespace std;
+
+// [1] 할당 카운터 (fork 한 번에 몇 번 할당하는지 측정)
+// 교체한 new 가 malloc 을 쓰므로 GCC 의 new/free 불일치 경고는 오탐 → 끔
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+static atomic<size_t> g_allocCount{0};
+
+void* operator new(size_t size) {
+    g_allocCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size == 0 ? 1 : size)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+class AllocationScope {
+private:
+    size_t start;
+
+public:
+    AllocationScope() : start(g_allocCount.load(memory_order_relaxed)) {}
+    size_t count() const { return g_allocCount.load(memory_order_relaxed) - start; }
+};
+
+inline uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// [2] 아이템: 정의는 불변 카탈로그, 인벤토리는 포인터만
+struct ItemDef {
+    string name;
+    int healAmount;
+    int attackBonus;
+};
+
+const vector<ItemDef>& itemCatalog() {
+    static const vector<ItemDef> catalog = {
+        {"체력 포션", 30, 0}, {"큰 체력 포션", 80, 0}, {"힘의 물약", 0, 10},
+        {"낡은 동전 주머니", 0, 0}, {"고블린의 녹슨 단검 조각", 0, 0}, {"드래곤 비늘", 0, 0},
+    };
+    return catalog;
+}
+
+// [3] 영속 벡터: 루트 + 32칸 청크, 쓰기 시 복사
+template <typename T, size_t ChunkSize = 32>
+class PersistentVector {
+private:
+    struct Chunk {
+        array<T, ChunkSize> items{};
+    };
+    struct Root {
+        vector<shared_ptr<Chunk>> chunks;
+        size_t size = 0;
+    };
+    shared_ptr<Root> root = make_shared<Root>();
+
+    Root& mutableRoot() {
+        if (root.use_count() > 1) root = make_shared<Root>(*root);   // 청크 포인터 배열만 복사
+        return *root;
+    }
+
+    static Chunk& mutableChunk(shared_ptr<Chunk>& chunk) {
+        if (chunk.use_count() > 1) chunk = make_shared<Chunk>(*chunk);
+        return *chunk;
+    }
+
+public:
+    size_t size() const { return root->size; }
+    bool empty() const { return root->size == 0; }
+
+    const T& operator[](size_t i) const { return root->chunks[i / ChunkSize]->items[i % ChunkSize]; }
+
+    void set(size_t i, T value) {
+        Root& r = mutableRoot();
+        mutableChunk(r.chunks[i / ChunkSize]).items[i % ChunkSize] = value;
+    }
+
+    void push_back(T value) {
+        Root& r = mutableRoot();
+        if (r.size % ChunkSize == 0) r.chunks.push_back(make_shared<Chunk>());
+        mutableChunk(r.chunks.back()).items[r.size % ChunkSize] = value;
+        ++r.size;
+    }
+
+    void pop_back() {
+        Root& r = mutableRoot();
+        --r.size;
+        if (r.size % ChunkSize == 0) r.chunks.pop_back();
+    }
+
+    // 순서 대신 속도: 마지막 원소를 빈자리로 옮기고 줄임 (청크 최대 두 개만 복사)
+    void swapRemove(size_t i) {
+        if (i + 1 != size()) set(i, (*this)[size() - 1]);
+        pop_back();
+    }
+};
+
+// [4] COW 세계 상태
+struct PlayerStats {
+    string name;
+    int health = 100, maxHealth = 100, attack = 20, defense = 5;
+    int level = 1, experience = 0, gold = 50;
+};
+
+class WorldState {
+private:
+    shared_ptr<PlayerStats> player;
+    PersistentVector<const ItemDef*> inventory;
+    int dungeonLevel = 1;
+    uint64_t rng = 0;
+
+    PlayerStats& editPlayer() {
+        if (player.use_count() > 1) player = make_shared<PlayerStats>(*player);
+        return *player;
+    }
+
+public:
+    WorldState(const string& name, uint64_t seed) : player(make_shared<PlayerStats>()), rng(seed) {
+        player->name = name;
+    }
+
+    // O(1): 공유 포인터 두 개와 정수 두 개 복사
+    WorldState fork(uint64_t seed) const {
+        WorldState copy = *this;
+        copy.rng = seed;
+        return copy;
+    }
+
+    // 시뮬레이션 인터페이스 (LegacyGame 과 같은 이름)
+    const PlayerStats& stats() const { return *player; }
+    int getDungeonLevel() const { return dungeonLevel; }
+    uint64_t random() { return nextRandom(rng); }
+    size_t inventorySize() const { return inventory.size(); }
+    const ItemDef& itemAt(size_t i) const { return *inventory[i]; }
+
+    void damagePlayer(int damage) {
+        PlayerStats& p = editPlayer();
+        p.health = max(0, p.health - max(1, damage - p.defense));
+    }
+    void addItem(const ItemDef& def) { inventory.push_back(&def); }
+    void useItem(size_t i) {
+        const ItemDef& def = *inventory[i];
+        PlayerStats& p = editPlayer();
+        p.health = min(p.maxHealth, p.health + def.healAmount);
+        p.attack += def.attackBonus;
+        inventory.swapRemove(i);
+    }
+    void winFight(int exp, int gold) {
+        PlayerStats& p = editPlayer();
+        p.gold += gold;
+        p.experience += exp;
+        if (p.experience >= p.level * 100) {
+            p.level++;
+            p.maxHealth += 20;
+            p.health = p.maxHealth;
+            p.attack += 5;
+            p.defense += 2;
+        }
+        ++dungeonLevel;
+    }
+    void rest() {
+        PlayerStats& p = editPlayer();
+        if (p.gold >= 20) {
+            p.gold -= 20;
+            p.health = p.maxHealth;
+        }
+    }
+};
+
+// [5] 비교 대상: chapter08/game.cpp 방식의 Player (unique_ptr<Item> 인벤토리) 깊은 복사
+class Item {
+private:
+    string name;
+    int healAmount;
+    int attackBonus;
+
+public:
+    Item(const string& n, int heal = 0, int attack = 0) : name(n), healAmount(heal), attackBonus(attack) {}
+    const string& getName() const { return name; }
+    int getHealAmount() const { return healAmount; }
+    int getAttackBonus() const { return attackBonus; }
+};
+
+class LegacyPlayer {
+public:
+    PlayerStats stats;
+    vector<unique_ptr<Item>> inventory;
+
+    LegacyPlayer() = default;
+    LegacyPlayer(const LegacyPlayer& o) : stats(o.stats) {      // 아이템마다 새로 할당
+        inventory.reserve(o.inventory.size());
+        for (const auto& item : o.inventory) inventory.push_back(make_unique<Item>(*item));
+    }
+};
+
+class LegacyGame {
+private:
+    unique_ptr<LegacyPlayer> player;
+    int dungeonLevel = 1;
+    uint64_t rng = 0;
+    ItemDef scratch;        // itemAt() 반환용
+
+public:
+    LegacyGame(const string& name, uint64_t seed) : player(make_unique<LegacyPlayer>()), rng(seed) {
+        player->stats.name = name;
+    }
+    LegacyGame(const LegacyGame& o)
+        : player(make_unique<LegacyPlayer>(*o.player)), dungeonLevel(o.dungeonLevel), rng(o.rng) {}
+
+    LegacyGame fork(uint64_t seed) const {
+        LegacyGame copy(*this);
+        copy.rng = seed;
+        return copy;
+    }
+
+    const PlayerStats& stats() const { return player->stats; }
+    int getDungeonLevel() const { return dungeonLevel; }
+    uint64_t random() { return nextRandom(rng); }
+    size_t inventorySize() const { return player->inventory.size(); }
+    const ItemDef& itemAt(size_t i) {
+        const Item& item = *player->inventory[i];
+        scratch.healAmount = item.getHealAmount();
+        scratch.attackBonus = item.getAttackBonus();
+        return scratch;
+    }
+
+    void damagePlayer(int damage) {
+        PlayerStats& p = player->stats;
+        p.health = max(0, p.health - max(1, damage - p.defense));
+    }
+    void addItem(const ItemDef& def) {
+        player->inventory.push_back(make_unique<Item>(def.name, def.healAmount, def.attackBonus));
+    }
+    void useItem(size_t i) {
+        auto& inv = player->inventory;
+        PlayerStats& p = player->stats;
+        p.health = min(p.maxHealth, p.health + inv[i]->getHealAmount());
+        p.attack += inv[i]->getAttackBonus();
+        swap(inv[i], inv.back());       // COW 쪽과 같은 순서 규칙
+        inv.pop_back();
+    }
+    void winFight(int exp, int gold) {
+        PlayerStats& p = player->stats;
+        p.gold += gold;
+        p.experience += exp;
+        if (p.experience >= p.level * 100) {
+            p.level++;
+            p.maxHealth += 20;
+            p.health = p.maxHealth;
+            p.attack += 5;
+            p.defense += 2;
+        }
+        ++dungeonLevel;
+    }
+    void rest() {
+        PlayerStats& p = player->stats;
+        if (p.gold >= 20) {
+            p.gold -= 20;
+            p.health = p.maxHealth;
+        }
+    }
+};
+
+// [6] 시뮬레이션 (두 표현에 같은 규칙)
+template <typename G>
+bool simulateFights(G& g, int fights) {
+    const auto& catalog = itemCatalog();
+    for (int f = 0; f < fights; ++f) {
+        int lv = 1 + g.getDungeonLevel() / 10;     // 10층마다 몬스터 레벨 +1
+        int type = int(g.random() % 4);
+        static const int base[4][5] = {{30, 8, 1, 20, 10}, {50, 12, 3, 35, 20}, {80, 18, 5, 50, 35}, {150, 25, 8, 100, 75}};
+        static const int grow[4][5] = {{10, 2, 1, 5, 3}, {15, 3, 1, 8, 5}, {20, 4, 2, 10, 7}, {30, 5, 3, 15, 10}};
+        int mHealth = base[type][0] + grow[type][0] * lv;
+        int mAttack = base[type][1] + grow[type][1] * lv;
+        int mDefense = base[type][2] + grow[type][2] * lv;
+
+        while (mHealth > 0) {
+            const PlayerStats& p = g.stats();
+            // 체력이 30% 미만이면 인벤토리 뒤쪽에서 회복 아이템을 찾아 사용
+            // 회복 아이템이 없으면 골드를 내고 휴식
+            if (p.health * 10 < p.maxHealth * 3) {
+                bool healed = false;
+                for (size_t i = g.inventorySize(); i-- > 0;) {
+                    if (g.itemAt(i).healAmount > 0) { g.useItem(i); healed = true; break; }
+                }
+                if (!healed) g.rest();
+            }
+            int damage = g.stats().attack - 5 + int(g.random() % 11);
+            mHealth -= max(1, damage - mDefense);
+            if (mHealth <= 0) break;
+            g.damagePlayer(mAttack - 3 + int(g.random() % 7));
+            if (g.stats().health == 0) return false;
+        }
+        g.winFight(base[type][3] + grow[type][3] * lv, base[type][4] + grow[type][4] * lv);
+        if (g.random() % 5 == 0) g.addItem(catalog[g.random() % catalog.size()]);
+    }
+    return true;
+}
+
+// 시작 상태: 오래 플레이해서 인벤토리가 큰 플레이어
+template <typename G>
+G makeVeteran(size_t inventorySize) {
+    G g("용사", 12345);
+    const auto& catalog = itemCatalog();
+    for (size_t i = 0; i < inventorySize; ++i) g.addItem(catalog[i % catalog.size()]);
+    return g;
+}
+
+struct BenchResult {
+    double forkNs = 0;
+    double allocsPerFork = 0;
+    double forkSimPerSec = 0;
+    int survived = 0;
+    long long goldSum = 0;      // 두 표현의 결과 비교용
+};
+
+template <typename G>
+BenchResult benchmark(const G& base, int forks, int fightsPerFork) {
+    BenchResult r;
+    {   // fork 만
+        AllocationScope scope;
+        auto t0 = chrono::steady_clock::now();
+        volatile size_t sink = 0;      // 복제가 최적화로 사라지지 않게
+        for (int i = 0; i < forks; ++i) {
+            G copy = base.fork(uint64_t(i));
+            sink = sink + copy.inventorySize();
+        }
+        r.forkNs = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / forks;
+        r.allocsPerFork = double(scope.count()) / forks;
+    }
+    {   // fork + 전투 시뮬레이션
+        auto t0 = chrono::steady_clock::now();
+        for (int i = 0; i < forks; ++i) {
+            G copy = base.fork(uint64_t(i));
+            r.survived += simulateFights(copy, fightsPerFork);
+            r.goldSum += copy.stats().gold;
+        }
+        r.forkSimPerSec = forks / chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    }
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t inventory = argc > 1 ? stoul(argv[1]) : 500;
+        int forks = argc > 2 ? stoi(argv[2]) : 5000;
+        int fights = argc > 3 ? stoi(argv[3]) : 100;
+
+        cout << "=== COW 세계 스냅숏 ===" << endl;
+        cout << "인벤토리 " << inventory << "개, fork " << forks << "회, fork 당 전투 " << fights << "회" << endl;
+
+        WorldState cowBase = makeVeteran<WorldState>(inventory);
+        LegacyGame legacyBase = makeVeteran<LegacyGame>(inventory);
+        PlayerStats before = cowBase.stats();
+
+        BenchResult legacy = benchmark(legacyBase, forks, fights);
+        BenchResult cow = benchmark(cowBase, forks, fights);
+
+        cout << "\n깊은 복사 (unique_ptr<Item>): fork " << legacy.forkNs << " ns, 할당 "
+             << legacy.allocsPerFork << "회/fork, fork+시뮬레이션 " << legacy.forkSimPerSec
+             << "회/초, 생존 " << legacy.survived << endl;
+        cout << "COW 스냅숏               : fork " << cow.forkNs << " ns, 할당 "
+             << cow.allocsPerFork << "회/fork, fork+시뮬레이션 " << cow.forkSimPerSec
+             << "회/초, 생존 " << cow.survived << endl;
+        cout << "fork 속도 " << legacy.forkNs / cow.forkNs << "배, fork+시뮬레이션 "
+             << cow.forkSimPerSec / legacy.forkSimPerSec << "배" << endl;
+
+        // 두 표현이 같은 규칙으로 같은 결과를 냈는지 + 원본이 그대로인지
+        bool sameOutcome = legacy.survived == cow.survived && legacy.goldSum == cow.goldSum;
+        const PlayerStats& after = cowBase.stats();
+        bool untouched = after.health == before.health && after.gold == before.gold
+                         && after.attack == before.attack && cowBase.inventorySize() == inventory;
+        cout << "두 표현의 결과(생존 수, 골드 합) 일치: " << (sameOutcome ? "예" : "아니오!")
+             << " | 원본 상태 보존: " << (untouched ? "예" : "아니오!") << endl;
+
+        // "만약에" 질의: game.cpp 시작 상태에서 힘의 물약을 지금 마실까, 아껴 둘까?
+        const int whatIfFights = 60;
+        cout << "\n=== 만약에: 시작 직후 " << whatIfFights << "번 싸운다면? ===" << endl;
+        WorldState starter("신입", 0);
+        starter.addItem(itemCatalog()[0]);
+        starter.addItem(itemCatalog()[2]);
+        const char* plans[] = {"힘의 물약 아껴 두기", "힘의 물약 바로 마시기"};
+        for (int plan = 0; plan < 2; ++plan) {
+            int alive = 0;
+            const int trials = 2000;
+            for (int i = 0; i < trials; ++i) {
+                WorldState w = starter.fork(uint64_t(1000 + i));    // 같은 시드 → 두 계획을 같은 운으로 비교
+                if (plan == 1) w.useItem(1);
+                alive += simulateFights(w, whatIfFights);
+            }
+            cout << plans[plan] << ": 생존 확률 " << 100.0 * alive / trials << "%" << endl;
+        }
+        return sameOutcome && untouched ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,456 @@
+/*
+ * 파일명: 17_fork_autosave.cpp
+ *
+ * 주제: fork() 기반 논블로킹 자동 저장 (Background Snapshot with fork + Copy-on-write)
+ * 정의: 저장 시점에 프로세스를 fork() 하면 자식은 그 순간의 메모리 이미지를 그대로 가진 채
+ *       디스크에 쓰고, 부모는 틱 루프를 계속 돈다. 두 프로세스는 페이지를 공유하다가 부모가
+ *       쓰는 페이지만 커널이 복사(COW)한다 (Redis BGSAVE 와 같은 방식)
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 저장 기능이 없고, 단순히 틱 안에서 파일을 쓰면 세계가 클수록 그 틱이 통째로 멈춤
+ *
+ * 핵심 개념:
+ * - 일관성: 자식이 보는 메모리는 fork 순간에 고정 → 잠금 없이도 "한 틱 경계"의 온전한 이미지
+ * - 부모가 치르는 비용: fork() 호출(페이지 테이블 복사) + 저장 중 처음 쓰는 페이지마다 COW 폴트
+ * - 자식은 배열을 직렬화 없이 그대로 write() → 임시 파일에 쓰고 fsync 후 rename (원자적 교체)
+ * - 자식은 nice 값을 올려 CPU 를 부모 틱에 양보, 결과는 파이프로 보고하고 _exit()
+ * - 측정: 저장 소요 시간, COW 페이지 수(부모의 minor fault 증가분, 자식의 Private_Dirty),
+ *   저장 중 최악 틱 지연 vs 틱 안에서 동기 저장했을 때의 최악 틱 지연
+ * - 검증: 세계는 시드로 결정되므로, 저장 파일을 다시 읽어 같은 틱까지 재실행한 세계와 비교
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o autosave 17_fork_autosave.cpp
+ * 실행: ./autosave [캐릭터 수] [틱 수] [틱 주기(ms)]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+using namespace std;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] 세계 상태: 포인터 없는 평평한 배열 → 메모리 이미지를 그대로 파일에 쓸 수 있음
+struct Character {
+    uint32_t id;
+    int32_t health, maxHealth, attack, defense;
+    int32_t level, experience, gold, dungeonLevel;
+    uint32_t sessionId;
+    char name[24];
+};
+
+struct Session {
+    uint32_t playerId;
+    uint32_t lastTick;
+    uint64_t inputSeq;
+    int32_t x, y;
+};
+
+struct LeaderEntry {
+    int32_t experience;
+    uint32_t playerId;
+};
+
+constexpr size_t kLeaderboardSize = 1000;
+
+class World {
+private:
+    uint64_t seed;
+    uint32_t tick = 0;
+    vector<Character> characters;
+    vector<Session> sessions;
+    vector<LeaderEntry> leaderboard;    // 경험치 내림차순 상위 kLeaderboardSize
+
+    void updateLeaderboard(const Character& c) {
+        auto it = find_if(leaderboard.begin(), leaderboard.end(),
+                          [&](const LeaderEntry& e) { return e.playerId == c.id; });
+        if (it != leaderboard.end()) leaderboard.erase(it);
+        auto pos = lower_bound(leaderboard.begin(), leaderboard.end(), c.experience,
+                               [](const LeaderEntry& e, int32_t exp) { return e.experience >= exp; });
+        if (size_t(pos - leaderboard.begin()) >= kLeaderboardSize) return;
+        leaderboard.insert(pos, LeaderEntry{c.experience, c.id});
+        if (leaderboard.size() > kLeaderboardSize) leaderboard.pop_back();
+    }
+
+public:
+    World(uint64_t s, size_t count) : seed(s), characters(count), sessions(count / 4) {
+        for (size_t i = 0; i < count; ++i) {
+            Character& c = characters[i];
+            c = Character{uint32_t(i), 100, 100, 20, 5, 1, 0, 50, 1, uint32_t(i % sessions.size()), {}};
+            snprintf(c.name, sizeof(c.name), "용사%u", unsigned(i));
+        }
+        for (size_t i = 0; i < sessions.size(); ++i) sessions[i] = Session{uint32_t(i), 0, 0, 0, 0};
+        leaderboard.reserve(kLeaderboardSize + 1);
+    }
+
+    uint32_t currentTick() const { return tick; }
+
+    // 한 틱: 캐릭터 일부가 전투를 치르고 세션 입력이 들어옴 (시드와 틱 번호로 결정)
+    void step(size_t actorsPerTick) {
+        uint64_t rng = mix64(seed ^ (uint64_t(tick) << 32));
+        for (size_t k = 0; k < actorsPerTick; ++k) {
+            rng = mix64(rng);
+            Character& c = characters[rng % characters.size()];
+            int monsterAttack = 8 + 2 * c.dungeonLevel;
+            c.health -= max(1, monsterAttack - c.defense);
+            if (c.health <= 0) {
+                c.health = c.maxHealth;
+                c.gold = max(0, c.gold - 20);
+                c.dungeonLevel = max(1, c.dungeonLevel - 1);
+            } else {
+                c.experience += 10 + 3 * c.dungeonLevel;
+                c.gold += 5 + int(rng >> 60);
+                ++c.dungeonLevel;
+                if (c.experience >= c.level * 100) {
+                    c.level++;
+                    c.maxHealth += 20;
+                    c.health = c.maxHealth;
+                    c.attack += 5;
+                    c.defense += 2;
+                }
+                if (leaderboard.size() < kLeaderboardSize || c.experience > leaderboard.back().experience)
+                    updateLeaderboard(c);
+            }
+            Session& s = sessions[c.sessionId];
+            s.lastTick = tick;
+            s.inputSeq++;
+            s.x += int32_t(rng >> 62) - 1;
+            s.y += int32_t((rng >> 58) & 3) - 1;
+        }
+        ++tick;
+    }
+
+    uint64_t checksum() const {
+        uint64_t h = mix64(seed ^ tick);
+        auto fold = [&](const void* data, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            size_t i = 0;
+            for (; i + 8 <= bytes; i += 8) {
+                uint64_t w;
+                memcpy(&w, p + i, 8);
+                h = mix64(h ^ w);
+            }
+            for (; i < bytes; ++i) h = mix64(h ^ p[i]);
+        };
+        fold(characters.data(), characters.size() * sizeof(Character));
+        fold(sessions.data(), sessions.size() * sizeof(Session));
+        fold(leaderboard.data(), leaderboard.size() * sizeof(LeaderEntry));
+        return h;
+    }
+
+    size_t bytes() const {
+        return characters.size() * sizeof(Character) + sessions.size() * sizeof(Session)
+               + leaderboard.size() * sizeof(LeaderEntry);
+    }
+
+    // [2] 저장 파일: 헤더 + 배열 원본. 실패 시 false (자식 프로세스에서도 예외 없이 쓰도록)
+    struct SaveHeader {
+        char magic[4];
+        uint32_t tick;
+        uint64_t seed;
+        uint64_t characterCount, sessionCount, leaderCount;
+        uint64_t checksum;
+    };
+
+    bool writeTo(const string& path, uint64_t& bytesWritten) const {
+        string tmp = path + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        SaveHeader header{{'W', 'S', 'V', '1'}, tick, seed, characters.size(), sessions.size(),
+                          leaderboard.size(), checksum()};
+        auto writeAll = [&](const void* data, size_t n) {
+            const char* p = static_cast<const char*>(data);
+            while (n > 0) {
+                ssize_t w = ::write(fd, p, min(n, size_t(1) << 20));
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                p += w;
+                n -= size_t(w);
+                bytesWritten += size_t(w);
+            }
+            return true;
+        };
+        bool ok = writeAll(&header, sizeof(header))
+                  && writeAll(characters.data(), characters.size() * sizeof(Character))
+                  && writeAll(sessions.data(), sessions.size() * sizeof(Session))
+                  && writeAll(leaderboard.data(), leaderboard.size() * sizeof(LeaderEntry))
+                  && ::fsync(fd) == 0;
+        ok = (::close(fd) == 0) && ok;
+        return ok && ::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    static World load(const string& path) {
+        ifstream in(path, ios::binary);
+        if (!in) throw runtime_error("저장 파일을 열 수 없습니다: " + path);
+        SaveHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || memcmp(header.magic, "WSV1", 4) != 0) throw runtime_error("손상된 저장 파일: " + path);
+        World w(header.seed, 0);
+        w.tick = header.tick;
+        w.characters.resize(header.characterCount);
+        w.sessions.resize(header.sessionCount);
+        w.leaderboard.resize(header.leaderCount);
+        in.read(reinterpret_cast<char*>(w.characters.data()), w.characters.size() * sizeof(Character));
+        in.read(reinterpret_cast<char*>(w.sessions.data()), w.sessions.size() * sizeof(Session));
+        in.read(reinterpret_cast<char*>(w.leaderboard.data()), w.leaderboard.size() * sizeof(LeaderEntry));
+        if (!in || w.checksum() != header.checksum) throw runtime_error("체크섬 불일치: " + path);
+        return w;
+    }
+};
+
+// [3] fork 기반 백그라운드 저장
+long readPrivateDirtyKb() {
+    ifstream in("/proc/self/smaps_rollup");
+    string line;
+    while (getline(in, line)) {
+        if (line.rfind("Private_Dirty:", 0) == 0) {
+            istringstream fields(line.substr(14));
+            long kb = 0;
+            fields >> kb;
+            return kb;
+        }
+    }
+    return -1;      // smaps_rollup 이 없는 커널
+}
+
+long minorFaults() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+struct ChildReport {
+    double writeMs;
+    uint64_t bytes;
+    long privateDirtyKb;
+    bool ok;
+};
+
+class BackgroundSaver {
+private:
+    pid_t child = -1;
+    int reportFd = -1;
+    chrono::steady_clock::time_point started;
+    long faultsAtFork = 0;
+    uint32_t pendingTick = 0;
+    double pendingForkUs = 0;
+
+public:
+    struct Result {
+        uint32_t tick;
+        double forkUs, totalMs;
+        long parentCowFaults;
+        ChildReport report;
+    };
+
+    bool busy() const { return child > 0; }
+
+    double start(const World& world, const string& path) {
+        if (busy()) throw runtime_error("이미 저장 중입니다");
+        int fds[2];
+        if (pipe(fds) != 0) throw runtime_error("pipe 실패: " + string(strerror(errno)));
+
+        cout.flush();       // 자식이 부모의 출력 버퍼를 한 번 더 내보내지 않도록
+        started = chrono::steady_clock::now();
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            throw runtime_error("fork 실패: " + string(strerror(errno)));
+        }
+        if (pid == 0) {
+            // 자식: fork 순간의 세계를 쓰고 결과를 보고한 뒤 곧바로 종료 (소멸자/atexit 실행 안 함)
+            close(fds[0]);
+            setpriority(PRIO_PROCESS, 0, 10);
+            ChildReport report{};
+            auto t0 = chrono::steady_clock::now();
+            report.ok = world.writeTo(path, report.bytes);
+            report.writeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+            report.privateDirtyKb = readPrivateDirtyKb();
+            ssize_t w = write(fds[1], &report, sizeof(report));
+            _exit(report.ok && w == ssize_t(sizeof(report)) ? 0 : 1);
+        }
+        double forkUs = chrono::duration<double, micro>(chrono::steady_clock::now() - started).count();
+        close(fds[1]);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        child = pid;
+        reportFd = fds[0];
+        faultsAtFork = minorFaults();
+        pendingTick = world.currentTick();
+        pendingForkUs = forkUs;
+        return forkUs;
+    }
+
+    // 틱마다 호출: 끝났으면 결과를 채우고 true
+    bool poll(Result& out) {
+        if (!busy()) return false;
+        int status = 0;
+        pid_t r = waitpid(child, &status, WNOHANG);
+        if (r == 0) return false;
+        if (r < 0) throw runtime_error("waitpid 실패: " + string(strerror(errno)));
+
+        out.tick = pendingTick;
+        out.forkUs = pendingForkUs;
+        out.totalMs = chrono::duration<double, milli>(chrono::steady_clock::now() - started).count();
+        out.parentCowFaults = minorFaults() - faultsAtFork;
+        out.report = ChildReport{};
+        ssize_t n = read(reportFd, &out.report, sizeof(out.report));
+        close(reportFd);
+        child = -1;
+        reportFd = -1;
+        if (n != ssize_t(sizeof(out.report)) || !WIFEXITED(status) || WEXITSTATUS(status) != 0 || !out.report.ok)
+            throw runtime_error("백그라운드 저장 실패");
+        return true;
+    }
+
+    ~BackgroundSaver() {
+        if (busy()) {       // 진행 중인 저장은 끝까지 기다림 (반쯤 쓴 임시 파일은 rename 되지 않음)
+            waitpid(child, nullptr, 0);
+            close(reportFd);
+        }
+    }
+};
+
+// [4] 틱 루프: 고정 주기, 지연 = 예정 시작 시각부터 틱 작업이 끝날 때까지
+struct TickStats {
+    double worstIdleMs = 0, worstSavingMs = 0;
+    double sumIdleMs = 0;
+    int idleTicks = 0;
+
+    void record(double ms, bool saving) {
+        if (saving) {
+            worstSavingMs = max(worstSavingMs, ms);
+        } else {
+            worstIdleMs = max(worstIdleMs, ms);
+            sumIdleMs += ms;
+            ++idleTicks;
+        }
+    }
+};
+
+enum class SaveMode { Fork, InTick };
+
+TickStats runServer(World& world, int ticks, int periodMs, size_t actorsPerTick, int saveEvery,
+                    SaveMode mode, const string& path, vector<BackgroundSaver::Result>& saves) {
+    TickStats stats;
+    BackgroundSaver saver;
+    auto next = chrono::steady_clock::now();
+    bool previousAffected = false;
+    for (int t = 0; t < ticks; ++t) {
+        this_thread::sleep_until(next);
+        // 저장 때문에 밀린 틱이 늦게 시작한 것도 저장의 영향으로 침
+        bool lateStart = chrono::steady_clock::now() - next > chrono::milliseconds(1);
+        bool saving = saver.busy() || (previousAffected && lateStart);
+        world.step(actorsPerTick);
+
+        if (t > 0 && t % saveEvery == 0) {
+            if (mode == SaveMode::Fork) {
+                if (!saver.busy()) {
+                    saver.start(world, path);
+                    saving = true;
+                }
+            } else {
+                BackgroundSaver::Result r{};
+                r.tick = world.currentTick();
+                auto t0 = chrono::steady_clock::now();
+                r.report.ok = world.writeTo(path, r.report.bytes);
+                r.totalMs = r.report.writeMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+                if (!r.report.ok) throw runtime_error("저장 실패: " + path);
+                saves.push_back(r);
+                saving = true;
+            }
+        }
+        BackgroundSaver::Result done;
+        if (saver.poll(done)) saves.push_back(done);
+
+        stats.record(chrono::duration<double, milli>(chrono::steady_clock::now() - next).count(), saving);
+        previousAffected = saving;
+        next += chrono::milliseconds(periodMs);
+    }
+    BackgroundSaver::Result done;
+    while (saver.busy()) {      // 마지막 저장이 끝날 때까지
+        this_thread::sleep_for(chrono::milliseconds(1));
+        if (saver.poll(done)) saves.push_back(done);
+    }
+    return stats;
+}
+
+// 저장 파일이 그 틱의 세계와 정확히 같은지: 같은 시드로 재실행해 비교
+bool verifySave(const string& path, uint64_t seed, size_t characters, size_t actorsPerTick) {
+    World saved = World::load(path);
+    World replay(seed, characters);
+    while (replay.currentTick() < saved.currentTick()) replay.step(actorsPerTick);
+    return replay.checksum() == saved.checksum();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t characterCount = argc > 1 ? stoul(argv[1]) : 400000;
+        int ticks = argc > 2 ? stoi(argv[2]) : 250;
+        int periodMs = argc > 3 ? stoi(argv[3]) : 10;
+        if (characterCount < 4 || ticks < 2 || periodMs < 1) throw invalid_argument("잘못된 인자");
+        const size_t actorsPerTick = 2000;
+        const int saveEvery = 100;
+        const uint64_t seed = 2024;
+        const string path = "world_autosave.bin";
+
+        World probe(seed, characterCount);
+        cout << "=== fork() 자동 저장 ===" << endl;
+        cout << "캐릭터 " << characterCount << "명, 세계 " << probe.bytes() / (1024.0 * 1024.0)
+             << " MB, 틱 " << ticks << "회 x " << periodMs << "ms, 틱마다 " << actorsPerTick
+             << "명 행동, " << saveEvery << "틱마다 저장" << endl;
+
+        const char* names[] = {"fork 백그라운드 저장", "틱 안에서 동기 저장"};
+        for (SaveMode mode : {SaveMode::Fork, SaveMode::InTick}) {
+            World world(seed, characterCount);
+            vector<BackgroundSaver::Result> saves;
+            TickStats stats = runServer(world, ticks, periodMs, actorsPerTick, saveEvery, mode, path, saves);
+
+            cout << "\n[" << names[int(mode)] << "]" << endl;
+            cout << "평상시 틱: 평균 " << stats.sumIdleMs / max(1, stats.idleTicks) << " ms, 최악 "
+                 << stats.worstIdleMs << " ms | 저장 중 최악 틱 " << stats.worstSavingMs << " ms" << endl;
+            for (const auto& s : saves) {
+                cout << "  틱 " << s.tick << " 저장: 전체 " << s.totalMs << " ms (쓰기 " << s.report.writeMs
+                     << " ms, " << s.report.bytes / (1024 * 1024) << " MB)";
+                if (mode == SaveMode::Fork) {
+                    cout << ", fork() " << s.forkUs << " us, 부모 COW 폴트 " << s.parentCowFaults
+                         << " 페이지, 자식 Private_Dirty ";
+                    if (s.report.privateDirtyKb >= 0) cout << s.report.privateDirtyKb / 4 << " 페이지";
+                    else cout << "측정 불가";
+                }
+                cout << endl;
+            }
+            if (!saves.empty()) {
+                bool ok = verifySave(path, seed, characterCount, actorsPerTick);
+                cout << "  마지막 저장 파일 = 틱 " << saves.back().tick << " 재실행 결과: "
+                     << (ok ? "일치" : "불일치!") << endl;
+                if (!ok) return 1;
+            }
+        }
+        remove(path.c_str());
+        return 0;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,664 @@
+/*
+ * 파일명: 18_crafting_recipe_solver.cpp
+ *
+ * 주제: 레시피 그래프 메모이제이션 풀이기 (Memoized Recipe DAG Solver)
+ * 정의: 아이템을 다른 아이템으로 제작할 수 있고 레시피가 DAG 를 이룰 때, "지금 인벤토리로
+ *       X 를 얻는 가장 싼 골드 비용"을 메모이제이션으로 답하고, 가격이나 인벤토리가 바뀌면
+ *       영향받는 노드만 무효화하는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 아이템은 상점/드롭으로만 얻음. 제작 그래프가 커지면 질의마다 전체를 다시 풀면 너무 느림
+ *
+ * 핵심 개념:
+ * - 비용(x) = min(상점가(x), min_레시피 (수수료 + Σ 부족분 × 비용(재료)))
+ *   부족분 = max(0, 필요 수량 - 보유 수량), 이미 가진 x 는 비용 0
+ *   (보유 아이템은 재료 자리마다 독립적으로 쓸 수 있다고 보는 근사 → 실제 제작 비용의 하한.
+ *    실제 제작은 재료를 하나씩 소비하며 다시 질의하므로 항상 정확한 금액을 냄)
+ * - 그래프는 CSR(압축 배열)로 저장, 생성 시 위상 정렬로 순환 레시피를 거부
+ * - 지연 계산: 질의한 노드의 하위 그래프 중 무효인 것만 반복형 DFS 로 계산 (재귀 깊이 문제 없음)
+ * - 불변식 "유효한 노드의 자손은 모두 유효" → 가격/보유량이 바뀌면 그 노드와 유효한 조상만
+ *   역방향 간선으로 무효화하고, 이미 무효인 조상에서 멈춤
+ * - game.cpp 의 Item, Player::inventory 를 그대로 사용: 이름으로 아이템 ID 를 찾고,
+ *   인벤토리 동기화는 수량이 바뀐 아이템만 무효화
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o crafting 18_crafting_recipe_solver.cpp
+ * 실행: ./crafting [아이템(노드) 수] [질의 수] [갱신 1회당 질의 수]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+using namespace std;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] chapter08/game.cpp 의 Item / Player (제작에 필요한 부분만)
+class Item {
+private:
+    string name;
+    int healAmount;
+    int attackBonus;
+
+public:
+    Item(const string& n, int heal = 0, int attack = 0) : name(n), healAmount(heal), attackBonus(attack) {}
+    const string& getName() const { return name; }
+    int getHealAmount() const { return healAmount; }
+    int getAttackBonus() const { return attackBonus; }
+};
+
+class Player {
+private:
+    string name;
+    vector<unique_ptr<Item>> inventory;
+    int gold;
+
+public:
+    Player(const string& n) : name(n), gold(50) {
+        inventory.push_back(make_unique<Item>("체력 포션", 30, 0));
+        inventory.push_back(make_unique<Item>("힘의 물약", 0, 10));
+    }
+
+    const vector<unique_ptr<Item>>& getInventory() const { return inventory; }
+    int getGold() const { return gold; }
+    void gainGold(int amount) { gold += amount; }
+    void spendGold(int amount) {
+        if (amount > gold) throw runtime_error("골드가 부족합니다");
+        gold -= amount;
+    }
+    void addItem(unique_ptr<Item> item) { inventory.push_back(move(item)); }
+    void removeItem(const string& itemName) {
+        auto it = find_if(inventory.begin(), inventory.end(),
+                          [&](const unique_ptr<Item>& i) { return i->getName() == itemName; });
+        if (it == inventory.end()) throw runtime_error("인벤토리에 없는 아이템: " + itemName);
+        inventory.erase(it);
+    }
+    void showInventory() const {
+        cout << name << " (골드 " << gold << "G): ";
+        for (const auto& item : inventory) cout << "[" << item->getName() << "] ";
+        cout << endl;
+    }
+};
+
+// [2] 레시피 그래프 (구조는 build() 이후 불변, CSR 배열)
+using ItemId = uint32_t;
+using Gold = int64_t;
+constexpr Gold kUnobtainable = numeric_limits<Gold>::max() / 4;
+
+struct Ingredient {
+    ItemId item;
+    uint32_t quantity;
+};
+
+struct Recipe {
+    Gold fee;
+    uint32_t firstInput, inputCount;
+};
+
+class RecipeBook {
+private:
+    struct ItemDef {
+        string name;
+        int healAmount, attackBonus;
+        Gold shopPrice;     // kUnobtainable = 상점에서 팔지 않음
+    };
+    vector<ItemDef> items;
+    unordered_map<string, ItemId> byName;
+
+    // 생성 중: 아이템별 레시피 목록 → build() 에서 CSR 로 압축
+    vector<vector<pair<Gold, vector<Ingredient>>>> pending;
+
+    vector<uint32_t> recipeStart;       // 아이템 i 의 레시피 = recipes[recipeStart[i] .. recipeStart[i+1])
+    vector<Recipe> recipes;
+    vector<Ingredient> inputs;
+    vector<uint32_t> parentStart;       // 재료 → 그것을 쓰는 아이템 (무효화용 역방향 간선)
+    vector<ItemId> parents;
+    bool built = false;
+
+public:
+    ItemId addItem(const string& name, Gold shopPrice, int heal = 0, int attack = 0) {
+        if (built) throw logic_error("build() 이후에는 아이템을 추가할 수 없습니다");
+        if (byName.count(name)) throw invalid_argument("중복 아이템: " + name);
+        ItemId id = ItemId(items.size());
+        items.push_back(ItemDef{name, heal, attack, shopPrice});
+        byName.emplace(name, id);
+        pending.emplace_back();
+        return id;
+    }
+
+    void addRecipe(ItemId output, Gold fee, vector<Ingredient> ingredients) {
+        if (built) throw logic_error("build() 이후에는 레시피를 추가할 수 없습니다");
+        if (output >= items.size() || ingredients.empty()) throw invalid_argument("잘못된 레시피");
+        for (const Ingredient& in : ingredients) {
+            if (in.item >= items.size() || in.quantity == 0) throw invalid_argument("잘못된 재료");
+        }
+        pending[output].emplace_back(fee, move(ingredients));
+    }
+
+    void build() {
+        size_t n = items.size();
+        recipeStart.assign(n + 1, 0);
+        vector<uint32_t> parentCount(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) {
+            recipeStart[i + 1] = recipeStart[i] + uint32_t(pending[i].size());
+            for (auto& [fee, ingredients] : pending[i]) {
+                recipes.push_back(Recipe{fee, uint32_t(inputs.size()), uint32_t(ingredients.size())});
+                for (const Ingredient& in : ingredients) {
+                    inputs.push_back(in);
+                    parentCount[in.item + 1]++;
+                }
+            }
+        }
+        pending.clear();
+        pending.shrink_to_fit();
+
+        parentStart.assign(n + 1, 0);
+        for (size_t i = 0; i < n; ++i) parentStart[i + 1] = parentStart[i] + parentCount[i + 1];
+        parents.resize(parentStart[n]);
+        vector<uint32_t> fill(parentStart.begin(), parentStart.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            for (uint32_t r = recipeStart[i]; r < recipeStart[i + 1]; ++r) {
+                for (uint32_t k = 0; k < recipes[r].inputCount; ++k)
+                    parents[fill[inputs[recipes[r].firstInput + k].item]++] = ItemId(i);
+            }
+        }
+
+        // 위상 정렬(Kahn): 재료 → 결과물 순서로 모두 방문하지 못하면 순환
+        vector<uint32_t> remaining(n);
+        vector<ItemId> ready;
+        for (size_t i = 0; i < n; ++i) {
+            for (uint32_t r = recipeStart[i]; r < recipeStart[i + 1]; ++r) remaining[i] += recipes[r].inputCount;
+            if (remaining[i] == 0) ready.push_back(ItemId(i));
+        }
+        size_t visited = 0;
+        while (!ready.empty()) {
+            ItemId u = ready.back();
+            ready.pop_back();
+            ++visited;
+            for (uint32_t p = parentStart[u]; p < parentStart[u + 1]; ++p) {
+                if (--remaining[parents[p]] == 0) ready.push_back(parents[p]);
+            }
+        }
+        if (visited != n) throw invalid_argument("순환 레시피가 있습니다 (레시피 그래프는 DAG 여야 함)");
+        built = true;
+    }
+
+    size_t size() const { return items.size(); }
+    size_t recipeCount() const { return recipes.size(); }
+    ItemId find(const string& name) const {
+        auto it = byName.find(name);
+        if (it == byName.end()) throw invalid_argument("알 수 없는 아이템: " + name);
+        return it->second;
+    }
+    bool contains(const string& name) const { return byName.count(name) > 0; }
+    const string& name(ItemId id) const { return items[id].name; }
+    Gold defaultShopPrice(ItemId id) const { return items[id].shopPrice; }
+    unique_ptr<Item> makeItem(ItemId id) const {
+        return make_unique<Item>(items[id].name, items[id].healAmount, items[id].attackBonus);
+    }
+
+    uint32_t recipesBegin(ItemId id) const { return recipeStart[id]; }
+    uint32_t recipesEnd(ItemId id) const { return recipeStart[id + 1]; }
+    const Recipe& recipe(uint32_t r) const { return recipes[r]; }
+    const Ingredient& input(uint32_t k) const { return inputs[k]; }
+    uint32_t parentsBegin(ItemId id) const { return parentStart[id]; }
+    uint32_t parentsEnd(ItemId id) const { return parentStart[id + 1]; }
+    ItemId parent(uint32_t p) const { return parents[p]; }
+};
+
+// [3] 메모이제이션 풀이기: 가격·보유량은 여기서 관리하고, 바뀌면 조상만 무효화
+class CraftingSolver {
+public:
+    static constexpr uint32_t kBuy = numeric_limits<uint32_t>::max();
+
+private:
+    const RecipeBook& book;
+    vector<Gold> shopPrice;
+    vector<uint32_t> owned;
+    vector<Gold> unitCost;          // 하나를 새로 얻는 비용 (보유분 제외)
+    vector<uint32_t> choice;        // kBuy 또는 최적 레시피 번호
+    vector<uint8_t> valid;
+    vector<ItemId> stack;
+    size_t recomputed = 0, invalidated = 0;
+
+    static Gold saturate(Gold g) { return min(g, kUnobtainable); }
+
+    void compute(ItemId x) {
+        Gold best = shopPrice[x];
+        uint32_t bestChoice = kBuy;
+        for (uint32_t r = book.recipesBegin(x); r < book.recipesEnd(x); ++r) {
+            const Recipe& rec = book.recipe(r);
+            Gold total = rec.fee;
+            for (uint32_t k = 0; k < rec.inputCount && total < best; ++k) {
+                const Ingredient& in = book.input(rec.firstInput + k);
+                uint32_t missing = in.quantity > owned[in.item] ? in.quantity - owned[in.item] : 0;
+                if (missing) total = saturate(total + saturate(Gold(missing) * unitCost[in.item]));
+            }
+            if (total < best) {
+                best = total;
+                bestChoice = r;
+            }
+        }
+        unitCost[x] = best;
+        choice[x] = bestChoice;
+        valid[x] = 1;
+        ++recomputed;
+    }
+
+    // 무효인 하위 노드만 반복형 DFS 로 계산 (재료가 모두 유효해지면 자신을 계산)
+    void ensure(ItemId root) {
+        if (valid[root]) return;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            ItemId u = stack.back();
+            if (valid[u]) {
+                stack.pop_back();
+                continue;
+            }
+            bool ready = true;
+            for (uint32_t r = book.recipesBegin(u); r < book.recipesEnd(u); ++r) {
+                const Recipe& rec = book.recipe(r);
+                for (uint32_t k = 0; k < rec.inputCount; ++k) {
+                    ItemId v = book.input(rec.firstInput + k).item;
+                    if (!valid[v]) {
+                        stack.push_back(v);
+                        ready = false;
+                    }
+                }
+            }
+            if (ready) {
+                compute(u);
+                stack.pop_back();
+            }
+        }
+    }
+
+    // 유효한 조상만 따라 올라감: 무효 노드의 조상은 이미 무효이므로 거기서 멈춤
+    void invalidate(ItemId x) {
+        if (!valid[x]) return;
+        valid[x] = 0;
+        stack.push_back(x);
+        while (!stack.empty()) {
+            ItemId u = stack.back();
+            stack.pop_back();
+            ++invalidated;
+            for (uint32_t p = book.parentsBegin(u); p < book.parentsEnd(u); ++p) {
+                ItemId parent = book.parent(p);
+                if (valid[parent]) {
+                    valid[parent] = 0;
+                    stack.push_back(parent);
+                }
+            }
+        }
+    }
+
+public:
+    explicit CraftingSolver(const RecipeBook& b)
+        : book(b), shopPrice(b.size()), owned(b.size(), 0), unitCost(b.size(), 0),
+          choice(b.size(), kBuy), valid(b.size(), 0) {
+        for (ItemId i = 0; i < b.size(); ++i) shopPrice[i] = b.defaultShopPrice(i);
+    }
+
+    // 인벤토리를 고려한 X 한 개의 최소 골드 비용 (kUnobtainable = 얻을 방법 없음)
+    Gold cheapest(ItemId x) {
+        if (owned[x] > 0) return 0;
+        ensure(x);
+        return unitCost[x];
+    }
+
+    // X 를 새로 하나 얻을 때의 최적 선택 (kBuy 또는 레시피 번호)
+    uint32_t bestChoice(ItemId x) {
+        ensure(x);
+        return choice[x];
+    }
+
+    void setShopPrice(ItemId x, Gold price) {
+        if (shopPrice[x] == price) return;
+        shopPrice[x] = price;
+        invalidate(x);
+    }
+
+    void setOwned(ItemId x, uint32_t count) {
+        if (owned[x] == count) return;
+        owned[x] = count;
+        // x 자신의 unitCost 는 보유량과 무관 → 부모부터 무효화
+        for (uint32_t p = book.parentsBegin(x); p < book.parentsEnd(x); ++p) invalidate(book.parent(p));
+    }
+
+    uint32_t ownedCount(ItemId x) const { return owned[x]; }
+    Gold price(ItemId x) const { return shopPrice[x]; }
+    size_t recomputedNodes() const { return recomputed; }
+    size_t invalidatedNodes() const { return invalidated; }
+};
+
+// 비교 대상: 메모 없이 질의마다 하위 그래프 전체를 다시 푸는 방식 (같은 점화식)
+class NaiveSolver {
+private:
+    const RecipeBook& book;
+    const CraftingSolver& state;    // 가격·보유량만 빌려 씀
+    vector<Gold> cost;
+    vector<uint32_t> stamp;
+    uint32_t epoch = 0;
+    vector<pair<ItemId, bool>> stack;
+
+public:
+    NaiveSolver(const RecipeBook& b, const CraftingSolver& s)
+        : book(b), state(s), cost(b.size()), stamp(b.size(), 0) {}
+
+    Gold cheapest(ItemId root) {
+        if (state.ownedCount(root) > 0) return 0;
+        ++epoch;
+        stack.push_back({root, false});
+        while (!stack.empty()) {
+            auto [u, expanded] = stack.back();
+            stack.pop_back();
+            if (stamp[u] == epoch) continue;
+            if (!expanded) {
+                stack.push_back({u, true});
+                for (uint32_t r = book.recipesBegin(u); r < book.recipesEnd(u); ++r) {
+                    const Recipe& rec = book.recipe(r);
+                    for (uint32_t k = 0; k < rec.inputCount; ++k) {
+                        ItemId v = book.input(rec.firstInput + k).item;
+                        if (stamp[v] != epoch) stack.push_back({v, false});
+                    }
+                }
+                continue;
+            }
+            Gold best = state.price(u);
+            for (uint32_t r = book.recipesBegin(u); r < book.recipesEnd(u); ++r) {
+                const Recipe& rec = book.recipe(r);
+                Gold total = rec.fee;
+                for (uint32_t k = 0; k < rec.inputCount; ++k) {
+                    const Ingredient& in = book.input(rec.firstInput + k);
+                    uint32_t have = state.ownedCount(in.item);
+                    uint32_t missing = in.quantity > have ? in.quantity - have : 0;
+                    if (missing) total = min(kUnobtainable, total + min(kUnobtainable, Gold(missing) * cost[in.item]));
+                }
+                best = min(best, total);
+            }
+            cost[u] = best;
+            stamp[u] = epoch;
+        }
+        return cost[root];
+    }
+};
+
+// [4] 플레이어 인벤토리와 연결: 동기화 + 실제 제작
+class Crafter {
+private:
+    const RecipeBook& book;
+    CraftingSolver& solver;
+
+    // 제작 계획: 실행 전까지 Player 는 건드리지 않고 소비할 아이템·지출·출력만 모아 둠
+    struct Plan {
+        vector<ItemId> consumed;
+        Gold gold = 0;
+        vector<pair<ItemId, uint32_t>> ownedBefore;     // 되돌릴 solver 보유량 (바뀐 순서대로)
+        string log;
+    };
+
+    void setOwned(Plan& plan, ItemId x, uint32_t count) {
+        plan.ownedBefore.push_back({x, solver.ownedCount(x)});
+        solver.setOwned(x, count);
+    }
+
+    // 이미 가진 것은 소비, 모자라면 최적 선택(상점/레시피)대로 하나씩 마련.
+    // 소비할 때마다 보유량이 바뀌어 무효화되므로 다음 선택은 항상 현재 인벤토리 기준
+    void obtain(Plan& plan, ItemId x, uint32_t quantity, bool keep) {
+        for (uint32_t n = 0; n < quantity; ++n) {
+            if (!keep && solver.ownedCount(x) > 0) {
+                plan.consumed.push_back(x);
+                plan.log += "  사용: 보유한 " + book.name(x) + "\n";
+                setOwned(plan, x, solver.ownedCount(x) - 1);
+                continue;
+            }
+            if (solver.cheapest(x) >= kUnobtainable) throw runtime_error("얻을 방법이 없는 아이템: " + book.name(x));
+            uint32_t how = solver.bestChoice(x);
+            if (how == CraftingSolver::kBuy) {
+                plan.gold += solver.price(x);
+                plan.log += "  구매: " + book.name(x) + " (" + to_string(solver.price(x)) + "G)\n";
+            } else {
+                const Recipe& rec = book.recipe(how);
+                for (uint32_t k = 0; k < rec.inputCount; ++k) {
+                    const Ingredient& in = book.input(rec.firstInput + k);
+                    obtain(plan, in.item, in.quantity, false);
+                }
+                plan.gold += rec.fee;
+                plan.log += "  제작: " + book.name(x) + " (수수료 " + to_string(rec.fee) + "G)\n";
+            }
+            if (keep) setOwned(plan, x, solver.ownedCount(x) + 1);
+        }
+    }
+
+    void rollback(const Plan& plan) {
+        for (auto it = plan.ownedBefore.rbegin(); it != plan.ownedBefore.rend(); ++it) solver.setOwned(it->first, it->second);
+    }
+
+public:
+    Crafter(const RecipeBook& b, CraftingSolver& s) : book(b), solver(s) {}
+
+    // Player::inventory 를 세어 바뀐 아이템만 solver 에 알림
+    void syncInventory(const Player& player) {
+        unordered_map<ItemId, uint32_t> counts;
+        for (const auto& item : player.getInventory()) {
+            if (book.contains(item->getName())) counts[book.find(item->getName())]++;
+        }
+        for (ItemId i = 0; i < book.size(); ++i) {
+            auto it = counts.find(i);
+            solver.setOwned(i, it == counts.end() ? 0 : it->second);
+        }
+    }
+
+    // 전체 계획을 먼저 세우고, 골드·재료가 모두 충분할 때만 인벤토리에 반영 (실패하면 아무것도 바뀌지 않음)
+    Gold craft(Player& player, const string& itemName) {
+        ItemId x = book.find(itemName);
+        if (solver.cheapest(x) > player.getGold()) throw runtime_error("골드가 부족합니다: " + itemName);
+        Plan plan;
+        try {
+            obtain(plan, x, 1, true);
+            if (plan.gold > player.getGold()) throw runtime_error("골드가 부족합니다: " + itemName);
+            unordered_map<string, uint32_t> have;
+            for (const auto& item : player.getInventory()) have[item->getName()]++;
+            for (ItemId c : plan.consumed) {
+                if (have[book.name(c)]-- == 0) throw runtime_error("인벤토리에 없는 아이템: " + book.name(c));
+            }
+        } catch (...) {
+            rollback(plan);
+            throw;
+        }
+        // 여기부터는 실패하지 않음 (골드와 재료를 위에서 확인)
+        player.spendGold(int(plan.gold));
+        for (ItemId c : plan.consumed) player.removeItem(book.name(c));
+        player.addItem(book.makeItem(x));
+        cout << plan.log;
+        return plan.gold;
+    }
+};
+
+// [5] 데모용 작은 레시피 (game.cpp 의 포션 포함)
+RecipeBook makeDemoBook() {
+    RecipeBook book;
+    ItemId herb = book.addItem("약초", 4);
+    ItemId bottle = book.addItem("빈 병", 3);
+    ItemId blood = book.addItem("트롤의 피", 25);
+    ItemId ore = book.addItem("철광석", 6);
+    ItemId ingot = book.addItem("철괴", 20);
+    ItemId potion = book.addItem("체력 포션", 25, 30, 0);
+    ItemId bigPotion = book.addItem("큰 체력 포션", kUnobtainable, 80, 0);
+    ItemId strength = book.addItem("힘의 물약", 60, 0, 10);
+    ItemId sword = book.addItem("강철 검", 150, 0, 15);
+    ItemId elixir = book.addItem("용사의 영약", kUnobtainable, 100, 20);
+
+    book.addRecipe(potion, 2, {{herb, 3}, {bottle, 1}});
+    book.addRecipe(bigPotion, 5, {{potion, 2}, {herb, 2}});
+    book.addRecipe(strength, 10, {{blood, 1}, {bottle, 1}});
+    book.addRecipe(ingot, 2, {{ore, 2}});
+    book.addRecipe(sword, 15, {{ingot, 4}});
+    book.addRecipe(elixir, 30, {{bigPotion, 1}, {strength, 1}});
+    book.addRecipe(elixir, 80, {{potion, 1}, {blood, 2}});
+    book.build();
+    return book;
+}
+
+// 벤치마크용 큰 레시피 그래프: 계층형, 재료는 대부분 같은 분류의 하위 계층에서 고름
+RecipeBook makeGeneratedBook(size_t itemCount, uint64_t seed) {
+    RecipeBook book;
+    const size_t tiers = 8, categories = 64;
+    size_t perTier = max<size_t>(1, itemCount / tiers);
+    for (size_t i = 0; i < itemCount; ++i) {
+        uint64_t h = mix64(seed ^ i);
+        size_t tier = min(tiers - 1, i / perTier);
+        Gold price = tier == 0 ? Gold(1 + h % 50)
+                     : (h % 3 == 0 ? kUnobtainable : Gold(40 * tier + (h >> 20) % (200 * tier)));
+        book.addItem("아이템" + to_string(i), price);
+    }
+    for (size_t i = perTier; i < itemCount; ++i) {
+        uint64_t h = mix64(seed ^ (i * 7919));
+        size_t tier = min(tiers - 1, i / perTier);
+        size_t category = i % categories;
+        int recipeCount = 1 + int(h % 3);
+        for (int r = 0; r < recipeCount; ++r) {
+            vector<Ingredient> ingredients;
+            int inputCount = 2 + int((h >> (8 + r * 4)) % 3);
+            for (int k = 0; k < inputCount; ++k) {
+                h = mix64(h);
+                size_t lowerTier = tier - 1 - (h % 4 == 0 ? (h >> 8) % tier : 0);
+                // 90% 는 같은 분류(i % 64 가 같은 아이템), 10% 는 아무 분류
+                size_t slot = (h >> 16) % (perTier / categories);
+                size_t pick = (h >> 40) % 10 == 0 ? lowerTier * perTier + (h >> 24) % perTier
+                                                  : lowerTier * perTier + slot * categories + category;
+                ingredients.push_back(Ingredient{ItemId(min(pick, i - 1)), uint32_t(1 + (h >> 56) % 3)});
+            }
+            book.addRecipe(ItemId(i), Gold(1 + (h >> 32) % 20), move(ingredients));
+        }
+    }
+    book.build();
+    return book;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t itemCount = argc > 1 ? stoul(argv[1]) : 100000;
+        size_t queries = argc > 2 ? stoul(argv[2]) : 200000;
+        size_t queriesPerUpdate = argc > 3 ? stoul(argv[3]) : 50;
+        if (itemCount < 1024 || queriesPerUpdate == 0) throw invalid_argument("아이템 수는 1024 이상이어야 합니다");
+
+        // 데모: game.cpp 플레이어가 가진 포션을 고려해 영약을 가장 싸게 제작
+        cout << "=== 제작 데모 ===" << endl;
+        RecipeBook demo = makeDemoBook();
+        CraftingSolver demoSolver(demo);
+        Crafter crafter(demo, demoSolver);
+        Player player("용사");
+        player.gainGold(300);
+        crafter.syncInventory(player);
+        player.showInventory();
+        for (const char* target : {"용사의 영약", "강철 검"}) {
+            ItemId id = demo.find(target);
+            Gold estimate = demoSolver.cheapest(id);
+            cout << target << " 예상 비용: " << estimate << "G" << endl;
+            Gold spent = crafter.craft(player, target);
+            cout << "실제 지출: " << spent << "G" << endl;
+            player.showInventory();
+        }
+        ItemId ingot = demo.find("철괴");
+        cout << "철괴 비용: " << demoSolver.cheapest(ingot) << "G";
+        demoSolver.setShopPrice(demo.find("철광석"), 2);
+        cout << " → 철광석 6G 에서 2G 로 내린 뒤: " << demoSolver.cheapest(ingot) << "G" << endl;
+
+        // 예상 비용은 하한: 두 재료가 보유한 약초 하나를 같이 쓴다고 보므로 실제로는 더 듦.
+        // 골드가 모자라 중간에 실패해도 인벤토리·골드·solver 상태가 그대로여야 함
+        bool rolledBack;
+        {
+            RecipeBook tiny;
+            ItemId herb = tiny.addItem("약초", 10);
+            ItemId left = tiny.addItem("왼쪽 부적", kUnobtainable);
+            ItemId right = tiny.addItem("오른쪽 부적", kUnobtainable);
+            ItemId charm = tiny.addItem("쌍둥이 부적", kUnobtainable);
+            tiny.addRecipe(left, 1, {{herb, 1}});
+            tiny.addRecipe(right, 1, {{herb, 1}});
+            tiny.addRecipe(charm, 0, {{left, 1}, {right, 1}});
+            tiny.build();
+            CraftingSolver tinySolver(tiny);
+            Crafter tinyCrafter(tiny, tinySolver);
+            Player poor("견습생");
+            poor.spendGold(45);
+            poor.addItem(tiny.makeItem(herb));
+            tinyCrafter.syncInventory(poor);
+            Gold estimate = tinySolver.cheapest(charm);
+            bool threw = false;
+            try {
+                tinyCrafter.craft(poor, "쌍둥이 부적");
+            } catch (const runtime_error& e) {
+                threw = true;
+                cout << "\n예상 " << estimate << "G, 보유 " << poor.getGold() << "G 로 제작 시도 → " << e.what() << endl;
+            }
+            rolledBack = threw && poor.getGold() == 5 && poor.getInventory().size() == 3 &&
+                         tinySolver.ownedCount(herb) == 1 && tinySolver.cheapest(charm) == estimate;
+            poor.gainGold(10);
+            Gold spent = tinyCrafter.craft(poor, "쌍둥이 부적");
+            rolledBack &= spent == 12 && poor.getGold() == 3 && tinySolver.ownedCount(charm) == 1 && tinySolver.ownedCount(herb) == 0;
+            cout << "실패 뒤 상태 보존, 골드 보충 후 " << spent << "G 로 제작: " << (rolledBack ? "통과" : "실패") << endl;
+        }
+
+        // 벤치마크
+        cout << "\n=== 레시피 그래프 " << itemCount << "개 노드 ===" << endl;
+        auto t0 = chrono::steady_clock::now();
+        RecipeBook book = makeGeneratedBook(itemCount, 77);
+        cout << "생성+위상 검사: " << chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count()
+             << " ms, 레시피 " << book.recipeCount() << "개" << endl;
+
+        CraftingSolver solver(book);
+        NaiveSolver naive(book, solver);
+        size_t perTier = itemCount / 8;
+        uint64_t rng = 12345;
+        auto randomTarget = [&] { rng = mix64(rng); return ItemId(itemCount - 1 - rng % (perTier * 3)); };
+        auto randomUpdate = [&] {
+            rng = mix64(rng);
+            ItemId x = ItemId(rng % itemCount);
+            if (rng >> 63) solver.setShopPrice(ItemId(x % perTier), Gold(1 + (rng >> 8) % 50));  // 기본 재료 시세 변동
+            else solver.setOwned(x, uint32_t((rng >> 8) % 3));                                  // 인벤토리 변화
+        };
+
+        // 표본 질의는 메모 없는 방식으로도 풀어 결과를 비교하고, 그 시간은 따로 잼
+        size_t checks = 0, mismatches = 0;
+        double naiveSec = 0;
+        t0 = chrono::steady_clock::now();
+        for (size_t q = 0; q < queries; ++q) {
+            if (q % queriesPerUpdate == 0) randomUpdate();
+            ItemId x = randomTarget();
+            Gold c = solver.cheapest(x);
+            if (q % 97 == 0) {
+                auto n0 = chrono::steady_clock::now();
+                mismatches += naive.cheapest(x) != c;
+                naiveSec += chrono::duration<double>(chrono::steady_clock::now() - n0).count();
+                ++checks;
+            }
+        }
+        double memoSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count() - naiveSec;
+
+        size_t updates = (queries + queriesPerUpdate - 1) / queriesPerUpdate;
+        cout << "메모이제이션: 질의 " << queries << "회 + 갱신 " << updates << "회, " << memoSec * 1000 << " ms → "
+             << size_t(queries / memoSec) << " 질의/초" << endl;
+        cout << "  갱신당 무효화 " << double(solver.invalidatedNodes()) / updates << "개, 질의당 재계산 "
+             << double(solver.recomputedNodes()) / queries << "개" << endl;
+        cout << "메모 없음    : " << size_t(checks / naiveSec) << " 질의/초 (메모이제이션이 "
+             << (queries / memoSec) / (checks / naiveSec) << "배 빠름)" << endl;
+        cout << "표본 검증 " << checks << "회, 불일치 " << mismatches << "회" << endl;
+        return mismatches == 0 && rolledBack ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
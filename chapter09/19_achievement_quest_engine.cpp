@@ -0,0 +1,538 @@
+/*
+ * 파일명: 19_achievement_quest_engine.cpp
+ *
+ * 주제: 색인된 트리거로 도는 이벤트 기반 업적/퀘스트 엔진 (Event-driven Rules with Indexed Triggers)
+ * 정의: 게임 코드가 "경험치 획득, 레벨 업, 몬스터 처치, 아이템 사용, 휴식" 같은 이벤트를 내보내면,
+ *       (플레이어, 이벤트 종류, 키) 로 색인된 규칙만 깨워서 진행도를 갱신하는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 업적이 없고, 만들더라도 "이벤트마다 모든 규칙을 검사" 하면 규칙 수에 비례해 느려짐
+ *
+ * 핵심 개념:
+ * - 이벤트 = (종류, 플레이어, 키, 값). 키는 몬스터/아이템 이름을 정수로 바꾼 것 (0 = 아무거나)
+ * - 색인: (플레이어, 종류, 키) → 그 이벤트를 기다리는 규칙 목록. 이벤트 하나당 조회 두 번
+ *   (정확한 키 + "아무 키") → 전체 규칙 수와 무관
+ * - 규칙 종류: 횟수(고블린 100마리), 합계(경험치 5000), 도달(레벨 20)
+ *   + 초기화 트리거("휴식 없이": 휴식 이벤트가 오면 진행도 0 또는 실패)
+ * - 퀘스트 = 단계 사슬: 한 단계를 끝내면 다음 단계 규칙을 색인에 등록
+ * - 완료/실패한 규칙은 색인에서 즉시 제거 (위치를 기억해 두고 swap-remove → O(1))
+ * - 한 이벤트가 여러 규칙을 끝내도 결과가 같도록, 먼저 대상을 모은 뒤 적용
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o achievements 19_achievement_quest_engine.cpp
+ * 실행: ./achievements [플레이어 수] [플레이어당 규칙 수] [이벤트 수]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+using namespace std;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] 이벤트
+enum class EventType : uint8_t { ExperienceGained, LevelReached, MonsterDefeated, BattleFled, ItemUsed, Rested };
+
+using KeyId = uint32_t;
+constexpr KeyId kAnyKey = 0;
+
+// 이름 → 정수 키 (몬스터 이름, 아이템 이름)
+class KeyTable {
+private:
+    unordered_map<string, KeyId> ids;
+    vector<string> names{"*"};
+
+public:
+    KeyId intern(const string& name) {
+        auto [it, inserted] = ids.emplace(name, KeyId(names.size()));
+        if (inserted) names.push_back(name);
+        return it->second;
+    }
+    const string& name(KeyId id) const { return names[id]; }
+};
+
+struct GameEvent {
+    EventType type;
+    uint32_t player;
+    KeyId key;
+    int64_t value;
+};
+
+// [2] 규칙 정의 (업적 = 한 단계, 퀘스트 = 단계 사슬)
+enum class Progress : uint8_t { Count, Sum, Reach };     // +1, +값, max(진행도, 값)
+enum class OnReset : uint8_t { None, Restart, Fail };
+
+struct RuleDef {
+    string name;
+    EventType trigger;
+    KeyId triggerKey;
+    Progress mode;
+    int64_t target;
+    EventType resetTrigger = EventType::Rested;
+    KeyId resetKey = kAnyKey;
+    OnReset onReset = OnReset::None;
+    int32_t nextStage = -1;         // 퀘스트의 다음 단계 RuleDef 번호
+};
+
+struct Completion {
+    uint64_t eventIndex;
+    uint32_t player;
+    uint32_t def;
+    bool failed;
+
+    bool operator==(const Completion& o) const {
+        return eventIndex == o.eventIndex && player == o.player && def == o.def && failed == o.failed;
+    }
+};
+
+// [3] 규칙 엔진
+class RuleEngine {
+private:
+    struct Subscription {
+        uint32_t instance;
+        uint8_t slot;       // 0 = 진행 트리거, 1 = 초기화 트리거
+    };
+    struct Instance {
+        uint32_t def;
+        uint32_t player;
+        int64_t progress;
+        uint32_t position[2];   // 각 색인 목록 안의 자리 (swap-remove 때 갱신)
+        bool active;
+    };
+
+    const vector<RuleDef>& defs;
+    vector<Instance> instances;
+    vector<uint32_t> freeInstances;
+    unordered_map<uint64_t, vector<Subscription>> index;
+    vector<Subscription> matched;       // 이벤트마다 재사용
+    size_t activeCount = 0;
+
+    static uint64_t indexKey(uint32_t player, EventType type, KeyId key) {
+        return (uint64_t(player) << 32) | (uint64_t(type) << 24) | key;
+    }
+
+    uint64_t slotKey(const Instance& inst, uint8_t slot) const {
+        const RuleDef& d = defs[inst.def];
+        return slot == 0 ? indexKey(inst.player, d.trigger, d.triggerKey)
+                         : indexKey(inst.player, d.resetTrigger, d.resetKey);
+    }
+
+    void subscribe(uint32_t id, uint8_t slot) {
+        auto& list = index[slotKey(instances[id], slot)];
+        instances[id].position[slot] = uint32_t(list.size());
+        list.push_back(Subscription{id, slot});
+    }
+
+    void unsubscribe(uint32_t id, uint8_t slot) {
+        auto it = index.find(slotKey(instances[id], slot));
+        auto& list = it->second;
+        uint32_t pos = instances[id].position[slot];
+        list[pos] = list.back();
+        instances[list[pos].instance].position[list[pos].slot] = pos;
+        list.pop_back();
+        if (list.empty()) index.erase(it);
+    }
+
+    void retire(uint32_t id) {
+        Instance& inst = instances[id];
+        unsubscribe(id, 0);
+        if (defs[inst.def].onReset != OnReset::None) unsubscribe(id, 1);
+        inst.active = false;
+        freeInstances.push_back(id);
+        --activeCount;
+    }
+
+    // 대상 하나에 이벤트 적용. 끝나면 색인에서 빼고 (퀘스트면) 다음 단계를 등록
+    void apply(const Subscription& sub, const GameEvent& e, uint64_t eventIndex, vector<Completion>& out) {
+        Instance& inst = instances[sub.instance];
+        if (!inst.active) return;
+        const RuleDef& d = defs[inst.def];
+        if (sub.slot == 1) {
+            if (d.onReset == OnReset::Restart) {
+                inst.progress = 0;
+                return;
+            }
+            out.push_back(Completion{eventIndex, inst.player, inst.def, true});
+            retire(sub.instance);
+            return;
+        }
+        switch (d.mode) {
+            case Progress::Count: inst.progress += 1; break;
+            case Progress::Sum: inst.progress += e.value; break;
+            case Progress::Reach: inst.progress = max(inst.progress, e.value); break;
+        }
+        if (inst.progress < d.target) return;
+        uint32_t player = inst.player;
+        int32_t next = d.nextStage;
+        out.push_back(Completion{eventIndex, player, inst.def, false});
+        retire(sub.instance);
+        if (next >= 0) activate(player, uint32_t(next));
+    }
+
+    void applyMatched(const GameEvent& e, uint64_t eventIndex, vector<Completion>& out) {
+        // 같은 이벤트 안에서는 규칙 번호 순으로 적용 → 색인/전수 검사 결과가 같음
+        if (matched.size() > 1) {
+            sort(matched.begin(), matched.end(), [](const Subscription& a, const Subscription& b) {
+                return a.instance != b.instance ? a.instance < b.instance : a.slot > b.slot;
+            });
+        }
+        for (const Subscription& sub : matched) apply(sub, e, eventIndex, out);
+        matched.clear();
+    }
+
+public:
+    explicit RuleEngine(const vector<RuleDef>& d) : defs(d) {}
+
+    uint32_t activate(uint32_t player, uint32_t def) {
+        if (def >= defs.size()) throw out_of_range("알 수 없는 규칙");
+        uint32_t id;
+        if (!freeInstances.empty()) {
+            id = freeInstances.back();
+            freeInstances.pop_back();
+        } else {
+            id = uint32_t(instances.size());
+            instances.emplace_back();
+        }
+        instances[id] = Instance{def, player, 0, {0, 0}, true};
+        subscribe(id, 0);
+        if (defs[def].onReset != OnReset::None) subscribe(id, 1);
+        ++activeCount;
+        return id;
+    }
+
+    // 색인 조회: 정확한 키 + 아무 키
+    void dispatch(const GameEvent& e, uint64_t eventIndex, vector<Completion>& out) {
+        for (KeyId key : {e.key, kAnyKey}) {
+            auto it = index.find(indexKey(e.player, e.type, key));
+            if (it != index.end()) matched.insert(matched.end(), it->second.begin(), it->second.end());
+            if (e.key == kAnyKey) break;
+        }
+        if (!matched.empty()) applyMatched(e, eventIndex, out);
+    }
+
+    // 비교 대상: 이벤트마다 모든 활성 규칙을 검사
+    void dispatchByScan(const GameEvent& e, uint64_t eventIndex, vector<Completion>& out) {
+        for (uint32_t id = 0; id < instances.size(); ++id) {
+            const Instance& inst = instances[id];
+            if (!inst.active || inst.player != e.player) continue;
+            const RuleDef& d = defs[inst.def];
+            if (d.trigger == e.type && (d.triggerKey == kAnyKey || d.triggerKey == e.key))
+                matched.push_back(Subscription{id, 0});
+            if (d.onReset != OnReset::None && d.resetTrigger == e.type
+                && (d.resetKey == kAnyKey || d.resetKey == e.key))
+                matched.push_back(Subscription{id, 1});
+        }
+        if (!matched.empty()) applyMatched(e, eventIndex, out);
+    }
+
+    size_t active() const { return activeCount; }
+    size_t buckets() const { return index.size(); }
+    int64_t progressOf(uint32_t id) const { return instances[id].progress; }
+};
+
+// [4] 이벤트를 내보내는 게임 코드 (game.cpp 의 Player / BattleSystem / rest, 입력 없이 자동 진행)
+class EventSink {
+public:
+    virtual ~EventSink() = default;
+    virtual void emit(const GameEvent& e) = 0;
+};
+
+class Item {
+private:
+    string name;
+    int healAmount;
+    int attackBonus;
+
+public:
+    Item(const string& n, int heal = 0, int attack = 0) : name(n), healAmount(heal), attackBonus(attack) {}
+    const string& getName() const { return name; }
+    int getHealAmount() const { return healAmount; }
+    int getAttackBonus() const { return attackBonus; }
+};
+
+class Monster {
+public:
+    string name;
+    int health, attack, defense, expReward, goldReward;
+};
+
+class Player {
+private:
+    uint32_t id;
+    EventSink& events;
+    KeyTable& keys;
+    int health = 100, maxHealth = 100, attack = 20, defense = 5;
+    int experience = 0, level = 1, gold = 50;
+    vector<unique_ptr<Item>> inventory;
+
+    void levelUp() {
+        level++;
+        maxHealth += 20;
+        health = maxHealth;
+        attack += 5;
+        defense += 2;
+        events.emit(GameEvent{EventType::LevelReached, id, kAnyKey, level});
+    }
+
+public:
+    Player(uint32_t playerId, EventSink& sink, KeyTable& table) : id(playerId), events(sink), keys(table) {
+        inventory.push_back(make_unique<Item>("체력 포션", 30, 0));
+        inventory.push_back(make_unique<Item>("힘의 물약", 0, 10));
+    }
+
+    uint32_t getId() const { return id; }
+    int getLevel() const { return level; }
+    int getHealth() const { return health; }
+    int getMaxHealth() const { return maxHealth; }
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+    int getInventorySize() const { return int(inventory.size()); }
+    const Item& itemAt(int index) const { return *inventory[index - 1]; }
+    void takeDamage(int damage) { health = max(0, health - max(1, damage - defense)); }
+    void addItem(unique_ptr<Item> item) { inventory.push_back(move(item)); }
+
+    void gainExperience(int exp) {
+        experience += exp;
+        events.emit(GameEvent{EventType::ExperienceGained, id, kAnyKey, exp});
+        if (experience >= level * 100) levelUp();
+    }
+    void gainGold(int amount) { gold += amount; }
+
+    void useItem(int index) {
+        if (index < 1 || index > int(inventory.size())) throw invalid_argument("잘못된 아이템 번호");
+        auto& item = inventory[index - 1];
+        health = min(maxHealth, health + item->getHealAmount());
+        attack += item->getAttackBonus();
+        events.emit(GameEvent{EventType::ItemUsed, id, keys.intern(item->getName()), 1});
+        inventory.erase(inventory.begin() + index - 1);
+    }
+
+    void rest() {
+        health = maxHealth;
+        events.emit(GameEvent{EventType::Rested, id, kAnyKey, 1});
+    }
+};
+
+class BattleSystem {
+public:
+    // 자동 전투: 체력이 30% 아래면 회복 아이템, 없고 15% 아래면 도망
+    static bool battle(Player& player, Monster& monster, mt19937& rng, EventSink& events, KeyTable& keys) {
+        while (monster.health > 0) {
+            if (player.getHealth() * 10 < player.getMaxHealth() * 3) {
+                int potion = 0;
+                for (int i = 1; i <= player.getInventorySize(); ++i) {
+                    if (player.itemAt(i).getHealAmount() > 0) { potion = i; break; }
+                }
+                if (potion) {
+                    player.useItem(potion);
+                } else if (player.getHealth() * 100 < player.getMaxHealth() * 15) {
+                    events.emit(GameEvent{EventType::BattleFled, player.getId(), keys.intern(monster.name), 1});
+                    return false;
+                }
+            }
+            int damage = player.getAttack() - 5 + int(rng() % 11);
+            monster.health -= max(1, damage - monster.defense);
+            if (monster.health <= 0) break;
+            player.takeDamage(monster.attack - 3 + int(rng() % 7));
+            if (player.getHealth() == 0) {
+                player.rest();      // 데모 단순화: 쓰러지면 마을로 돌아가 회복
+                return false;
+            }
+        }
+        events.emit(GameEvent{EventType::MonsterDefeated, player.getId(), keys.intern(monster.name), 1});
+        player.gainExperience(monster.expReward);
+        player.gainGold(monster.goldReward);
+        return true;
+    }
+};
+
+Monster createRandomMonster(int playerLevel, mt19937& rng) {
+    int lv = max(1, playerLevel);
+    switch (rng() % 4) {
+        case 0: return Monster{"슬라임", 30 + lv * 10, 8 + lv * 2, 1 + lv, 20 + lv * 5, 10 + lv * 3};
+        case 1: return Monster{"고블린", 50 + lv * 15, 12 + lv * 3, 3 + lv, 35 + lv * 8, 20 + lv * 5};
+        case 2: return Monster{"오크", 80 + lv * 20, 18 + lv * 4, 5 + lv * 2, 50 + lv * 10, 35 + lv * 7};
+        default: return Monster{"드래곤", 150 + lv * 30, 25 + lv * 5, 8 + lv * 3, 100 + lv * 15, 75 + lv * 10};
+    }
+}
+
+// 엔진으로 이벤트를 보내고 완료 메시지를 출력하는 연결부
+class AchievementFeed : public EventSink {
+private:
+    RuleEngine& engine;
+    const vector<RuleDef>& defs;
+    vector<Completion> done;
+    uint64_t eventCount = 0;
+
+public:
+    AchievementFeed(RuleEngine& e, const vector<RuleDef>& d) : engine(e), defs(d) {}
+
+    void emit(const GameEvent& e) override {
+        engine.dispatch(e, eventCount++, done);
+        for (const Completion& c : done) {
+            cout << "  [" << (c.failed ? "실패" : "달성") << "] " << defs[c.def].name << endl;
+        }
+        done.clear();
+    }
+    uint64_t events() const { return eventCount; }
+};
+
+// [5] 벤치마크용 규칙/이벤트 생성
+struct Workload {
+    vector<RuleDef> defs;
+    vector<GameEvent> events;
+};
+
+Workload makeWorkload(uint32_t players, size_t eventCount, uint64_t seed) {
+    const uint32_t monsterKinds = 500, itemKinds = 200;
+    Workload w;
+    // 규칙 정의 풀 (플레이어마다 그중 rulesPerPlayer 개를 활성화)
+    for (uint32_t i = 0; i < 4096; ++i) {
+        uint64_t h = mix64(seed ^ i);
+        RuleDef d;
+        d.name = "규칙" + to_string(i);
+        switch (h % 6) {
+            case 0: case 1:
+                d = RuleDef{d.name, EventType::MonsterDefeated, KeyId(1 + (h >> 8) % monsterKinds), Progress::Count,
+                            int64_t(1 + (h >> 20) % 20)};
+                break;
+            case 2:
+                d = RuleDef{d.name, EventType::ItemUsed, KeyId(1 + monsterKinds + (h >> 8) % itemKinds), Progress::Count,
+                            int64_t(1 + (h >> 20) % 10)};
+                break;
+            case 3:
+                d = RuleDef{d.name, EventType::ExperienceGained, kAnyKey, Progress::Sum, int64_t(500 + (h >> 20) % 5000)};
+                break;
+            case 4:
+                d = RuleDef{d.name, EventType::LevelReached, kAnyKey, Progress::Reach, int64_t(2 + (h >> 20) % 30)};
+                d.onReset = (h >> 40) % 2 ? OnReset::Fail : OnReset::None;
+                break;
+            default:
+                d = RuleDef{d.name, EventType::MonsterDefeated, kAnyKey, Progress::Count, int64_t(10 + (h >> 20) % 100)};
+                d.onReset = OnReset::Restart;
+                break;
+        }
+        if ((h >> 50) % 4 == 0 && i + 1 < 4096) d.nextStage = int32_t(i + 1);     // 일부는 퀘스트 사슬
+        w.defs.push_back(d);
+    }
+    mt19937_64 rng(seed);
+    vector<int64_t> level(players, 1);
+    w.events.reserve(eventCount);
+    for (size_t i = 0; i < eventCount; ++i) {
+        uint32_t p = uint32_t(rng() % players);
+        uint64_t r = rng();
+        switch (r % 10) {
+            case 0: case 1: case 2: case 3:
+                w.events.push_back({EventType::MonsterDefeated, p, KeyId(1 + (r >> 8) % monsterKinds), 1}); break;
+            case 4: case 5:
+                w.events.push_back({EventType::ExperienceGained, p, kAnyKey, int64_t(20 + (r >> 8) % 100)}); break;
+            case 6:
+                w.events.push_back({EventType::ItemUsed, p, KeyId(1 + monsterKinds + (r >> 8) % itemKinds), 1}); break;
+            case 7:
+                w.events.push_back({EventType::LevelReached, p, kAnyKey, ++level[p]}); break;
+            case 8:
+                w.events.push_back({EventType::Rested, p, kAnyKey, 1}); break;
+            default:
+                w.events.push_back({EventType::BattleFled, p, KeyId(1 + (r >> 8) % monsterKinds), 1}); break;
+        }
+    }
+    return w;
+}
+
+void activateAll(RuleEngine& engine, uint32_t players, uint32_t rulesPerPlayer, size_t defCount, uint64_t seed) {
+    for (uint32_t p = 0; p < players; ++p) {
+        for (uint32_t r = 0; r < rulesPerPlayer; ++r) engine.activate(p, uint32_t(mix64(seed ^ (uint64_t(p) << 20) ^ r) % defCount));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        uint32_t players = argc > 1 ? uint32_t(stoul(argv[1])) : 1000;
+        uint32_t rulesPerPlayer = argc > 2 ? uint32_t(stoul(argv[2])) : 100;
+        size_t eventCount = argc > 3 ? stoul(argv[3]) : 2000000;
+        if (players == 0 || rulesPerPlayer == 0 || eventCount == 0) throw invalid_argument("잘못된 인자");
+
+        // 데모: game.cpp 흐름에서 나오는 이벤트로 업적/퀘스트 진행
+        cout << "=== 업적/퀘스트 데모 ===" << endl;
+        KeyTable keys;
+        KeyId goblin = keys.intern("고블린"), slime = keys.intern("슬라임"), dragon = keys.intern("드래곤");
+        KeyId potion = keys.intern("체력 포션");
+        vector<RuleDef> demoDefs = {
+            {"고블린 10마리 처치", EventType::MonsterDefeated, goblin, Progress::Count, 10},
+            {"휴식 없이 레벨 4 달성", EventType::LevelReached, kAnyKey, Progress::Reach, 4,
+             EventType::Rested, kAnyKey, OnReset::Fail},
+            {"쉬지 않고 연속 5승", EventType::MonsterDefeated, kAnyKey, Progress::Count, 5,
+             EventType::Rested, kAnyKey, OnReset::Restart},
+            {"경험치 1000 모으기", EventType::ExperienceGained, kAnyKey, Progress::Sum, 1000},
+            {"퀘스트 1/3: 슬라임 3마리", EventType::MonsterDefeated, slime, Progress::Count, 3, EventType::Rested,
+             kAnyKey, OnReset::None, 4},
+            {"퀘스트 2/3: 체력 포션 사용", EventType::ItemUsed, potion, Progress::Count, 1, EventType::Rested,
+             kAnyKey, OnReset::None, 5},
+            {"퀘스트 3/3: 드래곤 처치", EventType::MonsterDefeated, dragon, Progress::Count, 1},
+        };
+        RuleEngine demoEngine(demoDefs);
+        for (uint32_t d : {0u, 1u, 2u, 3u, 4u}) demoEngine.activate(0, d);
+        AchievementFeed feed(demoEngine, demoDefs);
+        Player hero(0, feed, keys);
+        mt19937 rng(7);
+        int wins = 0;
+        for (int round = 0; round < 40; ++round) {
+            Monster m = createRandomMonster(hero.getLevel(), rng);
+            wins += BattleSystem::battle(hero, m, rng, feed, keys);
+            if (round % 4 == 3) {
+                hero.addItem(make_unique<Item>("체력 포션", 30, 0));
+                if (hero.getHealth() * 2 < hero.getMaxHealth()) hero.rest();
+            }
+        }
+        cout << "40전 " << wins << "승, 레벨 " << hero.getLevel() << ", 이벤트 " << feed.events()
+             << "개, 남은 활성 규칙 " << demoEngine.active() << "개" << endl;
+
+        // 벤치마크: 플레이어 x 규칙 = 활성 규칙 수
+        cout << "\n=== 활성 규칙 " << size_t(players) * rulesPerPlayer << "개 (플레이어 " << players << " x "
+             << rulesPerPlayer << "), 이벤트 " << eventCount << "개 ===" << endl;
+        Workload w = makeWorkload(players, eventCount, 99);
+        RuleEngine indexed(w.defs), scanned(w.defs);
+        activateAll(indexed, players, rulesPerPlayer, w.defs.size(), 5);
+        activateAll(scanned, players, rulesPerPlayer, w.defs.size(), 5);
+
+        vector<Completion> indexedDone, scannedDone;
+        auto t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < w.events.size(); ++i) indexed.dispatch(w.events[i], i, indexedDone);
+        double indexedNs = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / w.events.size();
+
+        size_t scanEvents = min<size_t>(w.events.size(), 5000);
+        t0 = chrono::steady_clock::now();
+        for (size_t i = 0; i < scanEvents; ++i) scanned.dispatchByScan(w.events[i], i, scannedDone);
+        double scanNs = chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / scanEvents;
+
+        size_t indexedPrefix = size_t(upper_bound(indexedDone.begin(), indexedDone.end(), scanEvents - 1,
+                                                  [](uint64_t v, const Completion& c) { return v < c.eventIndex; })
+                                      - indexedDone.begin());
+        bool same = indexedPrefix == scannedDone.size()
+                    && equal(scannedDone.begin(), scannedDone.end(), indexedDone.begin());
+
+        size_t failed = count_if(indexedDone.begin(), indexedDone.end(), [](const Completion& c) { return c.failed; });
+        cout << "색인    : 이벤트당 " << indexedNs << " ns, 달성 " << indexedDone.size() - failed << "건, 실패 "
+             << failed << "건, 남은 활성 규칙 " << indexed.active() << "개, 색인 버킷 " << indexed.buckets() << "개"
+             << endl;
+        cout << "전수 검사: 이벤트당 " << scanNs << " ns (앞 " << scanEvents << "개 이벤트만), 색인이 "
+             << scanNs / indexedNs << "배 빠름" << endl;
+        cout << "앞 " << scanEvents << "개 이벤트의 달성/실패 기록 일치: " << (same ? "예" : "아니오!") << endl;
+        return same ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,696 @@
+/*
+ * 파일명: 21_item_order_book.cpp
+ *
+ * 주제: 가격-시간 우선 지정가 주문장으로 만드는 아이템 거래소 (Price-time Priority Order Book)
+ * 정의: 아이템 종류마다 매수/매도 지정가 주문장을 두고, 더 좋은 가격 → 먼저 들어온 주문 순으로
+ *       체결하며, 취소/정정과 체결 보고를 지원하는 플레이어 거래소
+ *
+ * chapter08/game.cpp 의 한계:
+ * - 골드는 Player::gainGold 로 쌓이기만 하고 쓸 곳이 휴식뿐. 플레이어끼리 아이템을 사고팔 수 없음
+ *
+ * 핵심 개념:
+ * - 주문 노드는 고정 크기 풀에서 꺼내 쓰고 빈 목록으로 돌려줌 → 주문 처리 중 힙 할당 없음
+ * - 가격 단계(level)는 가격을 첨자로 하는 배열, 같은 가격의 주문은 노드 안의 prev/next 로 잇는
+ *   침입형(intrusive) 이중 연결 리스트 → 시간 우선 = 리스트 순서, 취소 = O(1) 연결 해제
+ * - 비어 있지 않은 가격은 비트셋으로 관리 → 최우선 가격이 비면 다음 가격을 워드 단위로 찾음
+ * - 주문 번호 → 노드: 미리 잡아 둔 선형 탐사 해시표 (역방향 이동 삭제, 할당 없음)
+ * - 정정: 같은 가격에서 수량만 줄이면 순번 유지, 그 밖에는 취소 후 새 주문 (순번 잃음)
+ * - 거래소 계층: 매수 주문은 골드, 매도 주문은 아이템을 예치(escrow) → 체결 시 정산, 취소 시 반환
+ * - 벤치마크: 수백만 건의 주문/취소/정정 기록을 만들어 두고 재생, 명령별 지연 분포 측정
+ *   비교 대상 std::map<가격, std::list<주문>> + unordered_map 과 체결 결과가 같은지 확인
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o orderbook 21_item_order_book.cpp
+ * 실행: ./orderbook [명령 수] [아이템 종류 수]
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <map>
+#include <list>
+#include <unordered_map>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+using namespace std;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] 공통 타입
+enum class Side : uint8_t { Buy, Sell };
+using OrderId = uint64_t;
+constexpr int kMaxPrice = 1 << 14;      // 가격 단위 = 1골드, 1 ~ kMaxPrice-1
+
+struct Trade {
+    OrderId buyOrder, sellOrder;
+    uint32_t buyer, seller;
+    uint32_t item;
+    int price;
+    uint32_t quantity;
+};
+
+// 체결 기록 요약 (두 구현의 결과 비교용)
+struct TradeDigest {
+    uint64_t hash = 0, count = 0, volume = 0;
+    void add(const Trade& t) {
+        hash = mix64(hash ^ t.buyOrder) ^ mix64(t.sellOrder + (uint64_t(t.price) << 32) + t.quantity);
+        ++count;
+        volume += t.quantity;
+    }
+};
+
+// [2] 주문 노드 풀: 인덱스 기반, 빈 목록으로 재사용
+constexpr uint32_t kNil = UINT32_MAX;
+
+struct OrderNode {
+    OrderId id;
+    uint32_t owner;
+    uint32_t quantity;
+    int price;
+    Side side;
+    uint16_t item;              // 주문 번호 색인은 모든 주문장이 공유 → 다른 주문장의 노드를 건드리지 않도록
+    uint32_t prev, next;        // 같은 가격 단계 안의 침입형 연결
+};
+static_assert(sizeof(OrderNode) == 32, "노드는 32바이트");
+
+class OrderPool {
+private:
+    vector<OrderNode> nodes;
+    uint32_t freeHead = kNil;
+    size_t live = 0, peak = 0;
+
+public:
+    explicit OrderPool(size_t capacity) : nodes(capacity) {
+        for (size_t i = 0; i < capacity; ++i) nodes[i].next = i + 1 < capacity ? uint32_t(i + 1) : kNil;
+        freeHead = capacity ? 0 : kNil;
+    }
+
+    uint32_t acquire() {
+        if (freeHead == kNil) throw runtime_error("주문 풀이 가득 찼습니다");
+        uint32_t idx = freeHead;
+        freeHead = nodes[idx].next;
+        peak = max(peak, ++live);
+        return idx;
+    }
+    void release(uint32_t idx) {
+        nodes[idx].next = freeHead;
+        freeHead = idx;
+        --live;
+    }
+    OrderNode& operator[](uint32_t idx) { return nodes[idx]; }
+    size_t peakLive() const { return peak; }
+};
+
+// 주문 번호 → 노드 인덱스: 고정 용량 선형 탐사 해시표
+class OrderIndex {
+private:
+    struct Slot {
+        OrderId id;
+        uint32_t node;      // kNil = 빈 칸
+    };
+    vector<Slot> slots;
+    size_t mask;
+
+    size_t home(OrderId id) const { return mix64(id) & mask; }
+
+public:
+    explicit OrderIndex(size_t capacity) {
+        size_t size = 16;
+        while (size < capacity * 2) size <<= 1;     // 적재율 50% 이하
+        slots.assign(size, Slot{0, kNil});
+        mask = size - 1;
+    }
+
+    bool insert(OrderId id, uint32_t node) {
+        for (size_t i = home(id);; i = (i + 1) & mask) {
+            if (slots[i].node == kNil) {
+                slots[i] = Slot{id, node};
+                return true;
+            }
+            if (slots[i].id == id) return false;        // 중복 번호
+        }
+    }
+
+    uint32_t find(OrderId id) const {
+        for (size_t i = home(id);; i = (i + 1) & mask) {
+            if (slots[i].node == kNil) return kNil;
+            if (slots[i].id == id) return slots[i].node;
+        }
+    }
+
+    // 역방향 이동 삭제: 뒤따르는 묶음을 당겨 와 탐사 사슬이 끊기지 않게 함
+    void erase(OrderId id) {
+        size_t i = home(id);
+        while (slots[i].id != id || slots[i].node == kNil) {
+            if (slots[i].node == kNil) return;
+            i = (i + 1) & mask;
+        }
+        size_t hole = i;
+        for (size_t j = (hole + 1) & mask; slots[j].node != kNil; j = (j + 1) & mask) {
+            size_t h = home(slots[j].id);
+            // h 가 (hole, j] 구간 밖이면 j 를 hole 로 옮겨도 탐사 순서가 유지됨
+            bool between = hole <= j ? (hole < h && h <= j) : (hole < h || h <= j);
+            if (!between) {
+                slots[hole] = slots[j];
+                hole = j;
+            }
+        }
+        slots[hole].node = kNil;
+    }
+};
+
+// [3] 아이템 하나의 주문장
+class OrderBook {
+private:
+    struct Level {
+        uint32_t head = kNil, tail = kNil;
+    };
+    struct SideBook {
+        vector<Level> levels = vector<Level>(kMaxPrice);
+        vector<uint64_t> nonEmpty = vector<uint64_t>(kMaxPrice / 64, 0);
+    };
+
+    uint32_t item;
+    OrderPool& pool;
+    OrderIndex& index;
+    SideBook bids, asks;
+    int bestBid = 0, bestAsk = kMaxPrice;     // 없으면 각각 0, kMaxPrice
+
+    // price 이하(매수) / 이상(매도)에서 가장 가까운 비어 있지 않은 가격
+    static int highestAtOrBelow(const SideBook& s, int price) {
+        if (price <= 0) return 0;
+        int w = price / 64;
+        uint64_t bits = s.nonEmpty[w] & (~0ULL >> (63 - price % 64));
+        while (true) {
+            if (bits) return w * 64 + 63 - __builtin_clzll(bits);
+            if (--w < 0) return 0;
+            bits = s.nonEmpty[w];
+        }
+    }
+    static int lowestAtOrAbove(const SideBook& s, int price) {
+        if (price >= kMaxPrice) return kMaxPrice;
+        int w = price / 64;
+        uint64_t bits = s.nonEmpty[w] & (~0ULL << (price % 64));
+        while (true) {
+            if (bits) return w * 64 + __builtin_ctzll(bits);
+            if (++w >= kMaxPrice / 64) return kMaxPrice;
+            bits = s.nonEmpty[w];
+        }
+    }
+
+    void link(uint32_t idx) {
+        OrderNode& n = pool[idx];
+        SideBook& s = n.side == Side::Buy ? bids : asks;
+        Level& level = s.levels[n.price];
+        n.prev = level.tail;
+        n.next = kNil;
+        if (level.tail != kNil) pool[level.tail].next = idx;
+        else level.head = idx;
+        level.tail = idx;
+        s.nonEmpty[n.price / 64] |= 1ULL << (n.price % 64);
+        if (n.side == Side::Buy) bestBid = max(bestBid, n.price);
+        else bestAsk = min(bestAsk, n.price);
+    }
+
+    void unlink(uint32_t idx) {
+        OrderNode& n = pool[idx];
+        SideBook& s = n.side == Side::Buy ? bids : asks;
+        Level& level = s.levels[n.price];
+        if (n.prev != kNil) pool[n.prev].next = n.next;
+        else level.head = n.next;
+        if (n.next != kNil) pool[n.next].prev = n.prev;
+        else level.tail = n.prev;
+        if (level.head == kNil) {
+            s.nonEmpty[n.price / 64] &= ~(1ULL << (n.price % 64));
+            if (n.side == Side::Buy && n.price == bestBid) bestBid = highestAtOrBelow(bids, n.price - 1);
+            if (n.side == Side::Sell && n.price == bestAsk) bestAsk = lowestAtOrAbove(asks, n.price + 1);
+        }
+    }
+
+    void retire(uint32_t idx) {
+        unlink(idx);
+        index.erase(pool[idx].id);
+        pool.release(idx);
+    }
+
+public:
+    OrderBook(uint32_t itemId, OrderPool& p, OrderIndex& i) : item(itemId), pool(p), index(i) {
+        if (itemId > UINT16_MAX) throw invalid_argument("아이템 번호는 65535 이하");
+    }
+
+    static void checkOrder(int price, uint32_t quantity) {
+        if (price <= 0 || price >= kMaxPrice || quantity == 0) throw invalid_argument("잘못된 주문");
+    }
+
+    // 지정가 주문: 반대편과 교차하는 동안 체결, 남은 수량은 주문장에 올림. 남은 수량 반환.
+    // 검증(가격, 수량, 번호 중복)은 체결 전에 끝냄 → 예외가 나면 주문장과 trades 는 그대로
+    uint32_t submit(OrderId id, uint32_t owner, Side side, int price, uint32_t quantity, vector<Trade>& trades) {
+        checkOrder(price, quantity);
+        if (index.find(id) != kNil) throw invalid_argument("이미 있는 주문 번호: " + to_string(id));
+        if (side == Side::Buy) {
+            while (quantity > 0 && bestAsk <= price) {
+                uint32_t restIdx = asks.levels[bestAsk].head;
+                OrderNode& rest = pool[restIdx];
+                uint32_t fill = min(quantity, rest.quantity);
+                trades.push_back(Trade{id, rest.id, owner, rest.owner, item, rest.price, fill});
+                quantity -= fill;
+                if ((rest.quantity -= fill) == 0) retire(restIdx);
+            }
+        } else {
+            while (quantity > 0 && bestBid >= price) {
+                uint32_t restIdx = bids.levels[bestBid].head;
+                OrderNode& rest = pool[restIdx];
+                uint32_t fill = min(quantity, rest.quantity);
+                trades.push_back(Trade{rest.id, id, rest.owner, owner, item, rest.price, fill});
+                quantity -= fill;
+                if ((rest.quantity -= fill) == 0) retire(restIdx);
+            }
+        }
+        if (quantity > 0) {
+            uint32_t idx = pool.acquire();
+            index.insert(id, idx);      // 중복은 위에서 걸렀음
+            OrderNode& n = pool[idx];
+            n.id = id;
+            n.owner = owner;
+            n.quantity = quantity;
+            n.price = price;
+            n.side = side;
+            n.item = uint16_t(item);
+            link(idx);
+        }
+        return quantity;
+    }
+
+    // 이 주문장에 있는 주문이면 노드 위치, 없거나 다른 아이템의 주문이면 kNil
+    uint32_t findOwn(OrderId id) const {
+        uint32_t idx = index.find(id);
+        return idx != kNil && pool[idx].item == item ? idx : kNil;
+    }
+
+    // 취소된 주문의 남은 수량 반환 (없으면 0). cancelled 에는 풀에 돌려주기 전의 노드 사본
+    uint32_t cancel(OrderId id, OrderNode* cancelled = nullptr) {
+        uint32_t idx = findOwn(id);
+        if (idx == kNil) return 0;
+        if (cancelled) *cancelled = pool[idx];
+        uint32_t remaining = pool[idx].quantity;
+        retire(idx);
+        return remaining;
+    }
+
+    // 정정: 같은 가격에서 수량 감소면 순번 유지, 아니면 취소 후 재주문.
+    // 잘못된 가격이면 원래 주문을 건드리지 않고 예외
+    bool modify(OrderId id, int newPrice, uint32_t newQuantity, vector<Trade>& trades) {
+        uint32_t idx = findOwn(id);
+        if (idx == kNil) return false;
+        OrderNode& n = pool[idx];
+        if (newQuantity == 0) {
+            retire(idx);
+            return true;
+        }
+        checkOrder(newPrice, newQuantity);
+        if (newPrice == n.price && newQuantity <= n.quantity) {
+            n.quantity = newQuantity;
+            return true;
+        }
+        uint32_t owner = n.owner;
+        Side side = n.side;
+        retire(idx);
+        submit(id, owner, side, newPrice, newQuantity, trades);
+        return true;
+    }
+
+    int bestBidPrice() const { return bestBid; }
+    int bestAskPrice() const { return bestAsk; }
+};
+
+// [4] 비교 대상: std::map + std::list + unordered_map (주문마다 할당)
+class MapOrderBook {
+private:
+    struct Order {
+        OrderId id;
+        uint32_t owner, quantity;
+        int price;
+        Side side;
+    };
+    uint32_t item;
+    map<int, list<Order>, greater<int>> bids;
+    map<int, list<Order>> asks;
+    unordered_map<OrderId, list<Order>::iterator> orders;
+
+    template <typename Book>
+    void erase(Book& book, list<Order>::iterator it) {
+        auto level = book.find(it->price);
+        level->second.erase(it);
+        if (level->second.empty()) book.erase(level);
+    }
+
+public:
+    explicit MapOrderBook(uint32_t itemId) : item(itemId) {}
+
+    uint32_t submit(OrderId id, uint32_t owner, Side side, int price, uint32_t quantity, vector<Trade>& trades) {
+        if (side == Side::Buy) {
+            while (quantity > 0 && !asks.empty() && asks.begin()->first <= price) {
+                Order& rest = asks.begin()->second.front();
+                uint32_t fill = min(quantity, rest.quantity);
+                trades.push_back(Trade{id, rest.id, owner, rest.owner, item, rest.price, fill});
+                quantity -= fill;
+                if ((rest.quantity -= fill) == 0) {
+                    orders.erase(rest.id);
+                    erase(asks, asks.begin()->second.begin());
+                }
+            }
+        } else {
+            while (quantity > 0 && !bids.empty() && bids.begin()->first >= price) {
+                Order& rest = bids.begin()->second.front();
+                uint32_t fill = min(quantity, rest.quantity);
+                trades.push_back(Trade{rest.id, id, rest.owner, owner, item, rest.price, fill});
+                quantity -= fill;
+                if ((rest.quantity -= fill) == 0) {
+                    orders.erase(rest.id);
+                    erase(bids, bids.begin()->second.begin());
+                }
+            }
+        }
+        if (quantity > 0) {
+            auto& level = side == Side::Buy ? bids[price] : asks[price];
+            level.push_back(Order{id, owner, quantity, price, side});
+            orders[id] = prev(level.end());
+        }
+        return quantity;
+    }
+
+    uint32_t cancel(OrderId id) {
+        auto it = orders.find(id);
+        if (it == orders.end()) return 0;
+        uint32_t remaining = it->second->quantity;
+        if (it->second->side == Side::Buy) erase(bids, it->second);
+        else erase(asks, it->second);
+        orders.erase(it);
+        return remaining;
+    }
+
+    bool modify(OrderId id, int newPrice, uint32_t newQuantity, vector<Trade>& trades) {
+        auto it = orders.find(id);
+        if (it == orders.end()) return false;
+        Order o = *it->second;
+        if (newQuantity == 0) {
+            cancel(id);
+            return true;
+        }
+        if (newPrice == o.price && newQuantity <= o.quantity) {
+            it->second->quantity = newQuantity;
+            return true;
+        }
+        cancel(id);
+        submit(id, o.owner, o.side, newPrice, newQuantity, trades);
+        return true;
+    }
+};
+
+// [5] 거래소: game.cpp 플레이어의 골드/아이템을 예치하고 체결 시 정산
+class Trader {
+private:
+    string name;
+    int gold;
+    vector<int> items;
+
+public:
+    Trader(const string& n, int startGold, size_t itemKinds) : name(n), gold(startGold), items(itemKinds, 0) {}
+    const string& getName() const { return name; }
+    int getGold() const { return gold; }
+    int itemCount(uint32_t item) const { return items[item]; }
+    void gainGold(int amount) { gold += amount; }
+    void spendGold(int amount) {
+        if (amount > gold) throw runtime_error(name + ": 골드가 부족합니다");
+        gold -= amount;
+    }
+    void addItems(uint32_t item, int n) { items[item] += n; }
+    void takeItems(uint32_t item, int n) {
+        if (n > items[item]) throw runtime_error(name + ": 아이템이 부족합니다");
+        items[item] -= n;
+    }
+};
+
+class Marketplace {
+private:
+    vector<string> itemNames;
+    vector<Trader*> traders;
+    OrderPool pool;
+    OrderIndex index;
+    vector<OrderBook> books;
+    vector<Trade> trades;
+    OrderId nextId = 1;
+
+    // 체결: 매수자는 아이템을 받고 (지정가 - 체결가) 차액을 돌려받음, 매도자는 골드를 받음
+    void settle(int buyLimit, OrderId takerId) {
+        for (const Trade& t : trades) {
+            traders[t.buyer]->addItems(t.item, int(t.quantity));
+            traders[t.seller]->gainGold(t.price * int(t.quantity));
+            if (t.buyOrder == takerId) traders[t.buyer]->gainGold((buyLimit - t.price) * int(t.quantity));
+            cout << "  체결: " << itemNames[t.item] << " " << t.quantity << "개 @" << t.price << "G ("
+                 << traders[t.seller]->getName() << " → " << traders[t.buyer]->getName() << ")" << endl;
+        }
+        trades.clear();
+    }
+
+public:
+    Marketplace(vector<string> names, size_t capacity)
+        : itemNames(move(names)), pool(capacity), index(capacity) {
+        if (itemNames.size() > 65536) throw invalid_argument("아이템은 최대 65536종");
+        books.reserve(itemNames.size());
+        for (uint32_t i = 0; i < itemNames.size(); ++i) books.emplace_back(i, pool, index);
+    }
+
+    uint32_t join(Trader& trader) {
+        traders.push_back(&trader);
+        return uint32_t(traders.size() - 1);
+    }
+
+    OrderId place(uint32_t trader, uint32_t item, Side side, int price, uint32_t quantity) {
+        Trader& t = *traders.at(trader);
+        OrderBook::checkOrder(price, quantity);                         // 예치 전에 검증
+        if (side == Side::Buy) t.spendGold(price * int(quantity));      // 예치
+        else t.takeItems(item, int(quantity));
+        OrderId id = nextId++;
+        books.at(item).submit(id, trader, side, price, quantity, trades);
+        settle(side == Side::Buy ? price : 0, id);
+        return id;
+    }
+
+    // 주문 번호만으로 취소: 아이템은 노드에 기록된 값을 따름 (예치 반환도 그 아이템으로)
+    void cancel(OrderId id) {
+        uint32_t idx = index.find(id);
+        if (idx == kNil) return;
+        uint32_t item = pool[idx].item;
+        OrderNode n{};
+        uint32_t remaining = books[item].cancel(id, &n);
+        if (remaining == 0) return;
+        Trader& t = *traders[n.owner];
+        if (n.side == Side::Buy) t.gainGold(n.price * int(remaining));  // 예치 반환
+        else t.addItems(item, int(remaining));
+        cout << "  취소: " << t.getName() << " 의 " << itemNames[item] << " 주문 " << remaining << "개 반환" << endl;
+    }
+
+    const OrderBook& book(uint32_t item) const { return books.at(item); }
+};
+
+// [6] 재생 벤치마크
+enum class CommandType : uint8_t { Submit, Cancel, Modify };
+
+struct Command {
+    CommandType type;
+    Side side;
+    uint16_t item;
+    int price;
+    uint32_t quantity;
+    uint32_t owner;
+    OrderId id;
+};
+
+// 아이템마다 무작위로 움직이는 적정가 주변에 주문이 쌓이고, 일부는 취소/정정됨
+vector<Command> makeReplay(size_t count, uint16_t items, uint64_t seed) {
+    mt19937_64 rng(seed);
+    vector<double> fair(items);
+    for (auto& f : fair) f = 500 + double(rng() % 4000);
+    vector<vector<OrderId>> resting(items);     // 취소/정정 대상 후보 (이미 체결됐을 수도 있음)
+    vector<Command> log;
+    log.reserve(count);
+    OrderId nextId = 1;
+    normal_distribution<> step(0, 0.5), offset(0, 6);
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t item = uint16_t(rng() % items);
+        fair[item] = clamp(fair[item] + step(rng), 100.0, double(kMaxPrice - 100));
+        uint64_t r = rng() % 100;
+        auto& candidates = resting[item];
+        if (r < 20 && !candidates.empty()) {
+            size_t k = rng() % candidates.size();
+            OrderId id = candidates[k];
+            candidates[k] = candidates.back();
+            candidates.pop_back();
+            log.push_back(Command{CommandType::Cancel, Side::Buy, item, 0, 0, 0, id});
+        } else if (r < 28 && !candidates.empty()) {
+            OrderId id = candidates[rng() % candidates.size()];
+            Side side = rng() & 1 ? Side::Buy : Side::Sell;       // 정정에서는 무시됨
+            int price = int(fair[item] + offset(rng));
+            log.push_back(Command{CommandType::Modify, side, item, price, uint32_t(1 + rng() % 10), 0, id});
+        } else {
+            Side side = rng() & 1 ? Side::Buy : Side::Sell;
+            double edge = abs(offset(rng));
+            // 대부분은 적정가 바깥쪽(대기 주문), 일부는 반대편을 넘어섬(즉시 체결)
+            int price = int(side == Side::Buy ? fair[item] - edge + (r % 5 == 0 ? 8 : 0)
+                                              : fair[item] + edge - (r % 5 == 0 ? 8 : 0));
+            OrderId id = nextId++;
+            log.push_back(Command{CommandType::Submit, side, item, clamp(price, 1, kMaxPrice - 1),
+                                  uint32_t(1 + rng() % 20), uint32_t(rng() % 10000), id});
+            candidates.push_back(id);
+            if (candidates.size() > 4096) candidates.erase(candidates.begin(), candidates.begin() + 2048);
+        }
+    }
+    return log;
+}
+
+template <typename Books>
+TradeDigest replay(Books& books, const vector<Command>& log, vector<double>* latencyNs) {
+    TradeDigest digest;
+    vector<Trade> trades;
+    trades.reserve(1024);
+    for (size_t i = 0; i < log.size(); ++i) {
+        const Command& c = log[i];
+        bool sample = latencyNs && (i & 15) == 0;
+        auto t0 = sample ? chrono::steady_clock::now() : chrono::steady_clock::time_point{};
+        auto& book = books[c.item];
+        switch (c.type) {
+            case CommandType::Submit: book.submit(c.id, c.owner, c.side, c.price, c.quantity, trades); break;
+            case CommandType::Cancel: book.cancel(c.id); break;
+            case CommandType::Modify: book.modify(c.id, c.price, c.quantity, trades); break;
+        }
+        if (sample) latencyNs->push_back(chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count());
+        for (const Trade& t : trades) digest.add(t);
+        trades.clear();
+    }
+    return digest;
+}
+
+double percentile(vector<double>& v, double p) {
+    size_t k = min(v.size() - 1, size_t(p * v.size()));
+    nth_element(v.begin(), v.begin() + k, v.end());
+    return v[k];
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t commandCount = argc > 1 ? stoul(argv[1]) : 3000000;
+        int itemKinds = argc > 2 ? stoi(argv[2]) : 16;
+        if (commandCount == 0 || itemKinds < 1 || itemKinds > 65535) throw invalid_argument("잘못된 인자");
+
+        // 데모: 플레이어들이 체력 포션을 사고팖
+        cout << "=== 아이템 거래소 데모 ===" << endl;
+        Marketplace market({"체력 포션", "힘의 물약"}, 1024);
+        Trader alice("앨리스", 500, 2), bob("밥", 100, 2), carol("캐럴", 300, 2);
+        uint32_t a = market.join(alice), b = market.join(bob), c = market.join(carol);
+        bob.addItems(0, 10);
+        carol.addItems(0, 5);
+        market.place(b, 0, Side::Sell, 25, 4);
+        market.place(c, 0, Side::Sell, 22, 3);
+        OrderId late = market.place(b, 0, Side::Sell, 22, 2);      // 같은 가격, 늦게 → 캐럴 다음
+        cout << "매도 호가 최우선: " << market.book(0).bestAskPrice() << "G" << endl;
+        market.place(a, 0, Side::Buy, 24, 4);       // 22G 캐럴 3개 → 22G 밥 1개
+        market.cancel(late);
+        market.place(a, 0, Side::Buy, 20, 5);       // 체결 없이 대기
+        cout << "앨리스 " << alice.getGold() << "G/포션 " << alice.itemCount(0) << "개, 밥 " << bob.getGold()
+             << "G/포션 " << bob.itemCount(0) << "개, 캐럴 " << carol.getGold() << "G/포션 " << carol.itemCount(0)
+             << "개, 최우선 호가 " << market.book(0).bestBidPrice() << "G / " << market.book(0).bestAskPrice() << "G"
+             << endl;
+
+        // 주문 번호 색인을 공유하는 두 주문장: 다른 주문장의 번호로 취소/정정하면 아무것도 바뀌지 않아야 함
+        bool isolated;
+        {
+            OrderPool p(16);
+            OrderIndex idx(16);
+            OrderBook potions(0, p, idx), elixirs(1, p, idx);
+            vector<Trade> tr;
+            potions.submit(1, 0, Side::Sell, 30, 5, tr);
+            elixirs.submit(2, 0, Side::Buy, 40, 3, tr);
+            bool wrongCancel = elixirs.cancel(1) == 0 && potions.cancel(2) == 0;
+            bool wrongModify = !elixirs.modify(1, 35, 1, tr) && !potions.modify(2, 10, 1, tr);
+            isolated = wrongCancel && wrongModify && tr.empty() && potions.bestAskPrice() == 30 &&
+                       elixirs.bestBidPrice() == 40 && potions.cancel(1) == 5 && elixirs.cancel(2) == 3 &&
+                       potions.bestAskPrice() == kMaxPrice && elixirs.bestBidPrice() == 0;
+        }
+        cout << "다른 아이템 주문장으로의 취소/정정 무시: " << (isolated ? "예" : "아니오!") << endl;
+
+        // 잘못된 정정/중복 번호 주문은 체결이나 삭제 없이 거부되어야 함
+        bool rejectedCleanly;
+        {
+            OrderPool p(16);
+            OrderIndex idx(16);
+            OrderBook potions(0, p, idx);
+            vector<Trade> tr;
+            potions.submit(1, 0, Side::Sell, 30, 5, tr);
+            potions.submit(2, 1, Side::Buy, 20, 4, tr);
+            size_t rejects = 0;
+            auto expectReject = [&](auto&& f) {
+                try {
+                    f();
+                } catch (const invalid_argument&) {
+                    ++rejects;
+                }
+            };
+            expectReject([&] { potions.modify(1, 0, 5, tr); });
+            expectReject([&] { potions.modify(2, kMaxPrice, 4, tr); });
+            expectReject([&] { potions.submit(2, 2, Side::Buy, 35, 3, tr); });     // 1번과 교차하지만 번호 중복
+            rejectedCleanly = rejects == 3 && tr.empty() && potions.bestAskPrice() == 30 && potions.bestBidPrice() == 20 &&
+                              potions.cancel(1) == 5 && potions.cancel(2) == 4;
+        }
+        cout << "잘못된 정정/중복 번호 거부, 주문장 유지: " << (rejectedCleanly ? "예" : "아니오!") << endl;
+
+        // 벤치마크
+        cout << "\n=== 재생 벤치마크: 명령 " << commandCount << "개, 아이템 " << itemKinds << "종 ===" << endl;
+        vector<Command> log = makeReplay(commandCount, uint16_t(itemKinds), 1234);
+        size_t submits = count_if(log.begin(), log.end(), [](const Command& c) { return c.type == CommandType::Submit; });
+        cout << "신규 " << submits << ", 취소 "
+             << count_if(log.begin(), log.end(), [](const Command& c) { return c.type == CommandType::Cancel; })
+             << ", 정정 "
+             << count_if(log.begin(), log.end(), [](const Command& c) { return c.type == CommandType::Modify; }) << endl;
+
+        const size_t capacity = 1 << 21;
+        OrderPool pool(capacity);
+        OrderIndex index(capacity);
+        vector<OrderBook> books;
+        books.reserve(itemKinds);
+        for (int i = 0; i < itemKinds; ++i) books.emplace_back(uint32_t(i), pool, index);
+        vector<MapOrderBook> mapBooks;
+        for (int i = 0; i < itemKinds; ++i) mapBooks.emplace_back(uint32_t(i));
+
+        vector<double> latency;
+        latency.reserve(commandCount / 16 + 1);
+        auto t0 = chrono::steady_clock::now();
+        TradeDigest fast = replay(books, log, &latency);
+        double fastSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        t0 = chrono::steady_clock::now();
+        TradeDigest slow = replay(mapBooks, log, nullptr);
+        double slowSec = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        cout << "침입형 주문장: " << fastSec * 1000 << " ms, " << commandCount / fastSec / 1e6 << "M 명령/초, 평균 "
+             << fastSec * 1e9 / commandCount << " ns/명령, 최대 동시 주문 " << pool.peakLive() << "개" << endl;
+        cout << "  명령별 지연(1/16 표본): p50 " << percentile(latency, 0.5) << " ns, p99 " << percentile(latency, 0.99)
+             << " ns, p99.9 " << percentile(latency, 0.999) << " ns" << endl;
+        cout << "map+list 주문장: " << slowSec * 1000 << " ms, " << commandCount / slowSec / 1e6 << "M 명령/초 ("
+             << slowSec / fastSec << "배 느림)" << endl;
+        cout << "체결 " << fast.count << "건, 거래량 " << fast.volume << "개 | 두 구현 체결 기록 일치: "
+             << (fast.hash == slow.hash && fast.count == slow.count ? "예" : "아니오!") << endl;
+        return fast.hash == slow.hash && fast.count == slow.count && isolated && rejectedCleanly ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
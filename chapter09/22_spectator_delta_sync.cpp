@@ -0,0 +1,394 @@
+/*
+ * 파일명: 22_spectator_delta_sync.cpp
+ *
+ * 주제: 관전자를 위한 델타 압축 상태 동기화 (Delta-compressed Spectator Sync)
+ * 정의: 전투 상태를 매 틱 글자로 다시 보내는 대신, 관전자가 마지막으로 확인(ack)한 상태와
+ *       비교해 바뀐 필드만 이진 델타로 보내고, 주기적으로 전체 상태(키프레임)를 보내는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - displayInfo() 는 매번 전체 상태를 사람이 읽는 글자로 출력 → 관전자 수 x 글자 크기만큼 전송
+ *
+ * 핵심 개념:
+ * - 서버는 최근 H 틱의 상태를 링 버퍼에 보관, 관전자마다 마지막 ack 틱만 기억
+ * - 패킷 = [틱][기준 틱][바뀐 필드 비트마스크][필드별 지그재그 varint 차이][인벤토리(바뀐 경우)]
+ *   기준 틱이 없거나(첫 접속) 너무 오래됐거나 키프레임 주기면 0 상태 기준 = 키프레임
+ * - 한 번만 인코딩: 같은 틱에서 기준 틱이 같은 관전자들은 같은 바이트열을 받음
+ *   → 인코딩 횟수 = 서로 다른 기준 틱 수 (보통 몇 개), 관전자 수와 무관
+ * - 복사 없는 전파: 패킷은 shared_ptr<const Packet> 로 한 번 만들고 관전자 수신함에는 포인터만 넣음
+ * - 관전자는 자신이 받은 상태들을 같은 크기의 링에 보관하고, ack 는 일부 유실/지연됨
+ *   → 서버는 확인된 상태만 기준으로 쓰므로 유실이 있어도 항상 올바르게 복원 (해시로 검증)
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o spectators 22_spectator_delta_sync.cpp
+ * 실행: ./spectators [관전자 수] [틱 수] [ack 유실률(%)]
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <deque>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// [1] 관전 화면에 필요한 전투 상태 (포인터 없는 고정 크기 → 링 버퍼에 그대로 보관)
+enum Field : int {
+    PlayerHealth, PlayerMaxHealth, PlayerAttack, PlayerDefense, PlayerLevel, PlayerExperience, PlayerGold,
+    MonsterKind, MonsterHealth, MonsterMaxHealth, MonsterAttack, Buffs, FieldCount
+};
+
+constexpr int kMaxInventory = 16;
+const char* kMonsterNames[] = {"슬라임", "고블린", "오크", "드래곤"};
+const char* kItemNames[] = {"체력 포션", "힘의 물약", "큰 체력 포션", "방어의 부적"};
+
+struct BattleView {
+    int32_t fields[FieldCount];
+    uint8_t inventoryCount;
+    uint8_t inventory[kMaxInventory];
+
+    bool sameInventory(const BattleView& o) const {
+        return inventoryCount == o.inventoryCount && memcmp(inventory, o.inventory, inventoryCount) == 0;
+    }
+    uint64_t hash() const {
+        uint64_t h = 0;
+        for (int f = 0; f < FieldCount; ++f) h = mix64(h ^ uint32_t(fields[f]));
+        for (int i = 0; i < inventoryCount; ++i) h = mix64(h ^ (0x100u | inventory[i]));
+        return h;
+    }
+};
+
+// game.cpp displayInfo() 형식의 글자 (기존 방식의 전송량 비교용)
+string displayText(const BattleView& v) {
+    ostringstream out;
+    out << "\n=== 용사 정보 ===\n레벨: " << v.fields[PlayerLevel] << " | 경험치: " << v.fields[PlayerExperience]
+        << "\n체력: " << v.fields[PlayerHealth] << "/" << v.fields[PlayerMaxHealth] << "\n공격력: " << v.fields[PlayerAttack]
+        << " | 방어력: " << v.fields[PlayerDefense] << "\n골드: " << v.fields[PlayerGold] << "G\n["
+        << kMonsterNames[v.fields[MonsterKind]] << "] 체력: " << v.fields[MonsterHealth] << "/"
+        << v.fields[MonsterMaxHealth] << " | 공격력: " << v.fields[MonsterAttack] << "\n인벤토리:";
+    for (int i = 0; i < v.inventoryCount; ++i) out << " " << kItemNames[v.inventory[i]];
+    out << "\n";
+    return out.str();
+}
+
+// [2] 전투 시뮬레이션: 한 틱 = 한 번의 공방 또는 아이템 사용
+class LiveBattle {
+private:
+    BattleView v{};
+    mt19937 rng;
+
+    void spawnMonster() {
+        int kind = int(rng() % 4), lv = max(1, v.fields[PlayerLevel]);
+        static const int hp[] = {30, 50, 80, 150}, hpLv[] = {10, 15, 20, 30};
+        static const int att[] = {8, 12, 18, 25}, attLv[] = {2, 3, 4, 5};
+        v.fields[MonsterKind] = kind;
+        v.fields[MonsterMaxHealth] = v.fields[MonsterHealth] = hp[kind] + hpLv[kind] * lv;
+        v.fields[MonsterAttack] = att[kind] + attLv[kind] * lv;
+    }
+
+public:
+    explicit LiveBattle(uint32_t seed) : rng(seed) {
+        v.fields[PlayerHealth] = v.fields[PlayerMaxHealth] = 100;
+        v.fields[PlayerAttack] = 20;
+        v.fields[PlayerDefense] = 5;
+        v.fields[PlayerLevel] = 1;
+        v.fields[PlayerGold] = 50;
+        v.inventory[v.inventoryCount++] = 0;
+        v.inventory[v.inventoryCount++] = 1;
+        spawnMonster();
+    }
+
+    const BattleView& view() const { return v; }
+
+    void tick() {
+        int32_t* f = v.fields;
+        // 체력이 낮으면 회복 아이템 사용, 없으면 공격
+        if (f[PlayerHealth] * 3 < f[PlayerMaxHealth] && v.inventoryCount > 0) {
+            int idx = v.inventoryCount - 1;
+            uint8_t item = v.inventory[idx];
+            if (item == 0 || item == 2) f[PlayerHealth] = min(f[PlayerMaxHealth], f[PlayerHealth] + (item ? 80 : 30));
+            if (item == 1) { f[PlayerAttack] += 10; f[Buffs] |= 1; }
+            if (item == 3) { f[PlayerDefense] += 3; f[Buffs] |= 2; }
+            v.inventoryCount--;
+            return;
+        }
+        int damage = f[PlayerAttack] - 5 + int(rng() % 11);
+        f[MonsterHealth] = max(0, f[MonsterHealth] - max(1, damage - f[PlayerLevel]));
+        if (f[MonsterHealth] == 0) {
+            int kind = f[MonsterKind], lv = max(1, f[PlayerLevel]);
+            static const int exp[] = {20, 35, 50, 100}, expLv[] = {5, 8, 10, 15};
+            static const int gold[] = {10, 20, 35, 75}, goldLv[] = {3, 5, 7, 10};
+            f[PlayerExperience] += exp[kind] + expLv[kind] * lv;
+            f[PlayerGold] += gold[kind] + goldLv[kind] * lv;
+            if (f[PlayerExperience] >= f[PlayerLevel] * 100) {
+                f[PlayerLevel]++;
+                f[PlayerMaxHealth] += 20;
+                f[PlayerHealth] = f[PlayerMaxHealth];
+                f[PlayerAttack] += 5;
+                f[PlayerDefense] += 2;
+            }
+            if (rng() % 3 == 0 && v.inventoryCount < kMaxInventory) v.inventory[v.inventoryCount++] = uint8_t(rng() % 4);
+            f[Buffs] = 0;       // 버프는 전투 하나 동안
+            spawnMonster();
+            return;
+        }
+        f[PlayerHealth] -= max(1, f[MonsterAttack] - 3 + int(rng() % 7) - f[PlayerDefense]);
+        if (f[PlayerHealth] <= 0) {     // 쓰러지면 마을에서 회복 (골드 절반)
+            f[PlayerHealth] = f[PlayerMaxHealth];
+            f[PlayerGold] /= 2;
+            f[Buffs] = 0;
+            spawnMonster();
+        }
+    }
+};
+
+// [3] 이진 델타 인코딩
+struct Packet {
+    vector<uint8_t> bytes;
+};
+
+class Writer {
+private:
+    vector<uint8_t>& out;
+
+public:
+    explicit Writer(vector<uint8_t>& o) : out(o) {}
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            out.push_back(uint8_t(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(uint8_t(v));
+    }
+    void zigzag(int64_t v) { varint((uint64_t(v) << 1) ^ uint64_t(v >> 63)); }
+    void byte(uint8_t b) { out.push_back(b); }
+};
+
+class Reader {
+private:
+    const uint8_t* p;
+    const uint8_t* end;
+
+public:
+    Reader(const uint8_t* data, size_t size) : p(data), end(data + size) {}
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (p == end) throw runtime_error("잘린 패킷");
+            uint8_t b = *p++;
+            v |= uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        throw runtime_error("잘못된 varint");
+    }
+    int64_t zigzag() {
+        uint64_t v = varint();
+        return int64_t(v >> 1) ^ -int64_t(v & 1);
+    }
+    uint8_t byte() {
+        if (p == end) throw runtime_error("잘린 패킷");
+        return *p++;
+    }
+    bool done() const { return p == end; }
+};
+
+constexpr uint32_t kInventoryBit = 1u << FieldCount;
+
+// 기준 틱 0 = 키프레임 (0 상태 기준). 틱 번호는 1부터
+shared_ptr<const Packet> encodeDelta(uint32_t tick, uint32_t baseTick, const BattleView& base, const BattleView& cur) {
+    auto packet = make_shared<Packet>();
+    packet->bytes.reserve(48);
+    Writer w(packet->bytes);
+    w.varint(tick);
+    w.varint(baseTick);
+    uint32_t mask = 0;
+    for (int f = 0; f < FieldCount; ++f) {
+        if (cur.fields[f] != base.fields[f]) mask |= 1u << f;
+    }
+    if (!cur.sameInventory(base)) mask |= kInventoryBit;
+    w.varint(mask);
+    for (int f = 0; f < FieldCount; ++f) {
+        if (mask & (1u << f)) w.zigzag(int64_t(cur.fields[f]) - base.fields[f]);
+    }
+    if (mask & kInventoryBit) {
+        w.byte(cur.inventoryCount);
+        for (int i = 0; i < cur.inventoryCount; ++i) w.byte(cur.inventory[i]);
+    }
+    return packet;
+}
+
+// [4] 관전자 (같은 프로세스의 로컬 클라이언트)
+constexpr uint32_t kHistory = 64;       // 서버/클라이언트 상태 링 크기
+
+class Spectator {
+private:
+    BattleView states[kHistory];
+    uint32_t stateTick[kHistory] = {};
+    uint32_t latest = 0;
+    vector<shared_ptr<const Packet>> inbox;
+
+public:
+    size_t keyframes = 0, deltas = 0;
+
+    void deliver(shared_ptr<const Packet> p) { inbox.push_back(move(p)); }
+
+    // 받은 패킷을 풀어 상태 갱신. 복원한 최신 틱 반환 (ack 대상)
+    uint32_t process() {
+        for (const auto& packet : inbox) {
+            Reader r(packet->bytes.data(), packet->bytes.size());
+            uint32_t tick = uint32_t(r.varint());
+            uint32_t baseTick = uint32_t(r.varint());
+            BattleView cur{};
+            if (baseTick != 0) {
+                if (stateTick[baseTick % kHistory] != baseTick) throw runtime_error("기준 상태가 없습니다");
+                cur = states[baseTick % kHistory];
+                ++deltas;
+            } else {
+                ++keyframes;
+            }
+            uint32_t mask = uint32_t(r.varint());
+            for (int f = 0; f < FieldCount; ++f) {
+                if (mask & (1u << f)) cur.fields[f] = int32_t(cur.fields[f] + r.zigzag());
+            }
+            if (mask & kInventoryBit) {
+                cur.inventoryCount = r.byte();
+                if (cur.inventoryCount > kMaxInventory) throw runtime_error("잘못된 인벤토리 크기");
+                for (int i = 0; i < cur.inventoryCount; ++i) cur.inventory[i] = r.byte();
+            }
+            if (!r.done()) throw runtime_error("패킷 끝에 남은 바이트");
+            states[tick % kHistory] = cur;
+            stateTick[tick % kHistory] = tick;
+            latest = tick;
+        }
+        inbox.clear();
+        return latest;
+    }
+
+    const BattleView* stateAt(uint32_t tick) const {
+        return stateTick[tick % kHistory] == tick ? &states[tick % kHistory] : nullptr;
+    }
+};
+
+// [5] 서버: 관전자별 ack 기준으로 델타를 고르고, 같은 기준은 한 번만 인코딩
+class SpectatorServer {
+private:
+    BattleView history[kHistory];
+    uint32_t historyTick[kHistory] = {};
+    vector<uint32_t> acked;                  // 관전자별 마지막 확인 틱 (0 = 없음)
+    uint32_t keyframeInterval;
+    shared_ptr<const Packet> cache[kHistory + 1];   // 기준별 패킷 (마지막 칸 = 키프레임)
+    uint32_t cacheTick[kHistory + 1] = {};           // 그 패킷을 만든 틱
+
+public:
+    size_t encodes = 0, packetsSent = 0, bytesSent = 0;
+    double encodeMs = 0;
+
+    SpectatorServer(size_t spectators, uint32_t keyframeEvery) : acked(spectators, 0), keyframeInterval(keyframeEvery) {}
+
+    void acknowledge(size_t spectator, uint32_t tick) { acked[spectator] = max(acked[spectator], tick); }
+
+    void broadcast(uint32_t tick, const BattleView& state, vector<Spectator>& spectators) {
+        history[tick % kHistory] = state;
+        historyTick[tick % kHistory] = tick;
+        bool keyframeTick = tick % keyframeInterval == 0;
+        static const BattleView kZero{};
+        auto t0 = chrono::steady_clock::now();
+        for (size_t s = 0; s < spectators.size(); ++s) {
+            uint32_t base = acked[s];
+            // 기준이 없거나 링에서 밀려났거나 키프레임 주기면 키프레임
+            if (keyframeTick || base == 0 || tick - base >= kHistory || historyTick[base % kHistory] != base) base = 0;
+            uint32_t c = base ? base % kHistory : kHistory;
+            auto& slot = cache[c];
+            if (cacheTick[c] != tick) {     // 이번 틱에 이 기준으로는 처음 → 인코딩
+                slot = encodeDelta(tick, base, base ? history[base % kHistory] : kZero, state);
+                cacheTick[c] = tick;
+                ++encodes;
+            }
+            spectators[s].deliver(slot);        // 포인터만 복사 (바이트는 공유)
+            ++packetsSent;
+            bytesSent += slot->bytes.size();
+        }
+        encodeMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    }
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        size_t spectatorCount = argc > 1 ? stoul(argv[1]) : 5000;
+        uint32_t ticks = argc > 2 ? uint32_t(stoul(argv[2])) : 2000;
+        int lossPercent = argc > 3 ? stoi(argv[3]) : 10;
+        if (spectatorCount == 0 || ticks == 0 || lossPercent < 0 || lossPercent > 100) throw invalid_argument("잘못된 인자");
+        const uint32_t keyframeEvery = 300, ackDelay = 2;
+
+        cout << "=== 관전자 델타 동기화 ===" << endl;
+        cout << "관전자 " << spectatorCount << "명, " << ticks << "틱, ack 유실 " << lossPercent << "%, 지연 " << ackDelay
+             << "틱, 키프레임 " << keyframeEvery << "틱마다" << endl;
+
+        LiveBattle battle(7);
+        vector<Spectator> spectators(spectatorCount);
+        SpectatorServer server(spectatorCount, keyframeEvery);
+        struct PendingAck {
+            uint32_t arriveTick;
+            uint32_t spectator, tick;
+        };
+        deque<PendingAck> acks;
+        mt19937 net(11);
+        size_t textBytes = 0, mismatches = 0;
+        double clientMs = 0;
+
+        for (uint32_t tick = 1; tick <= ticks; ++tick) {
+            battle.tick();
+            while (!acks.empty() && acks.front().arriveTick <= tick) {
+                server.acknowledge(acks.front().spectator, acks.front().tick);
+                acks.pop_front();
+            }
+            server.broadcast(tick, battle.view(), spectators);
+            textBytes += displayText(battle.view()).size() * spectatorCount;
+
+            auto t0 = chrono::steady_clock::now();
+            for (uint32_t s = 0; s < spectatorCount; ++s) {
+                uint32_t got = spectators[s].process();
+                if (int(net() % 100) >= lossPercent) acks.push_back(PendingAck{tick + ackDelay, s, got});
+            }
+            clientMs += chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+            // 표본 관전자의 화면이 서버 상태와 같은지
+            for (size_t s = tick % 97; s < spectatorCount; s += 97) {
+                const BattleView* mine = spectators[s].stateAt(tick);
+                if (!mine || mine->hash() != battle.view().hash()) ++mismatches;
+            }
+        }
+
+        size_t keyframes = 0, deltas = 0;
+        for (const auto& s : spectators) {
+            keyframes += s.keyframes;
+            deltas += s.deltas;
+        }
+        cout << "\n전송량: displayInfo 글자 " << textBytes / 1024 << " KB → 이진 델타 " << server.bytesSent / 1024
+             << " KB (" << double(textBytes) / server.bytesSent << "배 감소), 패킷당 평균 "
+             << double(server.bytesSent) / server.packetsSent << " 바이트" << endl;
+        cout << "패킷 " << server.packetsSent << "개 (델타 " << deltas << ", 키프레임 " << keyframes << ") 에 인코딩 "
+             << server.encodes << "회 → 틱당 " << double(server.encodes) / ticks << "회 (관전자 수 " << spectatorCount
+             << " 대비)" << endl;
+        cout << "서버 인코딩+전파: 틱당 " << server.encodeMs / ticks << " ms (관전자당 "
+             << server.encodeMs * 1e6 / (double(ticks) * spectatorCount) << " ns), 클라이언트 복원 관전자당 "
+             << clientMs * 1e6 / (double(ticks) * spectatorCount) << " ns" << endl;
+        cout << "표본 화면 검증 불일치: " << mismatches << "건" << endl;
+        return mismatches == 0 ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,385 @@
+/*
+ * 파일명: 23_skill_tree_bitset.cpp
+ *
+ * 주제: 비트셋 해금 상태와 미리 계산한 능력치 합계를 쓰는 스킬 트리 (Bitset Skill Tree)
+ * 정의: 선행 조건이 있는 수백 개의 스킬 노드를 플레이어마다 비트셋 하나로 해금 관리하고,
+ *       공격력/방어력/최대 체력 보정치는 비트셋이 바뀔 때만 증분 갱신해 평소에는 필드만 읽는 기법
+ *
+ * chapter08/game.cpp 의 한계:
+ * - Player::levelUp 은 고정 증가치(체력 +20, 공격력 +5, 방어력 +2)만 적용, 성장 선택지가 없음
+ * - 스킬 보정치를 calculateDamage() 안에서 매번 합산하면 해금한 스킬 수만큼 전투가 느려짐
+ *
+ * 핵심 개념:
+ * - 해금 상태 = 512비트 (uint64_t 8개). 선행 조건 검사 = (선행 마스크 & ~해금) == 0 을 워드 8개로
+ * - 역방향 의존 마스크: 되돌리기(환불)는 해금된 후속 스킬이 하나도 없을 때만 허용
+ * - 합계는 두 층: 고정치 합/백분율 합(베이시스 포인트)을 해금·환불 때 더하고 빼기만 하고,
+ *   최종 능력치 = (기본 + 고정치) x (1 + 백분율) 은 그때 한 번 계산해 필드에 저장
+ * - 전체 재계산(세이브 로드, 초기화)은 켜진 비트만 ctz 로 순회
+ * - 벤치마크: 능력치 읽기 = 필드 읽기 vs 매번 비트셋 합산 vs 매번 스킬 객체 목록 합산
+ *
+ * 컴파일: g++ -std=c++17 -O2 -o skilltree 23_skill_tree_bitset.cpp
+ * 실행: ./skilltree [해금할 스킬 수] [읽기 횟수(백만)]
+ */
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+using namespace std;
+
+// [1] 스킬 노드와 트리
+constexpr int kMaxSkills = 512;
+constexpr int kWords = kMaxSkills / 64;
+
+struct SkillSet {
+    array<uint64_t, kWords> words{};
+
+    bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(int i) { words[i >> 6] |= 1ULL << (i & 63); }
+    void reset(int i) { words[i >> 6] &= ~(1ULL << (i & 63)); }
+    bool containsAll(const SkillSet& need) const {
+        for (int w = 0; w < kWords; ++w) {
+            if (need.words[w] & ~words[w]) return false;
+        }
+        return true;
+    }
+    bool intersects(const SkillSet& o) const {
+        for (int w = 0; w < kWords; ++w) {
+            if (words[w] & o.words[w]) return true;
+        }
+        return false;
+    }
+    int count() const {
+        int n = 0;
+        for (uint64_t w : words) n += __builtin_popcountll(w);
+        return n;
+    }
+    template <typename F>
+    void forEach(F&& f) const {
+        for (int w = 0; w < kWords; ++w) {
+            for (uint64_t bits = words[w]; bits; bits &= bits - 1) f(w * 64 + __builtin_ctzll(bits));
+        }
+    }
+};
+
+// 스킬 하나의 보정치: 고정치 + 백분율(베이시스 포인트, 100 = 1%)
+struct StatModifier {
+    int32_t attack = 0, defense = 0, maxHealth = 0;
+    int32_t attackBp = 0, defenseBp = 0, maxHealthBp = 0;
+
+    StatModifier& operator+=(const StatModifier& o) {
+        attack += o.attack; defense += o.defense; maxHealth += o.maxHealth;
+        attackBp += o.attackBp; defenseBp += o.defenseBp; maxHealthBp += o.maxHealthBp;
+        return *this;
+    }
+    StatModifier& operator-=(const StatModifier& o) {
+        attack -= o.attack; defense -= o.defense; maxHealth -= o.maxHealth;
+        attackBp -= o.attackBp; defenseBp -= o.defenseBp; maxHealthBp -= o.maxHealthBp;
+        return *this;
+    }
+    bool operator==(const StatModifier& o) const {
+        return attack == o.attack && defense == o.defense && maxHealth == o.maxHealth
+               && attackBp == o.attackBp && defenseBp == o.defenseBp && maxHealthBp == o.maxHealthBp;
+    }
+};
+
+struct SkillNode {
+    string name;
+    int cost;
+    SkillSet prerequisites;
+    SkillSet dependents;        // 이 스킬을 선행 조건으로 갖는 스킬들 (환불 검사용)
+    StatModifier modifier;
+};
+
+class SkillTree {
+private:
+    vector<SkillNode> nodes;
+
+public:
+    int add(const string& name, int cost, const StatModifier& mod, const vector<int>& prereqs) {
+        if (nodes.size() >= size_t(kMaxSkills)) throw length_error("스킬은 최대 512개");
+        int id = int(nodes.size());
+        SkillNode node{name, cost, {}, {}, mod};
+        for (int p : prereqs) {
+            if (p < 0 || p >= id) throw invalid_argument("선행 스킬은 먼저 추가되어야 합니다: " + name);
+            node.prerequisites.set(p);
+            nodes[p].dependents.set(id);
+        }
+        nodes.push_back(move(node));
+        return id;
+    }
+    int size() const { return int(nodes.size()); }
+    const SkillNode& operator[](int id) const { return nodes.at(id); }
+};
+
+// game.cpp 와 같은 피해 굴림: 공격력 ±5
+int rollDamage(int attack, mt19937& rng) {
+    uniform_int_distribution<> dis(attack - 5, attack + 5);
+    return max(1, dis(rng));
+}
+
+// [2] 플레이어: 해금 비트셋 + 증분 합계 + 최종 능력치 필드
+class Player {
+private:
+    string name;
+    const SkillTree& tree;
+    int level = 1, skillPoints = 0;
+    int baseMaxHealth = 100, baseAttack = 20, baseDefense = 5;
+    SkillSet unlocked;
+    StatModifier totals;        // 해금된 스킬 보정치의 합 (증분 유지)
+
+    // calculateDamage 등이 읽는 값: 비트셋이 바뀔 때만 다시 계산
+    int maxHealth = 100, attack = 20, defense = 5, health = 100;
+
+    static int applyModifier(int base, int flat, int bp) { return int(int64_t(base + flat) * (10000 + bp) / 10000); }
+
+    void refreshDerived() {
+        int oldMax = maxHealth;
+        attack = applyModifier(baseAttack, totals.attack, totals.attackBp);
+        defense = applyModifier(baseDefense, totals.defense, totals.defenseBp);
+        maxHealth = max(1, applyModifier(baseMaxHealth, totals.maxHealth, totals.maxHealthBp));
+        health = clamp(health + (maxHealth - oldMax), 1, maxHealth);
+    }
+
+public:
+    Player(const string& n, const SkillTree& t) : name(n), tree(t) {}
+
+    // game.cpp 의 고정 증가치는 그대로 두고, 레벨마다 스킬 포인트 3 을 줌
+    void levelUp() {
+        level++;
+        baseMaxHealth += 20;
+        baseAttack += 5;
+        baseDefense += 2;
+        skillPoints += 3;
+        refreshDerived();
+        health = maxHealth;
+    }
+
+    bool canUnlock(int id) const {
+        const SkillNode& node = tree[id];
+        return !unlocked.test(id) && skillPoints >= node.cost && unlocked.containsAll(node.prerequisites);
+    }
+
+    void unlock(int id) {
+        if (!canUnlock(id)) throw invalid_argument("해금할 수 없는 스킬: " + tree[id].name);
+        unlocked.set(id);
+        skillPoints -= tree[id].cost;
+        totals += tree[id].modifier;
+        refreshDerived();
+    }
+
+    bool canRefund(int id) const { return unlocked.test(id) && !unlocked.intersects(tree[id].dependents); }
+
+    void refund(int id) {
+        if (!canRefund(id)) throw invalid_argument("되돌릴 수 없는 스킬 (후속 스킬이 해금됨): " + tree[id].name);
+        unlocked.reset(id);
+        skillPoints += tree[id].cost;
+        totals -= tree[id].modifier;
+        refreshDerived();
+    }
+
+    // 세이브 로드: 비트셋을 통째로 받아 켜진 비트만 순회해 합계 재계산
+    void load(const SkillSet& saved) {
+        unlocked = saved;
+        totals = recomputeTotals();
+        refreshDerived();
+    }
+
+    StatModifier recomputeTotals() const {
+        StatModifier sum;
+        unlocked.forEach([&](int id) { sum += tree[id].modifier; });
+        return sum;
+    }
+
+    // game.cpp 와 같은 피해 계산: 능력치는 필드 읽기
+    int calculateDamage(mt19937& rng) const { return rollDamage(attack, rng); }
+
+    int getAttack() const { return attack; }
+    int getDefense() const { return defense; }
+    int getMaxHealth() const { return maxHealth; }
+    int getSkillPoints() const { return skillPoints; }
+    int getLevel() const { return level; }
+    const SkillSet& getUnlocked() const { return unlocked; }
+    const StatModifier& getTotals() const { return totals; }
+    int baseAttackValue() const { return baseAttack; }
+
+    void displayInfo() const {
+        cout << "[" << name << "] 레벨 " << level << ", 스킬 " << unlocked.count() << "개, 남은 포인트 " << skillPoints
+             << " | 체력 " << health << "/" << maxHealth << ", 공격력 " << attack << ", 방어력 " << defense << endl;
+    }
+};
+
+// [3] 트리 생성: 8계층 x 64개, 각 노드는 바로 아래 계층의 1~3개를 선행 조건으로 가짐
+SkillTree makeTree(uint32_t seed) {
+    static const char* themes[] = {"검술", "방패", "생명력", "분노"};
+    SkillTree tree;
+    mt19937 rng(seed);
+    for (int tier = 0; tier < 8; ++tier) {
+        for (int i = 0; i < 64; ++i) {
+            int theme = i % 4;
+            StatModifier mod;
+            int power = 1 + tier;
+            switch (theme) {
+                case 0: mod.attack = 2 * power; if (rng() % 4 == 0) mod.attackBp = 100 * power; break;
+                case 1: mod.defense = power; if (rng() % 4 == 0) mod.defenseBp = 150 * power; break;
+                case 2: mod.maxHealth = 10 * power; if (rng() % 4 == 0) mod.maxHealthBp = 100 * power; break;
+                default: mod.attack = 3 * power; mod.defense = -power / 2; break;     // 공격을 얻고 방어를 잃음
+            }
+            vector<int> prereqs;
+            if (tier > 0) {
+                int count = 1 + int(rng() % 3);
+                for (int k = 0; k < count; ++k) prereqs.push_back((tier - 1) * 64 + (i + int(rng() % 9) - 4 + 64) % 64);
+                sort(prereqs.begin(), prereqs.end());
+                prereqs.erase(unique(prereqs.begin(), prereqs.end()), prereqs.end());
+            }
+            tree.add(string(themes[theme]) + " " + to_string(tier + 1) + "-" + to_string(i), 1 + tier / 2, mod, prereqs);
+        }
+    }
+    return tree;
+}
+
+// 비교 대상: 해금 목록을 스킬 객체 포인터로 들고, 능력치를 읽을 때마다 합산 (흔한 OOP 방식)
+class Skill {
+public:
+    virtual ~Skill() = default;
+    virtual void apply(StatModifier& sum) const = 0;
+};
+
+class ModifierSkill : public Skill {
+private:
+    StatModifier mod;
+
+public:
+    explicit ModifierSkill(const StatModifier& m) : mod(m) {}
+    void apply(StatModifier& sum) const override { sum += mod; }
+};
+
+template <typename F>
+double timeNsPerCall(size_t calls, F&& f) {
+    auto t0 = chrono::steady_clock::now();
+    f();
+    return chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count() / calls;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int targetSkills = argc > 1 ? stoi(argv[1]) : 200;
+        size_t reads = size_t(argc > 2 ? stoul(argv[2]) : 50) * 1000000;
+        if (targetSkills < 1 || targetSkills > kMaxSkills || reads == 0) throw invalid_argument("잘못된 인자");
+
+        SkillTree tree = makeTree(2024);
+        cout << "=== 스킬 트리 (" << tree.size() << "개 노드) ===" << endl;
+
+        // 레벨을 올리며 해금 가능한 스킬을 무작위로 고름
+        Player hero("용사", tree);
+        mt19937 rng(5);
+        while (hero.getUnlocked().count() < targetSkills) {
+            if (hero.getSkillPoints() == 0) hero.levelUp();
+            vector<int> options;
+            for (int id = 0; id < tree.size(); ++id) {
+                if (hero.canUnlock(id)) options.push_back(id);
+            }
+            if (options.empty()) {
+                hero.levelUp();
+                continue;
+            }
+            hero.unlock(options[rng() % options.size()]);
+        }
+        hero.displayInfo();
+
+        // 되돌리기 규칙: 후속 스킬이 해금된 스킬은 환불 불가
+        int blocked = -1, leaf = -1;
+        hero.getUnlocked().forEach([&](int id) {
+            if (hero.canRefund(id)) leaf = id;
+            else if (blocked < 0) blocked = id;
+        });
+        if (blocked >= 0) {
+            try {
+                hero.refund(blocked);
+            } catch (const invalid_argument& e) {
+                cout << "환불 시도 → " << e.what() << endl;
+            }
+        }
+        if (leaf >= 0) {
+            hero.refund(leaf);
+            cout << "'" << tree[leaf].name << "' 환불 후: ";
+            hero.displayInfo();
+            hero.unlock(leaf);
+        }
+
+        // 증분 합계 검증: 무작위 해금/환불 뒤 전체 재계산과 비교
+        size_t ops = 0, mismatches = 0;
+        Player tester("검증", tree);
+        for (int i = 0; i < 60; ++i) tester.levelUp();
+        for (int step = 0; step < 100000; ++step) {
+            int id = int(rng() % tree.size());
+            if (tester.canUnlock(id)) { tester.unlock(id); ++ops; }
+            else if (tester.canRefund(id)) { tester.refund(id); ++ops; }
+            if (step % 1000 == 0 && !(tester.recomputeTotals() == tester.getTotals())) ++mismatches;
+        }
+        cout << "무작위 해금/환불 " << ops << "회, 전체 재계산과 불일치 " << mismatches << "회" << endl;
+
+        // 해금/환불 한 번의 비용
+        vector<int> leaves;
+        hero.getUnlocked().forEach([&](int id) { if (hero.canRefund(id)) leaves.push_back(id); });
+        size_t toggles = 1000000;
+        double toggleNs = timeNsPerCall(toggles, [&] {
+            for (size_t i = 0; i < toggles; i += 2) {
+                int id = leaves[i % leaves.size()];
+                hero.refund(id);
+                hero.unlock(id);
+            }
+        });
+
+        // [4] 능력치 읽기 벤치마크
+        cout << "\n=== 공격력 읽기 " << reads / 1000000 << "M 회 (해금 " << hero.getUnlocked().count() << "개) ===" << endl;
+        vector<unique_ptr<Skill>> skillObjects;
+        hero.getUnlocked().forEach([&](int id) { skillObjects.push_back(make_unique<ModifierSkill>(tree[id].modifier)); });
+        auto fromTotals = [&](const StatModifier& t) {
+            return int(int64_t(hero.baseAttackValue() + t.attack) * (10000 + t.attackBp) / 10000);
+        };
+
+        int64_t sinkField = 0, sinkBitset = 0, sinkObjects = 0;
+        mt19937 dmgRng(1);
+        double fieldNs = timeNsPerCall(reads, [&] {
+            for (size_t i = 0; i < reads; ++i) sinkField += hero.calculateDamage(dmgRng);
+        });
+        size_t slowReads = reads / 100;
+        double bitsetNs = timeNsPerCall(slowReads, [&] {
+            for (size_t i = 0; i < slowReads; ++i) {
+                sinkBitset += rollDamage(fromTotals(hero.recomputeTotals()), dmgRng);
+            }
+        });
+        double objectNs = timeNsPerCall(slowReads, [&] {
+            for (size_t i = 0; i < slowReads; ++i) {
+                StatModifier sum;
+                for (const auto& s : skillObjects) s->apply(sum);
+                sinkObjects += rollDamage(fromTotals(sum), dmgRng);
+            }
+        });
+        // 읽기만 따로: volatile 포인터로 매 반복 필드를 다시 읽게 함
+        const Player* volatile heroPtr = &hero;
+        int64_t sinkRead = 0;
+        double readNs = timeNsPerCall(reads, [&] {
+            for (size_t i = 0; i < reads; ++i) sinkRead += heroPtr->getAttack();
+        });
+
+        cout << "필드 읽기(getAttack)       : " << readNs << " ns" << endl;
+        cout << "calculateDamage (필드 사용): " << fieldNs << " ns" << endl;
+        cout << "매번 비트셋 합산 후 피해   : " << bitsetNs << " ns (" << bitsetNs / fieldNs << "배)" << endl;
+        cout << "매번 스킬 객체 합산 후 피해: " << objectNs << " ns (" << objectNs / fieldNs << "배)" << endl;
+        cout << "해금/환불 1회 (증분 갱신)  : " << toggleNs << " ns" << endl;
+        cout << "(검산용 합계: " << (sinkField + sinkBitset + sinkObjects + sinkRead) % 1000 << ")" << endl;
+        return mismatches == 0 ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}
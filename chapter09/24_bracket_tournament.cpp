@@ -0,0 +1,322 @@
+/*
+ * 파일명: 24_bracket_tournament.cpp
+ *
+ * 주제: 100만 명 싱글 엘리미네이션 토너먼트 (Parallel Bracket Tournament)
+ * 정의: 2^20 명의 AI 플레이어가 한 판씩 전투하여 절반씩 탈락하는 대진표를,
+ *       라운드마다 스레드들이 나눠 처리하고 배리어로 라운드 경계를 맞추는 시뮬레이터
+ *
+ * chapter08/game.cpp 의 한계:
+ * - BattleSystem::battle 은 cin 입력과 cout 출력이 섞여 있어 한 판씩 사람이 진행해야 함
+ * - 전투 결과(경험치, 레벨업, 포션 사용)가 Player 객체 안에만 있어 대량 시뮬레이션에 쓰기 어려움
+ *
+ * 핵심 개념:
+ * - 헤드리스 전투: 07 의 simulateFight 와 같은 규칙(±5 피해, max(1, 피해 - 방어력), 30% 미만이면 포션)
+ * - 라운드 = 병렬 단계: 경기 i 는 cur[2i], cur[2i+1] 만 읽고 next[i] 에만 씀 → 잠금 없음
+ * - 배리어: 모든 스레드가 라운드를 끝내야 다음 라운드 시작 (06 의 Barrier 재사용)
+ * - 살아있는 대진만 메모리에: 라운드가 끝나면 이전 배열을 해제 → 최대 1.5 x 현재 인원
+ * - 결정론적 난수: (시드, 라운드, 경기 번호) 해시 → 스레드 수와 무관하게 같은 우승자
+ *
+ * 컴파일: g++ -std=c++17 -O2 -pthread -o tournament 24_bracket_tournament.cpp
+ * 실행: ./tournament [라운드 수(인원 = 2^N)] [스레드 수]
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+// [1] 결정론적 난수: splitmix64
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+struct MatchRng {
+    uint64_t state;
+    int range(int lo, int hi) { return lo + int(mix64(state++) % uint64_t(hi - lo + 1)); }
+};
+
+// [2] 참가자: 능력치는 레벨에서 계산 (Player::levelUp 과 같은 성장) → 12바이트
+struct Entrant {
+    uint32_t id;
+    uint32_t experience;
+    uint16_t level;
+    uint8_t potions;
+    uint8_t wins;
+
+    int maxHealth() const { return 100 + (level - 1) * 20; }
+    int attack() const { return 20 + (level - 1) * 5; }
+    int defense() const { return 5 + (level - 1) * 2; }
+
+    // game.cpp 의 gainExperience: 레벨 x 100 이상이면 레벨업 (한 번에 한 레벨)
+    void gainExperience(uint32_t exp) {
+        experience += exp;
+        if (experience >= uint32_t(level) * 100) ++level;
+    }
+};
+
+Entrant makeEntrant(uint32_t id, uint64_t seed) {
+    uint64_t h = mix64(seed ^ (uint64_t(id) << 1));
+    return Entrant{id, 0, uint16_t(1 + h % 30), uint8_t((h >> 8) % 3), 0};
+}
+
+// [3] 헤드리스 결투: 선공은 난수, 번갈아 공격, 체력 30% 미만이면 포션(+30)
+struct Fighter {
+    int health, maxHealth, attack, defense, potions;
+};
+
+struct DuelResult {
+    bool firstWon;
+    int turns;
+    int potionsUsed[2];
+    bool timedOut;
+};
+
+DuelResult duel(Fighter a, Fighter b, MatchRng& rng) {
+    Fighter* side[2] = {&a, &b};
+    DuelResult r{false, 0, {0, 0}, false};
+    int turn = rng.range(0, 1);
+    while (a.health > 0 && b.health > 0) {
+        if (++r.turns > 200) {
+            r.timedOut = true;
+            break;
+        }
+        Fighter& me = *side[turn];
+        Fighter& foe = *side[turn ^ 1];
+        if (me.health * 10 < me.maxHealth * 3 && me.potions > 0) {
+            me.health = min(me.maxHealth, me.health + 30);
+            --me.potions;
+            ++r.potionsUsed[turn];
+        } else {
+            int damage = max(1, rng.range(me.attack - 5, me.attack + 5));
+            foe.health -= max(1, damage - foe.defense);
+        }
+        turn ^= 1;
+    }
+    // 200턴 제한: 남은 체력 비율이 높은 쪽 승리 (같으면 앞 대진)
+    if (r.timedOut) r.firstWon = int64_t(a.health) * b.maxHealth >= int64_t(b.health) * a.maxHealth;
+    else r.firstWon = a.health > 0;
+    return r;
+}
+
+// [4] 재사용 가능한 배리어 (06 과 동일, C++17 에는 std::barrier 가 없음)
+class Barrier {
+private:
+    mutex mtx;
+    condition_variable cv;
+    size_t total;
+    size_t waiting = 0;
+    size_t generation = 0;
+
+public:
+    explicit Barrier(size_t n) : total(n) {}
+
+    void arriveAndWait() {
+        unique_lock<mutex> lock(mtx);
+        size_t gen = generation;
+        if (++waiting == total) {
+            waiting = 0;
+            ++generation;
+            cv.notify_all();
+        } else {
+            cv.wait(lock, [&] { return gen != generation; });
+        }
+    }
+};
+
+// 스레드별 라운드 통계 (캐시 라인 하나씩)
+struct alignas(64) RoundStats {
+    uint64_t matches = 0, turns = 0, upsets = 0, potions = 0, timeouts = 0;
+    uint64_t digest = 0;        // 승자 id 해시의 합 (순서 무관)
+
+    void merge(const RoundStats& o) {
+        matches += o.matches; turns += o.turns; upsets += o.upsets;
+        potions += o.potions; timeouts += o.timeouts; digest += o.digest;
+    }
+};
+
+struct MatchRecord {
+    Entrant first, second, winner;
+    int turns;
+};
+
+// [5] 토너먼트
+class Tournament {
+private:
+    uint64_t seed;
+    size_t threadCount;
+    vector<Entrant> cur, next;
+    int round = 0;
+
+    vector<RoundStats> stats;
+    vector<thread> workers;
+    Barrier startBarrier;
+    Barrier endBarrier;
+    bool stopping = false;
+
+    static constexpr size_t kInlineMatches = 256;   // 이보다 작은 라운드는 호출 스레드가 직접 처리
+
+public:
+    Tournament(int rounds, uint64_t s, size_t threads)
+        : seed(s), threadCount(max<size_t>(1, threads)), stats(threadCount),
+          startBarrier(threadCount + 1), endBarrier(threadCount + 1) {
+        if (rounds < 1 || rounds > 24) throw invalid_argument("라운드 수는 1~24");
+        cur.resize(size_t(1) << rounds);
+        for (size_t i = 0; i < cur.size(); ++i) cur[i] = makeEntrant(uint32_t(i), seed);
+        for (size_t t = 0; t < threadCount; ++t) {
+            workers.emplace_back(&Tournament::workerLoop, this, t);
+        }
+    }
+
+    ~Tournament() {
+        stopping = true;
+        startBarrier.arriveAndWait();
+        for (auto& w : workers) w.join();
+    }
+
+    Tournament(const Tournament&) = delete;
+    Tournament& operator=(const Tournament&) = delete;
+
+    bool finished() const { return cur.size() == 1; }
+    const Entrant& champion() const { return cur.front(); }
+    size_t liveEntrants() const { return cur.size(); }
+    size_t liveBytes() const { return (cur.capacity() + next.capacity()) * sizeof(Entrant); }
+
+    // 라운드 하나: 병렬 처리 → 배리어 → 통계 합산 → 이전 대진 해제
+    RoundStats playRound(vector<MatchRecord>* records = nullptr) {
+        if (finished()) throw logic_error("토너먼트가 이미 끝났습니다");
+        next.resize(cur.size() / 2);
+        for (auto& s : stats) s = RoundStats{};
+
+        if (next.size() < kInlineMatches || records) {
+            playRange(0, next.size(), stats[0], records);
+        } else {
+            startBarrier.arriveAndWait();
+            endBarrier.arriveAndWait();
+        }
+
+        RoundStats total;
+        for (const auto& s : stats) total.merge(s);
+        cur.swap(next);
+        vector<Entrant>().swap(next);   // 끝난 라운드의 배열은 바로 반납
+        ++round;
+        return total;
+    }
+
+private:
+    void workerLoop(size_t id) {
+        while (true) {
+            startBarrier.arriveAndWait();
+            if (stopping) return;
+            size_t n = next.size();
+            playRange(n * id / threadCount, n * (id + 1) / threadCount, stats[id], nullptr);
+            endBarrier.arriveAndWait();
+        }
+    }
+
+    void playRange(size_t begin, size_t end, RoundStats& out, vector<MatchRecord>* records) {
+        RoundStats local;
+        for (size_t m = begin; m < end; ++m) {
+            const Entrant& x = cur[2 * m];
+            const Entrant& y = cur[2 * m + 1];
+            MatchRng rng{mix64(seed ^ mix64((uint64_t(round) << 40) ^ m))};
+            DuelResult r = duel({x.maxHealth(), x.maxHealth(), x.attack(), x.defense(), x.potions},
+                                {y.maxHealth(), y.maxHealth(), y.attack(), y.defense(), y.potions}, rng);
+
+            const Entrant& loser = r.firstWon ? y : x;
+            Entrant w = r.firstWon ? x : y;
+            local.upsets += w.level < loser.level;
+            w.potions = uint8_t(w.potions - r.potionsUsed[r.firstWon ? 0 : 1]);   // 쓴 포션은 돌아오지 않음
+            w.wins++;
+            w.gainExperience(50 + 10u * loser.level);
+            next[m] = w;
+
+            local.matches++;
+            local.turns += uint64_t(r.turns);
+            local.potions += uint64_t(r.potionsUsed[0] + r.potionsUsed[1]);
+            local.timeouts += r.timedOut;
+            local.digest += mix64(w.id ^ (uint64_t(w.level) << 32) ^ (uint64_t(w.potions) << 48));
+            if (records) records->push_back({x, y, w, r.turns});
+        }
+        out = local;
+    }
+};
+
+struct TournamentResult {
+    Entrant champion;
+    uint64_t digest;
+    double seconds;
+};
+
+TournamentResult runTournament(int rounds, size_t threads, uint64_t seed, bool verbose) {
+    auto t0 = chrono::steady_clock::now();
+    Tournament t(rounds, seed, threads);
+    if (verbose) {
+        cout << "참가자 " << t.liveEntrants() << "명, 스레드 " << threads << "개, 초기 대진 "
+             << t.liveBytes() / 1024 << " KB (" << sizeof(Entrant) << "바이트/명)\n" << endl;
+        cout << " 라운드 |   경기 수 | 시간(ms) | 경기/초(M) | 평균 턴 | 이변 | 포션 | 200턴 | 남은 대진(KB)" << endl;
+    }
+
+    uint64_t digest = 0;
+    vector<MatchRecord> finals;
+    while (!t.finished()) {
+        bool lastThree = t.liveEntrants() <= 8;
+        auto r0 = chrono::steady_clock::now();
+        RoundStats s = t.playRound(lastThree ? &finals : nullptr);
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - r0).count();
+        digest = mix64(digest ^ s.digest);
+
+        if (verbose) {
+            cout << setw(7) << s.matches * 2 << "강 | " << setw(9) << s.matches << " | " << setw(8) << fixed << setprecision(2) << ms
+                 << " | " << setw(10) << setprecision(2) << s.matches / max(ms, 1e-6) / 1000.0
+                 << " | " << setw(7) << setprecision(1) << double(s.turns) / s.matches
+                 << " | " << setw(4) << s.upsets << " | " << setw(4) << s.potions << " | " << setw(5) << s.timeouts
+                 << " | " << setw(12) << t.liveBytes() / 1024.0 << endl;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    if (verbose) {
+        cout << "\n=== 8강 이후 대진 ===" << endl;
+        for (const auto& m : finals) {
+            cout << "용사" << m.first.id << "(Lv" << m.first.level << ") vs 용사" << m.second.id << "(Lv" << m.second.level
+                 << ") → 용사" << m.winner.id << " 승 (" << m.turns << "턴)" << endl;
+        }
+    }
+    return {t.champion(), digest, seconds};
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        int rounds = argc > 1 ? stoi(argv[1]) : 20;
+        size_t threads = argc > 2 ? stoul(argv[2]) : max(2u, thread::hardware_concurrency());
+        const uint64_t seed = 0x7E57;
+
+        cout << "=== 싱글 엘리미네이션 토너먼트 ===" << endl;
+        TournamentResult result = runTournament(rounds, threads, seed, true);
+        const Entrant& c = result.champion;
+        cout << "\n우승: 용사" << c.id << " — " << int(c.wins) << "연승, 레벨 " << c.level << " (체력 " << c.maxHealth()
+             << ", 공격력 " << c.attack() << ", 방어력 " << c.defense() << "), 남은 포션 " << int(c.potions) << endl;
+        cout << "전체 " << fixed << setprecision(3) << result.seconds << "초 (참가자 생성 포함)" << endl;
+
+        // 결정론 검증: 스레드 1개로 다시 돌려 대진 해시 비교
+        TournamentResult single = runTournament(rounds, 1, seed, false);
+        bool same = single.digest == result.digest && single.champion.id == c.id;
+        cout << "\n스레드 1개 재실행: " << single.seconds << "초, 대진 해시 " << (same ? "일치" : "불일치") << endl;
+        return same ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cout << "오류: " << e.what() << endl;
+        return 1;
+    }
+}